@@ -48,5 +48,12 @@
 /// For the pixel planes there is an additional decorator:
 ///   - invert
 ///
+/// For images there is an additional decorator:
+///   - scale (magnify by an integer factor)
+///
+/// The image decorators are folded into a single image_transform_t,
+/// so a pixel read costs one read of the source image, no matter
+/// how many decorators are applied.
+///
 
 
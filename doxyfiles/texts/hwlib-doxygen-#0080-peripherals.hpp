@@ -20,8 +20,10 @@
 /// - \ref hwlib::pcf8574 "pcf857" and \ref hwlib::pcf8574a "pcf8574a" i2c 8-pin I/O extenders
 /// - \ref hwlib::pcf8591 "pcf8591" i2c 8-bit ADC and DAC
 /// - \ref hwlib::hc595 "hc595" spi-like 8-bit output shift register
-/// - \ref hwlib::hd44780 "hd44780" character LCDs
+/// - \ref hwlib::hd44780 "hd44780" character LCDs,
+///   and \ref hwlib::hd44780_pcf8574 "hd44780_pcf8574" for one on an I2C backpack
 /// - \ref hwlib::glcd_5510 "glcd_5510" Nokia '5510' 84x48 B/W graphics LCD
+///   (bit-banged, or \ref hwlib::glcd_5510_spi_sce_res_dc "glcd_5510_spi_sce_res_dc" on a SPI bus)
 /// - \ref hwlib::glcd_oled "glcd_oled" SDD1306 128x64 OLED
 /// - \ref hwlib::matrix_of_switches "matrix_of_switches" and \ref hwlib::keypad "keypad" for reading a matrix of switches
 ///
\ No newline at end of file
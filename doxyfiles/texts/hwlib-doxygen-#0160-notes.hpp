@@ -92,7 +92,6 @@ Quality & consistency:
   - file-local objects are not documented? (check ostream)
   - db103 align pin classes
   - more examples (graphics, ...)
-  - lcd5510 should use SPI!
   - i2c example of address-only write
   - test for input, output, oc, analog pins of a chip
   - rewrite text for uno (due?) IO pins
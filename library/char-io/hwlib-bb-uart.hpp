@@ -1,6 +1,6 @@
 // ==========================================================================
 //
-// File      : hwlib-ostream.hpp
+// File      : hwlib-bb-uart.hpp
 // Part of   : C++ hwlib library for close-to-the-hardware OO programming
 // Copyright : wouter@voti.nl 2017-2019
 //
@@ -27,14 +27,234 @@ namespace hwlib {
 /// a bit-banged UART char output
 ///
 /// This function implements a bit-banged output UART pin
-/// using the BMPTK_BAUDRATE.   
+/// using the HWLIB_BAUDRATE, with 2 stop bits.
+/// The bit edges are timed like those of a bb_uart.
 void uart_putc_bit_banged_pin( char c, pin_out & pin );
    
 /// a bit-banged UART char input
 ///
 /// This function implements a bit-banged input UART pin
-/// using the BMPTK_BAUDRATE.      
+/// using the HWLIB_BAUDRATE.
+/// The bits are sampled like those of a bb_uart, 
+/// a character with a framing error is ignored.
 char uart_getc_bit_banged_pin( pin_in & pin );
+
+
+// ===========================================================================
+//
+// bb_uart
+//
+// ===========================================================================	
+
+/// bit-banged UART
+///
+/// A bb_uart is an ostream and an istream that sends 
+/// and receives characters (8 data bits, no parity) by 
+/// bit-banging a transmit pin and a receive pin.
+/// Its baudrate can be changed at run time.
+///
+/// The bit time is computed in 1/256 clock ticks, and each
+/// bit edge is scheduled at its own deadline (in now_ticks())
+/// relative to the start of the frame, so the time spent in 
+/// the pin calls and in the loop doesn't accumulate into drift.
+/// When characters are written back-to-back, each next frame is
+/// scheduled at the end of the previous one.
+///
+/// On receive, each bit is sampled three times around its centre
+/// (at 3/8, 4/8 and 5/8 of the bit time) and the majority is used.
+/// A start bit that isn't low at its centre is ignored as a glitch.
+/// A character that has no high stop bit is a framing error:
+/// it is dropped and counted, and the receiver waits for the 
+/// line to become idle (high) again.
+///
+/// Both directions use busy waiting, so the achievable baudrate
+/// depends on the target: 115200 baud works on the fast targets
+/// (like the Arduino Due), a slow target might need a lower baudrate.
+/// Interrupts that occur during a character will disturb its timing.
+class bb_uart : public ostream, public istream {
+private:
+
+   pin_out & tx;
+   pin_in & rx;
+   uint_fast32_t current_baudrate;
+   uint_fast64_t bit_q8;
+   uint_fast8_t stop_bits;
+   uint_fast64_t tx_idle;
+   uint_fast32_t framing;
+
+   friend void uart_putc_bit_banged_pin( char c, pin_out & pin );
+   friend char uart_getc_bit_banged_pin( pin_in & pin );
+
+   // the bit time in 1/256 ticks
+   static uint_fast64_t bit_time( uint_fast32_t baudrate ){
+      return ( ticks_per_us() * 1'000'000 * 256 ) / baudrate;
+   }
+
+   // the moment, in ticks, that is the given number of 
+   // 1/8 bits after the start of a frame
+   static uint_fast64_t moment( 
+      uint_fast64_t start, 
+      uint_fast64_t bit_q8, 
+      uint_fast16_t eighths 
+   ){
+      return start + ( ( eighths * bit_q8 ) >> 11 );
+   }
+
+   static void wait_until( uint_fast64_t t ){
+      while( now_ticks() < t ){}
+   }
+
+   // send the start bit, the data bits and the first stop bit, 
+   // and return the end moment of the stop bits
+   static uint_fast64_t put_frame( 
+      pin_out & pin, 
+      char c, 
+      uint_fast64_t start, 
+      uint_fast64_t bit_q8, 
+      uint_fast8_t stop_bits 
+   ){
+      const uint_fast16_t frame = 
+         ( static_cast< uint_fast16_t >( static_cast< uint8_t >( c ) ) << 1 )
+         | 0x200;
+      for( uint_fast16_t n = 0; n < 10; ++n ){
+         const bool level = ( ( frame >> n ) & 0x01 ) != 0;
+         wait_until( moment( start, bit_q8, 8 * n ) );
+         pin.write( level );
+         pin.flush();
+      }
+      return moment( start, bit_q8, 8 * ( 9 + stop_bits ) );
+   }
+
+   // the majority of three samples around the centre of bit n
+   static bool sample( 
+      pin_in & pin, 
+      uint_fast64_t start, 
+      uint_fast64_t bit_q8, 
+      uint_fast16_t n 
+   ){
+      uint_fast8_t ones = 0;
+      for( uint_fast16_t k = 3; k <= 5; ++k ){
+         wait_until( moment( start, bit_q8, 8 * n + k ) );
+         pin.refresh();
+         ones += pin.read();
+      }
+      return ones >= 2;
+   }
+
+   // receive a frame, return false when its stop bit is low
+   static bool get_frame( pin_in & pin, char & c, uint_fast64_t bit_q8 ){
+      for(;;){
+
+         // wait for the falling edge of a start bit
+         do {
+            pin.refresh();
+         } while( pin.read() );
+         const auto start = now_ticks();
+
+         // a start bit must still be low at its centre
+         if( sample( pin, start, bit_q8, 0 ) ){
+            continue;
+         }
+
+         // 8 data bits, lsb first
+         uint_fast8_t data = 0;
+         for( uint_fast16_t n = 1; n <= 8; ++n ){
+            data = data >> 1;
+            if( sample( pin, start, bit_q8, n ) ){
+               data = data | 0x80;
+            }
+         }
+         c = static_cast< char >( data );
+
+         return sample( pin, start, bit_q8, 9 );
+      }
+   }
+
+public:
+
+   /// create a bit-banged UART from a transmit pin and a receive pin
+   ///
+   /// The transmit pin is made high (idle), 
+   /// the first character is sent one bit time later.
+   bb_uart( 
+      pin_out & tx, 
+      pin_in & rx, 
+      uint_fast32_t baudrate = HWLIB_BAUDRATE,
+      uint_fast8_t stop_bits = 1
+   ):
+      tx( tx ), 
+      rx( rx ),
+      current_baudrate( baudrate ),
+      bit_q8( bit_time( baudrate ) ),
+      stop_bits( stop_bits ),
+      tx_idle( 0 ),
+      framing( 0 )
+   {
+      tx.write( 1 );
+      tx.flush();
+      tx_idle = moment( now_ticks(), bit_q8, 8 );
+   }
+
+   /// change the baudrate
+   ///
+   /// A character that is being sent is finished first.
+   void set_baudrate( uint_fast32_t baudrate ){
+      flush();
+      current_baudrate = baudrate;
+      bit_q8 = bit_time( baudrate );
+   }
+
+   /// the current baudrate
+   uint_fast32_t baudrate() const {
+      return current_baudrate;
+   }
+
+   /// send a character
+   ///
+   /// This function returns at the start of the (last) stop bit,
+   /// the next character (or a flush()) waits until its end. 
+   void putc( char c ) override {
+      const auto now = now_ticks();
+      tx_idle = put_frame( 
+         tx, c, ( tx_idle > now ) ? tx_idle : now, bit_q8, stop_bits );
+   }
+
+   /// wait until the last stop bit has been sent
+   void flush() override {
+      wait_until( tx_idle );
+   }
+
+   /// whether a character is being received
+   ///
+   /// This is the case when the receive line is low (a start bit).
+   bool char_available() override {
+      rx.refresh();
+      return ! rx.read();
+   }
+
+   /// receive a character
+   ///
+   /// This function waits for a character that is received
+   /// without a framing error.
+   /// It returns halfway its stop bit, so the start bit of a 
+   /// next character will not be missed. 
+   char getc() override {
+      char c;
+      while( ! get_frame( rx, c, bit_q8 ) ){
+         framing++;
+         do {
+            rx.refresh();
+         } while( ! rx.read() );
+      }
+      return c;
+   }
+
+   /// the number of characters dropped because of a framing error
+   uint_fast32_t framing_errors() const {
+      return framing;
+   }
+
+}; // class bb_uart
    
    
 // ===========================================================================
@@ -47,54 +267,25 @@ char uart_getc_bit_banged_pin( pin_in & pin );
 
 void uart_putc_bit_banged_pin( char c, pin_out & pin ){
 
-   const auto bit_cel = ( ( 1000L * 1000L ) / HWLIB_BAUDRATE );
-  
-   pin.write( 1 );
    // use busy waiting, otherwise logging from within the RTOS
    // will cause serious problems
-   wait_us_busy( bit_cel );
-   
-   // start bit
-   pin.write( 0 );
-   wait_us_busy( bit_cel );
-   
-   // 8 data bits
-   for( uint_fast8_t i = 0; i < 8; ++i ){
-      pin.write( ( c & 0x01 ) != 0x00 );
-      c = c >> 1;
-      wait_us_busy( bit_cel );
-   }   
-   
-   // 2 stop bits
+   const auto bit_q8 = bb_uart::bit_time( HWLIB_BAUDRATE );
+
+   // one bit of idle line, the frame, and 2 stop bits
    pin.write( 1 );
-   wait_us_busy( 2 * bit_cel ); 
+   pin.flush();
+   const auto start = bb_uart::moment( now_ticks(), bit_q8, 8 );
+   bb_uart::wait_until( bb_uart::put_frame( pin, c, start, bit_q8, 2 ) );
 }       
    
 char uart_getc_bit_banged_pin( pin_in & pin ){
-	
-   char c = 0;        
-   
-   const auto bit_cel = ( ( 1000L * 1000L ) / HWLIB_BAUDRATE );
-     
-   // wait for start of startbit
-   while( pin.read() ){ wait_ns( 1 ); }
-      
-   // wait until halfway the first data bit
-   auto t = now_us();
-   t += bit_cel + ( bit_cel / 2 );
-   while( now_us() < t ){};
-      
-   // 8 data bits
-   for( uint_fast8_t i = 0; i < 8; ++i ){
-      c = c >> 1;            
-      if( pin.read() ){
-         c = c | 0x80;                
-      }
-         
-      t+= bit_cel;
-      while( now_us() < t ){};
-   }   
-   
+   const auto bit_q8 = bb_uart::bit_time( HWLIB_BAUDRATE );
+   char c;
+   while( ! bb_uart::get_frame( pin, c, bit_q8 ) ){
+      do {
+         pin.refresh();
+      } while( ! pin.read() );
+   }
    return c;
 }     
 
@@ -33,6 +33,18 @@ namespace hwlib {
 /// This definition is weak, which allows 
 /// an application to provide its own definition.
 void uart_putc( char c );
+
+/// console block output function
+///
+/// This is the function used for console (ostream) output
+/// of a block of characters.
+/// The default implementation calls uart_putc() for each character.
+/// A target that can write a block faster provides its own
+/// implementation (and defines _HWLIB_TARGET_UART_WRITE).
+///
+/// This definition is weak, which allows 
+/// an application to provide its own definition.
+void uart_write( const char * s, size_t n );
    
 /// console character input function
 ///
@@ -71,6 +83,10 @@ public:
       uart_putc( c );
    }
    
+   void write( const char * s, size_t n ) override {
+      uart_write( s, n );
+   }
+   
    void flush() override {}
 
 };
@@ -123,6 +139,14 @@ extern cin_using_uart_getc cin;
 cout_using_uart_putc HWLIB_WEAK cout;   
 cin_using_uart_getc HWLIB_WEAK  cin; 
 
+#ifndef _HWLIB_TARGET_UART_WRITE
+void HWLIB_WEAK uart_write( const char * s, size_t n ){
+   for( size_t i = 0; i < n; ++i ){
+      uart_putc( s[ i ] );
+   }
+}
+#endif
+
 #endif // _HWLIB_ONCE
 
 }; // namespace hwlib
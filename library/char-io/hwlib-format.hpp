@@ -0,0 +1,659 @@
+// ==========================================================================
+//
+// File      : hwlib-format.hpp
+// Part of   : C++ hwlib library for close-to-the-hardware OO programming
+// Copyright : wouter@voti.nl 2017-2019
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// included only via hwlib.hpp, hence no multiple-include guard is needed
+
+// this file contains Doxygen lines
+/// @file
+
+namespace hwlib {
+
+/// \cond INTERNAL
+
+
+// ==========================================================================
+//
+// format string parsing (at compile time)
+//
+// ==========================================================================
+
+// the next part of a format string:
+// the literal text up to the next field, and that field
+struct format_field {
+
+   enum kinds { end, literal, field, error };
+
+   // end     : the literal text is the rest of the format string
+   // literal : the literal text ends with a '{' or '}' from a "{{" or "}}"
+   // field   : the literal text is followed by a field
+   // error   : the format string is invalid
+   kinds kind;
+
+   size_t literal_start;
+   size_t literal_length;
+
+   // the position after the literal text and the field
+   size_t next;
+
+   // the field: {:[[fill]align][+][#][0][width][.precision][type]}
+   char fill;
+   char align;
+   bool show_pos;
+   bool show_base;
+   bool zero_pad;
+   uint_fast16_t width;
+   uint_fast8_t precision;
+   char type;
+
+   // whether the field has more than {}
+   bool has_spec;
+
+   // the format_spec for an item:
+   // numbers are aligned right by default, other items left
+   constexpr format_spec spec( bool is_number ) const {
+      return {
+         static_cast< uint16_t >( width ),
+         static_cast< uint8_t >(
+            ( type == 'x' || type == 'X' ) ? 16
+               : ( type == 'o' ) ? 8
+               : ( type == 'b' ) ? 2
+               : 10 ),
+         static_cast< uint8_t >( precision ),
+         fill,
+         ( type == 'x' ) ? 'a' : 'A',
+         ( align == '>' ) || ( ( align == '\0' ) && is_number ),
+         align == '^',
+         show_pos,
+         show_base,
+         zero_pad && ( align == '\0' ),
+         type == 'X'
+      };
+   }
+
+   // whether the type is one of the characters in s
+   constexpr bool type_is( const char * s ) const {
+      for( ; *s != '\0'; ++s ){
+         if( type == *s ){
+            return true;
+         }
+      }
+      return false;
+   }
+};
+
+constexpr bool format_is_align( char c ){
+   return ( c == '<' ) || ( c == '>' ) || ( c == '^' );
+}
+
+constexpr format_field format_parse( const char * s, size_t position ){
+   format_field f{
+      format_field::end, position, 0, 0,
+      ' ', '\0', false, false, false, 0, 6, '\0', false };
+
+   size_t i = position;
+   while( ( s[ i ] != '\0' ) && ( s[ i ] != '{' ) && ( s[ i ] != '}' ) ){
+      ++i;
+   }
+   f.literal_length = i - position;
+
+   if( s[ i ] == '\0' ){
+      f.next = i;
+      return f;
+   }
+
+   // "{{" and "}}" are a literal "{" and "}"
+   if( s[ i + 1 ] == s[ i ] ){
+      f.kind = format_field::literal;
+      ++f.literal_length;
+      f.next = i + 2;
+      return f;
+   }
+
+   f.kind = format_field::error;
+   if( s[ i ] == '}' ){
+      return f;
+   }
+   ++i;
+   if( s[ i ] == ':' ){
+      ++i;
+      if( ( s[ i ] != '\0' ) && format_is_align( s[ i + 1 ] ) ){
+         f.fill = s[ i ];
+         f.align = s[ i + 1 ];
+         i += 2;
+      } else if( format_is_align( s[ i ] ) ){
+         f.align = s[ i ];
+         ++i;
+      }
+      if( s[ i ] == '+' ){
+         f.show_pos = true;
+         ++i;
+      } else if( s[ i ] == '-' ){
+         ++i;
+      }
+      if( s[ i ] == '#' ){
+         f.show_base = true;
+         ++i;
+      }
+      if( s[ i ] == '0' ){
+         f.zero_pad = true;
+         ++i;
+      }
+      while( ( s[ i ] >= '0' ) && ( s[ i ] <= '9' ) ){
+         f.width = 10 * f.width + ( s[ i ] - '0' );
+         ++i;
+      }
+      if( s[ i ] == '.' ){
+         ++i;
+         if( ( s[ i ] < '0' ) || ( s[ i ] > '9' ) ){
+            return f;
+         }
+         f.precision = 0;
+         while( ( s[ i ] >= '0' ) && ( s[ i ] <= '9' ) ){
+            f.precision = 10 * f.precision + ( s[ i ] - '0' );
+            ++i;
+         }
+      }
+      for( const char * p = "dxXobcsf"; *p != '\0'; ++p ){
+         if( s[ i ] == *p ){
+            f.type = s[ i ];
+            ++i;
+            break;
+         }
+      }
+      f.has_spec = true;
+   }
+   if( s[ i ] != '}' ){
+      return f;
+   }
+   f.kind = format_field::field;
+   f.next = i + 1;
+   return f;
+}
+
+
+// ==========================================================================
+//
+// writing the items
+//
+// ==========================================================================
+
+template< typename T >
+struct format_is_fixed_point : std::false_type {};
+
+template< unsigned int fraction_bits, typename T >
+struct format_is_fixed_point< fixed_point< fraction_bits, T > > 
+   : std::true_type {};
+
+template< typename T >
+struct format_is_fixed_decimal : std::false_type {};
+
+template< typename T >
+struct format_is_fixed_decimal< fixed_decimal< T > > : std::true_type {};
+
+// a field, and the literal text before it
+struct format_item {
+   const char * literal;
+   format_spec spec;
+   uint16_t literal_length;
+};
+
+// the writers of the fields:
+// the same writer is used for all fields of the same type,
+// so they are not inlined
+class format_item_writer {
+private:
+
+   static void literal( ostream & out, const format_item & f ){
+      if( f.literal_length > 0 ){
+         out.write( f.literal, f.literal_length );
+      }
+   }
+
+public:
+
+   HWLIB_NOINLINE static void text(
+      ostream & out, const char * s, size_t n, const format_item & f
+   ){
+      literal( out, f );
+      out.write_field( s, n, f.spec );
+   }
+
+   HWLIB_NOINLINE static void string(
+      ostream & out, const char * s, const format_item & f
+   ){
+      text( out, s, ostream::strlen( s ), f );
+   }
+
+   HWLIB_NOINLINE static void character(
+      ostream & out, char c, const format_item & f
+   ){
+      text( out, & c, 1, f );
+   }
+
+   HWLIB_NOINLINE static void boolean(
+      ostream & out, bool b, const format_item & f
+   ){
+      if( b ){
+         text( out, "true", 4, f );
+      } else {
+         text( out, "false", 5, f );
+      }
+   }
+
+   template< typename T >
+   HWLIB_NOINLINE static void integer(
+      ostream & out, T x, const format_item & f
+   ){
+      literal( out, f );
+      if constexpr( std::is_signed< T >::value ){
+         out.print_integer( ostream::magnitude( x ), x < 0, f.spec );
+      } else {
+         out.print_integer( x, false, f.spec );
+      }
+   }
+
+   template< typename T >
+   HWLIB_NOINLINE static void floating(
+      ostream & out, T x, const format_item & f
+   ){
+      literal( out, f );
+      out.print_floating( x, f.spec );
+   }
+
+   template< typename T >
+   HWLIB_NOINLINE static void fixed_point(
+      ostream & out, const T & x, const format_item & f
+   ){
+      literal( out, f );
+      out.print_fixed_point( x, f.spec );
+   }
+
+   template< typename T >
+   HWLIB_NOINLINE static void fixed_decimal(
+      ostream & out, const T & x, const format_item & f
+   ){
+      literal( out, f );
+      out.print_fixed_decimal( x, f.spec );
+   }
+
+   template< typename T >
+   static void other( ostream & out, const T & x, const format_item & f ){
+      literal( out, f );
+      out << x;
+   }
+
+}; // class format_item_writer
+
+template< typename S >
+class format_writer {
+private:
+
+   // the field at a position of the format string
+   template< size_t position >
+   static constexpr format_field field(){
+      return format_parse( S::str(), position );
+   }
+
+   // check at compile time that the field can format an item of type T
+   template< size_t position, typename T >
+   static constexpr void check_item(){
+      constexpr auto f = field< position >();
+      constexpr bool is_text =
+         ( std::is_same< T, bool >::value || std::is_same< T, char >::value )
+         && ! f.type_is( "dxXob" );
+
+      if constexpr( std::is_same< T, bool >::value && is_text ){
+         static_assert( f.type_is( "s" ) || ( f.type == '\0' ),
+            "hwlib::format: invalid type for a bool" );
+
+      } else if constexpr( std::is_same< T, char >::value && is_text ){
+         static_assert( f.type_is( "c" ) || ( f.type == '\0' ),
+            "hwlib::format: invalid type for a char" );
+
+      } else if constexpr( 
+         std::is_floating_point< T >::value
+         || format_is_fixed_point< T >::value 
+         || format_is_fixed_decimal< T >::value 
+      ){
+         static_assert( f.type_is( "f" ) || ( f.type == '\0' ),
+            "hwlib::format: invalid type for a floating-point "
+            "or fixed-point value" );
+
+      } else if constexpr( std::is_integral< T >::value ){
+         static_assert( f.type_is( "dxXob" ) || ( f.type == '\0' ),
+            "hwlib::format: invalid type for an integer" );
+
+      } else if constexpr( 
+         std::is_convertible< T, const char * >::value
+         || std::is_base_of< string_base, T >::value
+      ){
+         static_assert( f.type_is( "s" ) || ( f.type == '\0' ),
+            "hwlib::format: invalid type for a string" );
+
+      } else {
+         static_assert( ! f.has_spec,
+            "hwlib::format: only numbers, chars, bools and strings "
+            "can have a format specification" );
+      }
+   }
+
+   // check the item for the field at position, and the rest
+   template< size_t position, typename T, typename... Ts >
+   static constexpr void check_first(){
+      check_item< position, T >();
+      check< field< position >().next, Ts... >();
+   }
+
+   template< size_t position, typename T >
+   static void item( ostream & out, const T & x ){
+      constexpr auto f = field< position >();
+      using W = format_item_writer;
+      check_item< position, T >();
+
+      // a bool or char is a number when a number type is specified
+      constexpr bool is_text =
+         ( std::is_same< T, bool >::value || std::is_same< T, char >::value )
+         && ! f.type_is( "dxXob" );
+      constexpr bool is_number = ( ! is_text ) && (
+         std::is_arithmetic< T >::value
+         || format_is_fixed_point< T >::value
+         || format_is_fixed_decimal< T >::value );
+
+      static_assert( f.literal_length <= 0xFFFF,
+         "hwlib::format: literal text too long" );
+
+      // the literal text and the spec are passed by reference, 
+      // from a constant, which is smaller than passing them 
+      // as separate arguments
+      static constexpr format_item spec = {
+         S::str() + f.literal_start,
+         f.spec( is_number ),
+         static_cast< uint16_t >( f.literal_length ) };
+
+      if constexpr( std::is_same< T, bool >::value && is_text ){
+         W::boolean( out, x, spec );
+
+      } else if constexpr( std::is_same< T, char >::value && is_text ){
+         W::character( out, x, spec );
+
+      } else if constexpr( std::is_floating_point< T >::value ){
+            
+         // a long double is printed as a double
+         using P = typename std::conditional< 
+            std::is_same< T, float >::value, float, double >::type;
+         W::floating( out, static_cast< P >( x ), spec );
+
+      } else if constexpr( format_is_fixed_point< T >::value ){
+         W::fixed_point( out, x, spec );
+
+      } else if constexpr( format_is_fixed_decimal< T >::value ){
+         W::fixed_decimal( out, x, spec );
+
+      } else if constexpr( std::is_integral< T >::value ){
+
+         // types smaller than int are promoted,
+         // so they share the int implementation
+         using P = decltype( +x );
+         W::integer< P >( out, x, spec );
+
+      } else if constexpr( std::is_convertible< T, const char * >::value ){
+         W::string( out, x, spec );
+
+      } else if constexpr( std::is_base_of< string_base, T >::value ){
+         W::text( out, x.begin(), x.length(), spec );
+
+      } else {
+         W::other( out, x, spec );
+      }
+   }
+
+public:
+
+   template< size_t position >
+   static void write( ostream & out ){
+      constexpr auto f = field< position >();
+      static_assert( f.kind != format_field::error,
+         "hwlib::format: invalid format string" );
+      static_assert( f.kind != format_field::field,
+         "hwlib::format: more fields than arguments" );
+      if constexpr( f.literal_length > 0 ){
+         out.write( S::str() + f.literal_start, f.literal_length );
+      }
+      if constexpr( f.kind == format_field::literal ){
+         write< f.next >( out );
+      }
+   }
+
+   template< size_t position, typename T, typename... Ts >
+   static void write( ostream & out, const T & x, const Ts & ... xs ){
+      constexpr auto f = field< position >();
+      static_assert( f.kind != format_field::error,
+         "hwlib::format: invalid format string" );
+      static_assert( f.kind != format_field::end,
+         "hwlib::format: more arguments than fields" );
+      if constexpr( f.kind == format_field::literal ){
+         out.write( S::str() + f.literal_start, f.literal_length );
+         write< f.next >( out, x, xs... );
+      } else if constexpr( f.kind == format_field::field ){
+      
+         // the item writes the literal text before it
+         item< position >( out, x );
+         write< f.next >( out, xs... );
+      }
+   }
+
+   // check at compile time that the format string is valid,
+   // and that its fields match the items of types Ts,
+   // like write() does
+   template< size_t position, typename... Ts >
+   static constexpr void check(){
+      constexpr auto f = field< position >();
+      static_assert( f.kind != format_field::error,
+         "hwlib::format: invalid format string" );
+      if constexpr( sizeof...( Ts ) == 0 ){
+         static_assert( f.kind != format_field::field,
+            "hwlib::format: more fields than arguments" );
+         if constexpr( f.kind == format_field::literal ){
+            check< f.next >();
+         }
+      } else {
+         static_assert( f.kind != format_field::end,
+            "hwlib::format: more arguments than fields" );
+         if constexpr( f.kind == format_field::literal ){
+            check< f.next, Ts... >();
+         } else if constexpr( f.kind == format_field::field ){
+            check_first< position, Ts... >();
+         }
+      }
+   }
+
+}; // class format_writer
+
+// the type in which formatted stores an item:
+// numbers, chars, bools and pointers (including a string literal) 
+// by value, other items by reference
+template< typename T >
+using format_stored = typename std::conditional<
+   std::is_array< T >::value,
+   const typename std::remove_extent< T >::type *,
+   typename std::conditional<
+      std::is_scalar< T >::value
+         || format_is_fixed_point< T >::value
+         || format_is_fixed_decimal< T >::value,
+      T,
+      const T &
+   >::type
+>::type;
+
+// the items of a formatted
+template< typename... Ts >
+struct format_items {
+   format_items(){}
+
+   template< typename F, typename... Vs >
+   void apply( F f, const Vs & ... vs ) const {
+      f( vs... );
+   }
+};
+
+template< typename T, typename... Ts >
+struct format_items< T, Ts... > {
+   T first;
+   format_items< Ts... > rest;
+
+   template< typename U, typename... Us >
+   format_items( const U & x, const Us & ... xs ):
+      first( x ), rest( xs... )
+   {}
+
+   // call f with the items
+   template< typename F, typename... Vs >
+   void apply( F f, const Vs & ... vs ) const {
+      rest.apply( f, vs..., first );
+   }
+};
+
+// an ostream that appends to a string
+class format_string_ostream : public ostream {
+private:
+
+   string_base & s;
+
+public:
+
+   format_string_ostream( string_base & s ): s( s ){}
+
+   void putc( char c ) override {
+      s.append( c );
+   }
+
+   void write( const char * p, size_t n ) override {
+      for( size_t i = 0; i < n; ++i ){
+         s.append( p[ i ] );
+      }
+   }
+
+   void flush() override {}
+
+}; // class format_string_ostream
+
+/// \endcond
+
+
+// ==========================================================================
+//
+// format()
+//
+// ==========================================================================
+
+/// format string for hwlib::format()
+///
+/// This macro turns a string literal into a format string for
+/// hwlib::format(), which is parsed and checked at compile time.
+#define HWLIB_FORMAT( S )                                      \
+   []{                                                         \
+      struct hwlib_format_string {                             \
+         static constexpr const char * str(){ return S; }      \
+      };                                                       \
+      return hwlib_format_string();                            \
+   }()
+
+/// formatted items, as returned by hwlib::format()
+///
+/// This object can be written to an ostream or appended to a string.
+/// It stores numbers, chars, bools and pointers (including string
+/// literals) by value, so it can be stored and used later.
+/// Other items, like strings and objects that are written with their 
+/// operator<<, are stored by reference: those must outlive it.
+template< typename S, typename... Ts >
+class formatted {
+private:
+
+   format_items< Ts... > items;
+   
+   void write( ostream & out ) const {
+      items.apply( [ & ]( const auto & ... xs ){
+         format_writer< S >::template write< 0 >( out, xs... );
+      } );
+   }
+
+public:
+
+   /// \cond INTERNAL
+   template< typename... Us >
+   formatted( const Us & ... xs ): items( xs... ){}
+   /// \endcond
+
+   /// write the formatted items to an ostream
+   friend ostream & operator<<( ostream & out, const formatted & x ){
+      x.write( out );
+      return out;
+   }
+
+   /// append the formatted items to a string
+   friend string_base & operator<<( string_base & s, const formatted & x ){
+      format_string_ostream out( s );
+      x.write( out );
+      return s;
+   }
+
+}; // class formatted
+
+/// format items according to a format string
+///
+/// This function formats its items according to a format string,
+/// which must be created by the HWLIB_FORMAT macro.
+/// The result can be written to an ostream, or appended to a string:
+/// @code
+///    hwlib::cout
+///       << hwlib::format( HWLIB_FORMAT( "{:04x} {:>8}\n" ), a, b );
+/// @endcode
+///
+/// The format string is parsed at compile time:
+/// there is no parsing at run time, and an invalid format string,
+/// or a mismatch between the fields and the items, is a compile error.
+/// The state (width, radix, fill etc.) of the ostream is not used
+/// and not changed.
+///
+/// The format string is a subset of the C++20 std::format syntax.
+/// The text outside the fields is written unchanged,
+/// except that "{{" and "}}" are written as "{" and "}".
+/// A field {} formats the next item.
+/// A field can specify the format: 
+/// {:[[fill]align][+][#][0][width][.precision][type]}
+///    - fill : the fill character (default ' ')
+///    - align : '<' left, '>' right, or '^' center;
+///      the default is right for numbers, and left for other items
+///    - '+' : show a '+' for a positive number
+///    - '#' : show the radix prefix (0b, 0o or 0x) of a number
+///    - '0' : pad a number with '0' after its sign and prefix
+///      (when no alignment is specified)
+///    - width : the minimum width
+///    - precision : the number of decimals of a floating-point
+///      or fixed_point value (default 6)
+///    - type : 'd' decimal, 'x' hexadecimal (lower case),
+///      'X' hexadecimal (upper case, with a 0X prefix), 
+///      'o' octal, 'b' binary,
+///      'c' character, 's' string, or 'f' fixed notation
+///
+/// A format can be specified for integers, floating-point and 
+/// fixed-point values, chars, bools
+/// (printed as true or false, or as a number when a number
+/// type is specified), char pointers and strings.
+/// Other items are written with their operator<<,
+/// their field must be {}.
+template< typename S, typename... Ts >
+auto format( S, const Ts & ... xs ){
+   return formatted< S, format_stored< Ts >... >( xs... );
+}
+
+}; // namespace hwlib
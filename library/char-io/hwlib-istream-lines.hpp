@@ -0,0 +1,177 @@
+// ==========================================================================
+//
+// File      : hwlib-istream-lines.hpp
+// Part of   : C++ hwlib library for close-to-the-hardware OO programming
+// Copyright : wouter@voti.nl 2017-2019
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// included only via hwlib.hpp, hence no multiple-include guard is needed
+
+// this file contains Doxygen lines
+/// @file
+
+namespace hwlib {
+
+
+// ==========================================================================
+//
+// getline
+//
+// ==========================================================================
+
+/// read a line into a string
+///
+/// This function reads characters up to and including the delimiter,
+/// and stores the characters before the delimiter in the string.
+/// When no character is available it waits for one.
+///
+/// The characters that don't fit in the string are read, but ignored:
+/// the next read starts at the next line.
+/// In that case the stream fails.
+inline istream & getline(
+   istream & stream,
+   string_base & s,
+   char delimiter = '\n'
+){
+   s.clear();
+   for(;;){
+      const char c = stream.get();
+      if( c == delimiter ){
+         return stream;
+      }
+      if( s.length() == s.max_size() ){
+         stream.fail( true );
+      } else {
+         s.append( c );
+      }
+   }
+}
+
+
+// ==========================================================================
+//
+// line_reader_base
+//
+// ==========================================================================
+
+/// non-blocking line reader
+///
+/// A line_reader collects the characters of a line, 
+/// as far as they are available, without waiting for characters.
+/// Call poll() repeatedly, for instance from the main loop: 
+/// when it returns true a complete line is available as line(). 
+/// That line remains available until the next poll() call.
+///
+///    for(;;){
+///       if( reader.poll() ){
+///          handle( reader.line() );
+///       }
+///       // do other things
+///    }
+///
+/// The characters of a line that don't fit in the buffer are ignored,
+/// which is reported by overflow().
+///
+/// Use line_reader< N > to declare one,
+/// and line_reader_base for references.
+class line_reader_base {
+private:
+
+   istream & stream;
+   string_base & buffer;
+   const char delimiter;
+   bool complete;
+   bool overflowed;
+   
+   // only line_reader< N > is allowed to construct
+   // a line_reader_base
+   template< size_t > friend class line_reader;
+
+   line_reader_base( 
+      istream & stream, 
+      string_base & buffer, 
+      char delimiter 
+   ):
+      stream( stream ),
+      buffer( buffer ),
+      delimiter( delimiter ),
+      complete( false ),
+      overflowed( false )
+   {}
+
+public:
+
+   /// read the available characters, return whether a line is complete
+   ///
+   /// This function reads characters until the delimiter is read,
+   /// or no more characters are available.
+   /// It returns true when the delimiter was read.
+   bool poll(){
+      if( complete ){
+         buffer.clear();
+         complete = false;
+         overflowed = false;
+      }
+      while( stream.available() ){
+         const char c = stream.get();
+         if( c == delimiter ){
+            complete = true;
+            return true;
+         }
+         if( buffer.length() == buffer.max_size() ){
+            overflowed = true;
+         } else {
+            buffer.append( c );
+         }
+      }
+      return false;
+   }
+   
+   /// the line that is (or is being) collected
+   ///
+   /// The delimiter is not part of the line.
+   const string_base & line() const {
+      return buffer;
+   }
+   
+   /// reports whether characters of the line were ignored
+   bool overflow() const {
+      return overflowed;
+   }
+   
+}; // class line_reader_base
+
+
+// ==========================================================================
+//
+// line_reader< N >
+//
+// ==========================================================================
+
+/// concrete non-blocking line reader
+///
+/// This is the concrete line reader class template.
+/// Use it to declare a line_reader that stores
+/// (up to) N characters of a line.
+/// Use line_reader_base for references and parameters.
+template< size_t maximum_length >
+class line_reader : public line_reader_base {
+private:
+
+   string< maximum_length > content;
+
+public:
+
+   /// create a line reader that reads from an istream
+   line_reader( istream & stream, char delimiter = '\n' ):
+      line_reader_base( stream, content, delimiter )
+   {}
+
+}; // class line_reader
+
+}; // namespace hwlib
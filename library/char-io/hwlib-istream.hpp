@@ -20,12 +20,127 @@ namespace hwlib {
 /// character input interface
 ///
 /// This class is a minimal std::istream work-alike for small embedded systems.
-/// (as yet, only reading a single character is supported)
+/// Single characters, and signed and unsigned integers 
+/// (in the radix set by the bin, oct, dec and hex manipulators) can be read.
 /// 
+/// An integer is read in a single pass: the character that ends it
+/// (the first character that is not a digit) is kept, 
+/// and is returned by the next get() or operator>>.
+/// Use get() and peek() rather than getc() when reading from a stream
+/// that is also read by operator>>.
+///
 /// This class is abstract: a concrete subclass must implement getc().  
-class istream : public noncopyable {     
+class istream : public noncopyable {  
+private:
+
+   uint_fast16_t numerical_radix;
+   char lookahead;
+   bool has_lookahead;
+   bool failed;
+
+   static bool is_space( char c ){
+      return ( c == ' ' ) || ( c == '\t' ) || ( c == '\r' ) || ( c == '\n' );
+   }
+   
+   // the value of a digit, or 255 when it is not a digit
+   static uint_fast8_t digit_value( char c ){
+      if( ( c >= '0' ) && ( c <= '9' ) ){
+         return c - '0';
+      } else if( ( c >= 'a' ) && ( c <= 'z' ) ){
+         return c - 'a' + 10;
+      } else if( ( c >= 'A' ) && ( c <= 'Z' ) ){
+         return c - 'A' + 10;
+      }
+      return 255;
+   }
+   
+   void skip_space(){
+      while( is_space( peek() ) ){
+         get();
+      }
+   }
+   
+   // read the digits of a value, which must not exceed limit:
+   // the value is set to limit when it does, and to 0 when there 
+   // are no digits, and in both cases the stream fails
+   template< typename U >
+   U read_magnitude( U limit ){
+      const char prefix = 
+           ( numerical_radix == 16 ) ? 'x' 
+         : ( numerical_radix == 8 ) ? 'o' 
+         : ( numerical_radix == 2 ) ? 'b' 
+         : '\0';
+      const U radix = numerical_radix;
+      U x = 0;
+      uint_fast8_t digits = 0;
+      bool overflow = false;
+      for(;;){
+         const char c = peek();
+         
+         // a 0x, 0o or 0b prefix that matches the radix is skipped
+         if( 
+            ( digits == 1 ) && ( x == 0 ) && ( prefix != '\0' )
+            && ( ( c == prefix ) || ( c == prefix - 'a' + 'A' ) )
+         ){
+            get();
+            digits = 0;
+            continue;
+         }
+         const U d = digit_value( c );
+         if( d >= radix ){
+            break;
+         }
+         get();
+         if( x > ( limit - d ) / radix ){
+            overflow = true;
+         } else {
+            x = x * radix + d;
+         }
+         if( digits < 255 ){
+            ++digits;
+         }
+      }
+      if( overflow ){
+         failed = true;
+         return limit;
+      }
+      if( digits == 0 ){
+         failed = true;
+      }
+      return x;
+   }
+   
+   template< typename T >
+   void read_signed( T & x ){
+      using U = typename std::make_unsigned< T >::type;
+      skip_space();
+      const bool minus = ( peek() == '-' );
+      if( minus || ( peek() == '+' ) ){
+         get();
+      }
+      const U max = static_cast< U >( -1 ) >> 1;
+      const U m = read_magnitude< U >( minus ? max + 1 : max );
+      x = minus ? static_cast< T >( 0u - m ) : static_cast< T >( m );
+   }
+   
+   template< typename T >
+   void read_unsigned( T & x ){
+      skip_space();
+      if( peek() == '+' ){
+         get();
+      }
+      x = read_magnitude< T >( static_cast< T >( -1 ) );
+   }
+
 public:        
 
+   constexpr istream():
+      numerical_radix( 10 ),
+      lookahead( '\0' ),
+      has_lookahead( false ),
+      failed( false )
+   {}
+
    /// reports whether a character is available
    virtual bool char_available(){ return true; }
    
@@ -47,25 +162,155 @@ public:
          return '\0';
       }			
    }
+   
+   /// read and return a single character
+   ///
+   /// This function returns the character that ended the last integer
+   /// that was read, if there is one, otherwise it reads a character.
+   char get(){
+      if( has_lookahead ){
+         has_lookahead = false;
+         return lookahead;
+      }
+      return getc();
+   }
+   
+   /// return the next character, without reading it
+   ///
+   /// The character will be returned by the next get().
+   char peek(){
+      if( ! has_lookahead ){
+         lookahead = getc();
+         has_lookahead = true;
+      }
+      return lookahead;
+   }
+   
+   /// reports whether get() will return without waiting
+   bool available(){
+      return has_lookahead || char_available();
+   }
+   
+   /// reports whether a read has failed
+   ///
+   /// A read of an integer fails when there are no digits,
+   /// or when the value doesn't fit in the integer.
+   /// This state remains until it is cleared by clear().
+   bool fail() const {
+      return failed;
+   }
+   
+   /// set or clear the failed state
+   ///
+   /// This is used by the functions that read from the stream.
+   void fail( bool x ){
+      failed = x;
+   }
+   
+   /// clear the failed state
+   void clear(){
+      failed = false;
+   }
+   
+   /// return the numerical radix       
+   uint_fast16_t base() const { 
+      return numerical_radix; 
+   }
+      
+   /// set the numerical radix (2 .. 36), return the old numerical radix
+   ///
+   /// The radix is used to read integers: 
+   /// the digits above 9 are the letters (lower or upper case).
+   /// A 0b, 0o or 0x prefix is accepted for radix 2, 8 and 16.
+   uint_fast16_t base( uint_fast16_t x ) { 
+      auto temp = numerical_radix;
+      numerical_radix = x; 
+      return temp;
+   }
+      
+   /// \cond INTERNAL      
+   friend istream & operator>>( istream & stream, const _setbase & x ){
+      stream.numerical_radix = x.x;
+      return stream;
+   }
+   /// \endcond 
         
    /// input operator for char
    ///
    /// This function reads and 'returns' a single character. 
    /// When no character is available it waits for one.   
    friend istream & operator>>( istream & stream, char & x ){
-      x = stream.getc();            
+      x = stream.get();            
       return stream;   
-   }           
+   }  
+   
+   /// input operator for short integer
+   ///
+   /// Leading white space is skipped, an optional sign is accepted.
+   friend istream & operator>>( istream & stream, short int & x ){
+      stream.read_signed( x );
+      return stream;
+   }
+   
+   /// input operator for integer
+   ///
+   /// Leading white space is skipped, an optional sign is accepted.
+   friend istream & operator>>( istream & stream, int & x ){
+      stream.read_signed( x );
+      return stream;
+   }
+   
+   /// input operator for long integer
+   ///
+   /// Leading white space is skipped, an optional sign is accepted.
+   friend istream & operator>>( istream & stream, long int & x ){
+      stream.read_signed( x );
+      return stream;
+   }
+   
+   /// input operator for long long integer
+   ///
+   /// Leading white space is skipped, an optional sign is accepted.
+   friend istream & operator>>( istream & stream, long long int & x ){
+      stream.read_signed( x );
+      return stream;
+   }
+   
+   /// input operator for short unsigned integer
+   ///
+   /// Leading white space is skipped, an optional '+' is accepted.
+   friend istream & operator>>( istream & stream, short unsigned int & x ){
+      stream.read_unsigned( x );
+      return stream;
+   }
+   
+   /// input operator for unsigned integer
+   ///
+   /// Leading white space is skipped, an optional '+' is accepted.
+   friend istream & operator>>( istream & stream, unsigned int & x ){
+      stream.read_unsigned( x );
+      return stream;
+   }
+   
+   /// input operator for unsigned long integer
+   ///
+   /// Leading white space is skipped, an optional '+' is accepted.
+   friend istream & operator>>( istream & stream, unsigned long int & x ){
+      stream.read_unsigned( x );
+      return stream;
+   }
+   
+   /// input operator for unsigned long long integer
+   ///
+   /// Leading white space is skipped, an optional '+' is accepted.
+   friend istream & operator>>( 
+      istream & stream, 
+      unsigned long long int & x 
+   ){
+      stream.read_unsigned( x );
+      return stream;
+   }
    
 }; // class istream
 
-/*
- * class stream_demux : public istream {
-   istream & left;
-   istream & right;
-public:
-
-};
-*/
-   
 }; // namespace hwlib
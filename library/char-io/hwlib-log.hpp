@@ -0,0 +1,606 @@
+// ==========================================================================
+//
+// File      : hwlib-log.hpp
+// Part of   : C++ hwlib library for close-to-the-hardware OO programming
+// Copyright : wouter@voti.nl 2017-2019
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// included only via hwlib.hpp, hence no multiple-include guard is needed
+
+// this file contains Doxygen lines
+/// @file
+
+namespace hwlib {
+
+/// \cond INTERNAL
+
+
+// ==========================================================================
+//
+// log message ids and argument types (at compile time)
+//
+// ==========================================================================
+
+// the type code of a log argument on the wire:
+//    ? : bool, 1 byte
+//    c : char, 1 byte
+//    i : signed integer, zigzag varint
+//    u : unsigned integer, varint
+//    f : floating-point, float (4 bytes, little-endian)
+//    s : string, a length byte followed by the characters
+template< typename T >
+constexpr char log_type_code(){
+   if constexpr( std::is_same< T, bool >::value ){
+      return '?';
+   } else if constexpr( std::is_same< T, char >::value ){
+      return 'c';
+   } else if constexpr( std::is_floating_point< T >::value ){
+      return 'f';
+   } else if constexpr( std::is_integral< T >::value ){
+      return std::is_signed< T >::value ? 'i' : 'u';
+   } else if constexpr(
+      std::is_convertible< T, const char * >::value
+      || std::is_base_of< string_base, T >::value
+   ){
+      return 's';
+   } else {
+      return '\0';
+   }
+}
+
+template< typename... Ts >
+struct log_types {
+   static constexpr char codes[] = { log_type_code< Ts >()..., '\0' };
+};
+
+// FNV-1a
+constexpr uint32_t log_hash( const char * s, uint32_t h = 2'166'136'261u ){
+   for( ; *s != '\0'; ++s ){
+      h = ( h ^ static_cast< uint8_t >( *s ) ) * 16'777'619u;
+   }
+   return h;
+}
+
+// the id of a message: the hash of its format string and argument types
+template< typename S, typename... Ts >
+constexpr uint32_t log_id(){
+   return log_hash(
+      log_types< Ts... >::codes,
+      log_hash( S::str() ) * 16'777'619u );
+}
+
+// ==========================================================================
+//
+// the message catalog
+//
+// ==========================================================================
+
+// a log message in the catalog
+class log_message {
+private:
+
+   static log_message * first;
+   log_message * const next;
+
+   static bool same( const char * a, const char * b ){
+      while( ( *a != '\0' ) && ( *a == *b ) ){
+         ++a;
+         ++b;
+      }
+      return *a == *b;
+   }
+
+public:
+
+   const uint32_t id;
+   const char * const format;
+   const char * const types;
+
+   // whether another message has the same id 
+   // but a different format string or argument types
+   bool ambiguous;
+
+   log_message( uint32_t id, const char * format, const char * types ):
+      next( first ), id( id ), format( format ), types( types ),
+      ambiguous( false )
+   {
+      for( auto p = first; p != nullptr; p = p->next ){
+         if( ( p->id == id ) 
+            && ! ( same( p->format, format ) && same( p->types, types ) ) 
+         ){
+            ambiguous = true;
+            p->ambiguous = true;
+         }
+      }
+      first = this;
+   }
+
+   // the message with the id, or nullptr
+   static const log_message * find( uint32_t id ){
+      for( auto p = first; p != nullptr; p = p->next ){
+         if( p->id == id ){
+            return p;
+         }
+      }
+      return nullptr;
+   }
+
+}; // class log_message
+
+// the catalog entry for a log call: it is created (before main)
+// for each log call that is compiled
+template< typename S, typename... Ts >
+struct log_catalog {
+   static inline log_message message{
+      log_id< S, Ts... >(), S::str(), log_types< Ts... >::codes };
+};
+
+
+// ==========================================================================
+//
+// log records
+//
+// ==========================================================================
+
+// a log record: the message id (4 bytes, little-endian)
+// and the arguments, preceded by a length byte (for the ring buffer)
+class log_record {
+public:
+
+   static constexpr size_t max_length = 255;
+
+   char data[ max_length + 1 ];
+   size_t length;
+
+   log_record( uint32_t id ): length( 0 ){
+      data[ 0 ] = 0;
+      for( int i = 0; i < 4; ++i ){
+         put( static_cast< char >( id >> ( 8 * i ) ) );
+      }
+   }
+
+   void put( char c ){
+      if( length < max_length ){
+         data[ ++length ] = c;
+      }
+   }
+   
+   // the length byte and the record
+   const char * stored(){
+      data[ 0 ] = static_cast< char >( length );
+      return data;
+   }
+
+   template< typename U >
+   void put_varint( U x ){
+      while( x >= 0x80 ){
+         put( static_cast< char >( x | 0x80 ) );
+         x >>= 7;
+      }
+      put( static_cast< char >( x ) );
+   }
+
+   // the number of characters a string can have
+   size_t string_room() const {
+      return ( length < max_length ) ? max_length - length - 1 : 0;
+   }
+
+   void put_string( const char * s, size_t n ){
+      if( n > string_room() ){
+         n = string_room();
+      }
+      put( static_cast< char >( n ) );
+      for( size_t i = 0; i < n; ++i ){
+         put( s[ i ] );
+      }
+   }
+
+   template< typename T >
+   void add( const T & x ){
+      constexpr char code = log_type_code< T >();
+      static_assert( code != '\0',
+         "hwlib::log: only numbers, chars, bools and strings "
+         "can be logged" );
+      if constexpr( ( code == '?' ) || ( code == 'c' ) ){
+         put( static_cast< char >( x ) );
+      } else if constexpr( code == 'f' ){
+         const float f = static_cast< float >( x );
+         uint32_t bits;
+         __builtin_memcpy( &bits, &f, 4 );
+         for( int i = 0; i < 4; ++i ){
+            put( static_cast< char >( bits >> ( 8 * i ) ) );
+         }
+      } else if constexpr( code == 'i' ){
+         using P = decltype( +x );
+         using U = typename std::make_unsigned< P >::type;
+         const P value = x;
+         put_varint( ( value < 0 )
+            ? static_cast< U >( ( ~static_cast< U >( value ) << 1 ) | 1 )
+            : static_cast< U >( static_cast< U >( value ) << 1 ) );
+      } else if constexpr( code == 'u' ){
+         using P = decltype( +x );
+         put_varint( static_cast< P >( x ) );
+      } else if constexpr( std::is_base_of< string_base, T >::value ){
+         put_string( x.begin(), x.length() );
+      } else {
+         const char * s = x;
+         size_t n = 0;
+         while( ( n < string_room() ) && ( s[ n ] != '\0' ) ){
+            ++n;
+         }
+         put_string( s, n );
+      }
+   }
+
+}; // class log_record
+
+/// \endcond
+
+
+// ==========================================================================
+//
+// logger
+//
+// ==========================================================================
+
+/// log message
+///
+/// This macro logs a message to a logger:
+/// @code
+///    HWLIB_LOG( log, "temperature {} at sensor {:#x}", t, address );
+/// @endcode
+///
+/// The format string is a hwlib::format() string,
+/// which is checked at compile time.
+/// The arguments can be integers, floating-point values
+/// (which are logged as float), chars, bools and strings
+/// (of which at most 250 characters are logged).
+#define HWLIB_LOG( LOGGER, S, ... ) \
+   ( LOGGER ).log( HWLIB_FORMAT( S ), ##__VA_ARGS__ )
+
+/// deferred-formatting binary logger
+///
+/// A logger doesn't format its messages.
+/// A log call (HWLIB_LOG) stores a record that contains
+/// a message id (a hash of the format string and the argument types,
+/// computed at compile time) and the arguments in binary form
+/// (integers as varints) in a ring buffer.
+/// Its background work writes the records, one per work() call,
+/// to an ostream as COBS-encoded frames.
+///
+/// A host tool that is built from the same sources uses a log_decoder
+/// to print the messages: each log call that is compiled
+/// puts its id, format string and argument types in a catalog,
+/// when the target defines _HWLIB_TARGET_LOG_CATALOG
+/// (the native targets do).
+/// The tools/log-decoder directory contains such a tool:
+/// put the log calls in a file that is compiled for both.
+///
+/// A record is much shorter than the formatted message,
+/// and a log call only copies its arguments.
+///
+/// The log calls must be made from one context
+/// (the main code, or one interrupt service routine):
+/// the ring buffer has a single producer and a single consumer.
+/// When a record doesn't fit in the ring buffer it is dropped,
+/// which is counted.
+///
+/// Use logger< N > to declare one,
+/// and logger_base for references.
+class logger_base : public background {
+private:
+
+   // only logger< N > is allowed to construct a logger_base
+   template< size_t > friend class logger;
+
+   ostream & out;
+   uint_fast32_t dropped;
+
+   logger_base( ostream & out ):
+      out( out ),
+      dropped( 0 )
+   {}
+
+   // store a record, return whether it fitted
+   virtual bool store( log_record & r ) = 0;
+
+   // get the next record, return its length (0 for none)
+   virtual size_t fetch( char * p ) = 0;
+
+   // write the next record, return whether there was one
+   bool write_record(){
+      char record[ log_record::max_length ];
+      const size_t n = fetch( record );
+      if( n == 0 ){
+         return false;
+      }
+      char frame[ cobs_max_length( log_record::max_length ) ];
+      out.write( frame, cobs_encode( record, n, frame ) );
+      return true;
+   }
+
+public:
+
+   /// \cond INTERNAL
+   template< typename S, typename... Ts >
+   void log( S, const Ts & ... xs ){
+      // the same checks as for hwlib::format():
+      // the decoder formats the arguments with the format string
+      format_writer< S >::template check< 0, Ts... >();
+
+      #ifdef _HWLIB_TARGET_LOG_CATALOG
+         (void) & log_catalog< S, Ts... >::message;
+      #endif
+
+      log_record r( log_id< S, Ts... >() );
+      ( r.add( xs ), ... );
+      if( ! store( r ) ){
+         ++dropped;
+      }
+   }
+   /// \endcond
+
+   /// write one record
+   void work() override {
+      write_record();
+   }
+
+   /// write all records, and flush the ostream
+   void flush(){
+      while( write_record() ){}
+      out.flush();
+   }
+
+   /// the number of records that were dropped
+   /// because the ring buffer was full
+   uint_fast32_t records_dropped() const {
+      return dropped;
+   }
+
+}; // class logger_base
+
+/// concrete deferred-formatting binary logger
+///
+/// This is the concrete logger class template.
+/// Use it to declare a logger with a ring buffer of N bytes.
+/// Use logger_base for references and parameters.
+template< size_t buffer_size = 256 >
+class logger : public logger_base {
+private:
+
+   // each record is stored as a length byte and the record
+   ring_buffer< char, buffer_size > buffer;
+
+   bool store( log_record & r ) override {
+      if( buffer.max_size() - buffer.size() < r.length + 1 ){
+         return false;
+      }
+      buffer.write( r.stored(), r.length + 1 );
+      return true;
+   }
+
+   size_t fetch( char * p ) override {
+      char n;
+      if( ! buffer.pop( n ) ){
+         return 0;
+      }
+      return buffer.read( p, static_cast< uint8_t >( n ) );
+   }
+
+public:
+
+   /// create a logger that writes to out
+   logger( ostream & out ):
+      logger_base( out )
+   {}
+
+}; // class logger
+
+
+// ==========================================================================
+//
+// log_decoder
+//
+// ==========================================================================
+
+/// decoder for the output of a logger
+///
+/// A log_decoder reads the frames written by a logger,
+/// and prints each message, followed by a '\\n', to an ostream.
+/// It uses the message catalog, so it must be built from
+/// the sources that contain the log calls,
+/// for a target that defines _HWLIB_TARGET_LOG_CATALOG.
+///
+/// A message that is not in the catalog, a message of which the id
+/// is shared by a different message (a hash collision),
+/// or a frame that is not a valid record, is printed as such.
+class log_decoder {
+private:
+
+   ostream & out;
+   char frame[ cobs_max_length( log_record::max_length ) ];
+   size_t length;
+   bool discarding;
+
+   // print a field, return the position after its argument
+   // (or 0 when the record is too short)
+   static size_t print_field(
+      ostream & out, const format_field & f, char code,
+      const char * p, size_t position, size_t n );
+
+public:
+
+   /// create a decoder that prints to out
+   log_decoder( ostream & out ):
+      out( out ),
+      length( 0 ),
+      discarding( false )
+   {}
+
+   /// decode a character
+   void decode( char c ){
+      if( c != '\0' ){
+         if( length == sizeof( frame ) ){
+            discarding = true;
+         } else {
+            frame[ length++ ] = c;
+         }
+         return;
+      }
+      if( length > 0 ){
+         const auto n = cobs_decode( frame, length, frame );
+         if( discarding || ( n == cobs_invalid ) ){
+            out.write( "<invalid frame>\n", 16 );
+         } else {
+            print( out, frame, n );
+         }
+      }
+      length = 0;
+      discarding = false;
+   }
+
+   /// decode a block of characters
+   void decode( const char * p, size_t n ){
+      for( size_t i = 0; i < n; ++i ){
+         decode( p[ i ] );
+      }
+   }
+
+   /// print a (decoded) record, followed by a '\\n'
+   static void print( ostream & out, const char * p, size_t n );
+
+}; // class log_decoder
+
+
+// ===========================================================================
+//
+// implementations
+//
+// ===========================================================================
+
+#ifdef _HWLIB_ONCE
+
+log_message * log_message::first = nullptr;
+
+size_t log_decoder::print_field(
+   ostream & out, const format_field & f, char code,
+   const char * p, size_t position, size_t n
+){
+   const auto number = f.spec( true );
+   const auto other = f.spec( false );
+   const bool numeric = f.type_is( "dxXob" );
+
+   if( ( code == '?' ) || ( code == 'c' ) ){
+      if( position + 1 > n ){
+         return 0;
+      }
+      const char c = p[ position ];
+      if( numeric ){
+         const int x = ( code == 'c' ) ? c : ( c != '\0' );
+         out.print_integer( ostream::magnitude( x ), x < 0, number );
+      } else if( code == 'c' ){
+         out.write_field( &c, 1, other );
+      } else if( c != '\0' ){
+         out.write_field( "true", 4, other );
+      } else {
+         out.write_field( "false", 5, other );
+      }
+      return position + 1;
+
+   } else if( code == 'f' ){
+      if( position + 4 > n ){
+         return 0;
+      }
+      uint32_t bits = 0;
+      for( int i = 0; i < 4; ++i ){
+         bits |= static_cast< uint32_t >(
+            static_cast< uint8_t >( p[ position + i ] ) ) << ( 8 * i );
+      }
+      float x;
+      __builtin_memcpy( &x, &bits, 4 );
+      out.print_floating( x, number );
+      return position + 4;
+
+   } else if( ( code == 'i' ) || ( code == 'u' ) ){
+      uint_fast64_t x = 0;
+      for( int shift = 0; ; shift += 7 ){
+         if( ( position == n ) || ( shift > 63 ) ){
+            return 0;
+         }
+         const auto b = static_cast< uint8_t >( p[ position++ ] );
+         x |= static_cast< uint_fast64_t >( b & 0x7F ) << shift;
+         if( ( b & 0x80 ) == 0 ){
+            break;
+         }
+      }
+      if( code == 'u' ){
+         out.print_integer( x, false, number );
+      } else if( ( x & 1 ) != 0 ){
+         out.print_integer( ( x >> 1 ) + 1, true, number );
+      } else {
+         out.print_integer( x >> 1, false, number );
+      }
+      return position;
+
+   } else if( code == 's' ){
+      if( position + 1 > n ){
+         return 0;
+      }
+      const size_t length = static_cast< uint8_t >( p[ position ] );
+      if( position + 1 + length > n ){
+         return 0;
+      }
+      out.write_field( p + position + 1, length, other );
+      return position + 1 + length;
+   }
+   return 0;
+}
+
+void log_decoder::print( ostream & out, const char * p, size_t n ){
+   if( n < 4 ){
+      out.write( "<invalid record>\n", 17 );
+      return;
+   }
+   uint32_t id = 0;
+   for( int i = 0; i < 4; ++i ){
+      id |= static_cast< uint32_t >(
+         static_cast< uint8_t >( p[ i ] ) ) << ( 8 * i );
+   }
+   const auto message = log_message::find( id );
+   if( message == nullptr ){
+      out << format( HWLIB_FORMAT( "<unknown message {:#010x}>\n" ), id );
+      return;
+   }
+   if( message->ambiguous ){
+      out << format( HWLIB_FORMAT( "<ambiguous message {:#010x}>\n" ), id );
+      return;
+   }
+
+   size_t position = 0;
+   size_t argument = 4;
+   const char * type = message->types;
+   for(;;){
+      const auto f = format_parse( message->format, position );
+      out.write( message->format + f.literal_start, f.literal_length );
+      if( f.kind == format_field::field ){
+         argument = print_field( out, f, *type++, p, argument, n );
+         if( argument == 0 ){
+            out.write( "<truncated>", 11 );
+            break;
+         }
+      } else if( f.kind != format_field::literal ){
+         break;
+      }
+      position = f.next;
+   }
+   out.putc( '\n' );
+}
+
+#endif // _HWLIB_ONCE
+
+}; // namespace hwlib
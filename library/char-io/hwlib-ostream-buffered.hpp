@@ -0,0 +1,164 @@
+// ==========================================================================
+//
+// File      : hwlib-ostream-buffered.hpp
+// Part of   : C++ hwlib library for close-to-the-hardware OO programming
+// Copyright : wouter@voti.nl 2017-2019
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// included only via hwlib.hpp, hence no multiple-include guard is needed
+
+// this file contains Doxygen lines
+/// @file
+
+namespace hwlib {
+
+
+// ==========================================================================
+//
+// ostream_buffered_base
+//
+// ==========================================================================
+
+/// ostream that collects characters and writes them as blocks
+///
+/// An ostream_buffered stores the characters that are written to it,
+/// and writes them to the ostream it decorates with a single write()
+/// call
+///    - when its buffer is full,
+///    - when a '\\n' is written (unless this is disabled), or
+///    - when it is flushed (which also flushes the decorated ostream).
+///
+/// A block that doesn't fit in the buffer is written directly,
+/// after the buffered characters.
+///
+/// This is meant for log-heavy code that writes to an ostream for
+/// which a block write is much cheaper than a sequence of putc()
+/// calls, for instance a console that sends a block in one transfer.
+///
+/// Use ostream_buffered< N > to declare one,
+/// and ostream_buffered_base for references.
+class ostream_buffered_base : public ostream {
+private:
+
+   ostream & s;
+   char * const buffer;
+   const size_t allocated_length;
+   size_t current_length;
+   const bool flush_on_newline;
+
+   // only ostream_buffered< N > is allowed to construct
+   // an ostream_buffered_base
+   template< size_t > friend class ostream_buffered;
+
+   ostream_buffered_base(
+      ostream & s,
+      char * buffer,
+      size_t allocated_length,
+      bool flush_on_newline
+   ):
+      s( s ),
+      buffer( buffer ),
+      allocated_length( allocated_length ),
+      current_length( 0 ),
+      flush_on_newline( flush_on_newline )
+   {}
+
+   // write the buffered characters, without flushing s
+   void write_buffer(){
+      if( current_length > 0 ){
+         s.write( buffer, current_length );
+         current_length = 0;
+      }
+   }
+
+public:
+
+   /// write a character
+   void putc( char c ) override {
+      buffer[ current_length++ ] = c;
+      if(
+         ( current_length == allocated_length )
+         || ( flush_on_newline && ( c == '\n' ))
+      ){
+         write_buffer();
+      }
+   }
+
+   /// write a block of characters
+   void write( const char * p, size_t n ) override {
+      if( current_length + n > allocated_length ){
+         write_buffer();
+         if( n >= allocated_length ){
+            s.write( p, n );
+            return;
+         }
+      }
+      for( size_t i = 0; i < n; ++i ){
+         buffer[ current_length++ ] = p[ i ];
+      }
+      if( current_length == allocated_length ){
+         write_buffer();
+      } else if( flush_on_newline ){
+         for( size_t i = 0; i < n; ++i ){
+            if( p[ i ] == '\n' ){
+               write_buffer();
+               break;
+            }
+         }
+      }
+   }
+
+   /// write the buffered characters, and flush the decorated ostream
+   void flush() override {
+      write_buffer();
+      s.flush();
+   }
+
+   /// the number of characters that are buffered
+   size_t buffered() const {
+      return current_length;
+   }
+
+}; // class ostream_buffered_base
+
+
+// ==========================================================================
+//
+// ostream_buffered< N >
+//
+// ==========================================================================
+
+/// concrete buffered ostream
+///
+/// This is the concrete buffered ostream class template.
+/// Use it to declare an ostream_buffered that buffers
+/// (up to) N characters.
+/// Use ostream_buffered_base for references and parameters.
+template< size_t buffer_length = 64 >
+class ostream_buffered : public ostream_buffered_base {
+private:
+
+   char content[ buffer_length ];
+
+public:
+
+   /// create a buffered ostream that decorates an ostream
+   ///
+   /// By default the buffer is also written when a '\\n' is written.
+   ostream_buffered( ostream & s, bool flush_on_newline = true ):
+      ostream_buffered_base( s, content, buffer_length, flush_on_newline )
+   {}
+
+   /// write the buffered characters
+   ~ostream_buffered(){
+      flush();
+   }
+
+}; // class ostream_buffered
+
+}; // namespace hwlib
@@ -52,6 +52,25 @@ struct setw {
 
 };
          
+/// ostream output precision manipulator
+struct setprecision {
+
+   /// \cond INTERNAL  
+   const uint_fast8_t x;
+   /// \endcond  
+      
+   /// ostream output precision manipulator
+   ///
+   /// Writing the setprecision(N) manipulator to an ostream sets 
+   /// the number of digits after the decimal point that are written
+   /// for a floating-point or fixed-point value.
+   /// The initial precision is 6.
+   ///
+   /// The same effect can be achieved by calling stream.precision(N).
+   constexpr setprecision( uint_fast8_t x ) : x( x ){}
+
+};
+         
 struct _setbase {
 
    /// \cond INTERNAL        
@@ -205,25 +224,131 @@ struct _flush {
 constexpr _flush flush;
    
    
+// ==========================================================================
+//
+// fixed-point values
+//
+// ==========================================================================
+
+/// binary fixed-point (Q format) value
+///
+/// This is a fixed-point value in Q format: an integer (of type T)
+/// that has fraction_bits bits after the binary point.
+/// For instance, fixed_point< 8 >( 0x0380 ) is 3.5.
+///
+/// When it is written to an ostream, it is printed with the precision
+/// of the ostream (at most 40 decimals), using only integer arithmetic.
+/// The decimals are exact: a value with n fraction bits has at most
+/// n decimals, the decimals after those are zeros.
+template< unsigned int fraction_bits, typename T = int32_t >
+struct fixed_point {
+
+   static_assert( fraction_bits <= 32, 
+      "fixed_point: at most 32 fraction bits are supported" );
+
+   /// the value, multiplied by 2 ^ fraction_bits
+   T raw;
+
+   /// create a fixed-point value from its raw (integer) value
+   constexpr fixed_point( T raw ): raw( raw ){}
+
+};
+
+/// decimal fixed-point value
+///
+/// This is an integer value with a decimal point at a fixed position:
+/// the value is divided by 10 ^ decimals.
+/// For instance, fixed_decimal( 2315, 2 ) is 23.15, 
+/// and fixed_decimal( -5, 3 ) is -0.005.
+///
+/// When it is written to an ostream, exactly the specified number
+/// of decimals is printed, using only integer arithmetic.
+template< typename T >
+struct fixed_decimal {
+
+   static_assert( std::is_integral< T >::value,
+      "fixed_decimal: the value must be an integer" );
+
+   /// the value, multiplied by 10 ^ decimals
+   T value;
+
+   /// the number of decimals
+   uint_fast8_t decimals;
+
+   /// create a decimal fixed-point value
+   constexpr fixed_decimal( T value, uint_fast8_t decimals ):
+      value( value ), decimals( decimals ){}
+
+};
+
+
 // ==========================================================================
 //
 // formatted ostream
 //
 // ==========================================================================
+
+/// \cond INTERNAL
+
+// the format of a single item,
+// packed because hwlib::format() has a constant one for each field
+struct format_spec {
+   uint16_t width;
+   uint8_t radix;
+   uint8_t precision;
+   char fill;
+   char hex_base;
+   bool align_right;
+   bool align_center;
+   bool show_pos;
+   bool show_base;
+   
+   // pad an integer with '0' between its sign (and prefix) and its digits
+   bool zero_pad;
+   
+   // the hexadecimal prefix is 0X instead of 0x
+   bool upper_prefix;
+};
+
+template< typename > class format_writer;
+class format_item_writer;
+class log_decoder;
+
+/// \endcond
   
 /// formatted character output interface
 ///
 /// This class is an std::ostream work-alike for small embedded systems.
 /// Most formatting features of std::ostream are supported.
-/// Floating point values are not supported.
+/// Floating-point values are printed in fixed notation (or in
+/// scientific notation when they are large), 
+/// with a precision that is set by setprecision().
+/// In the fixed notation the decimals are exact, and rounded 
+/// like printf does.
+/// Fixed-point values (fixed_point and fixed_decimal) 
+/// are printed using only integer arithmetic.
+///
+/// Integers are formatted without a division per digit where possible:
+/// binary, octal and hexadecimal digits by shifting and masking, 
+/// decimal digits two at a time from a table (and 64-bit values
+/// eight digits at a time, so the rest is done in 32-bit arithmetic).
+/// All integer types, including 64-bit unsigned values, are printed 
+/// with their full range.
 /// 
 /// This class is abstract: a concrete subclass 
-/// must implement putc() and flush().
+/// must implement putc() and flush(), and can implement write().
 class ostream : public noncopyable {
 private:
    
+   // the hwlib::format() implementation and the log decoder 
+   // use the formatting functions
+   template< typename > friend class format_writer;
+   friend class format_item_writer;
+   friend class log_decoder;
+   
    uint_fast16_t field_width;
    uint_fast16_t numerical_radix;
+   uint_fast8_t float_precision;
    char fill_char;
    char hex_base;
    bool align_right;
@@ -241,63 +366,537 @@ private:
    }     
    
    // must handle negative numbers!
-   void filler( int_fast16_t n ){
-      while( n-- > 0 ){
-         *this << fill_char;
+   void filler( int_fast16_t n, char c ){
+      char fill[ 8 ];
+      for( auto & f : fill ){
+         f = c;
+      }
+      while( n > 0 ){
+         const auto chunk = ( n < 8 ) ? n : 8;
+         write( fill, chunk );
+         n -= chunk;
       }
    }      
        
+   // the format of the next item, as set by the manipulators
+   format_spec spec() const {
+      return { 
+         static_cast< uint16_t >( field_width ), 
+         static_cast< uint8_t >( numerical_radix ), 
+         static_cast< uint8_t >( float_precision ), 
+         fill_char, hex_base,
+         align_right, false, show_pos, show_base, false, false };
+   }
+               
+   // write an item of n characters, padded to the field width
+   void write_field( const char * s, size_t n, const format_spec & f ){
+      const auto pad = ( f.width > n ) 
+         ? static_cast< int_fast16_t >( f.width - n ) 
+         : 0;
+      const auto before = 
+         f.align_center ? pad / 2 : ( f.align_right ? pad : 0 );
+      filler( before, f.fill );
+      write( s, n );
+      filler( pad - before, f.fill );
+   }
+   
+   void write_field( const char * s, size_t n ){
+      write_field( s, n, spec() );
+      field_width = 0;
+   }
+       
                
    // =======================================================================
    //
-   // helper for printing integer values, which are generated
-   // in reverse order
+   // helpers for printing integer values
+   //
+   // The digits are generated in reverse order, from the end of a buffer.
+   // The radix is dispatched once per value: binary, octal and 
+   // hexadecimal digits are generated by shift-and-mask, decimal digits
+   // two at a time from a table, other radixes by division.
+   // The sign, the radix prefix and the fill are added once per value.
    //
    // =======================================================================
-      
-   struct reverse {
-      static constexpr uint_fast16_t length = 70;
-      char body[ length ];
-      char *content;
-         
-      reverse(){
-         body[ length - 1 ] = '\0';
-         content = & body[ length - 1 ];
+   
+   // 64 binary digits, a radix prefix and a sign
+   static constexpr size_t integer_buffer_length = 64 + 2 + 1;
+   
+   // "00", "01", .. "99"
+   static const char decimal_pairs[ 200 ];
+   
+   template< unsigned int shift, typename T >
+   static char * power_of_two_digits( char * p, T x, char hex_base ){
+      constexpr T mask = ( 1u << shift ) - 1;
+      do {
+         const auto d = static_cast< char >( x & mask );
+         *--p = ( d < 10 ) ? '0' + d : hex_base + ( d - 10 );
+         x >>= shift;
+      } while( x != 0 );
+      return p;
+   }
+   
+   template< typename T >
+   static char * decimal_digits( char * p, T x ){
+      if( sizeof( T ) > sizeof( uint32_t ) ){
+          
+         // a 64-bit division is a slow library call on most targets:
+         // take the low 8 digits at a time, and do the rest in 32 bits
+         while( x > 0xFFFF'FFFFu ){
+            auto low = static_cast< uint32_t >( x % 100'000'000u );
+            x /= 100'000'000u;
+            for( int i = 0; i < 4; ++i ){
+               const auto pair = 2 * ( low % 100 );
+               low /= 100;
+               *--p = decimal_pairs[ pair + 1 ];
+               *--p = decimal_pairs[ pair ];
+            }
+         }
+         return decimal_digits( p, static_cast< uint32_t >( x ) );
       }
-         
-      void add_char( char c ){
-         content--;
-         *content = c;
+      while( x >= 100 ){
+         const auto pair = 2 * ( x % 100 );
+         x /= 100;
+         *--p = decimal_pairs[ pair + 1 ];
+         *--p = decimal_pairs[ pair ];
       }
+      if( x >= 10 ){
+         *--p = decimal_pairs[ 2 * x + 1 ];
+         *--p = decimal_pairs[ 2 * x ];
+      } else {
+         *--p = static_cast< char >( '0' + x );
+      }
+      return p;
+   }
+   
+   template< typename T >
+   static char * radix_digits( char * p, T x, T radix, char hex_base ){
+      do {
+         const auto d = static_cast< char >( x % radix );
+         *--p = ( d < 10 ) ? '0' + d : hex_base + ( d - 10 );
+         x /= radix;
+      } while( x != 0 );
+      return p;
+   }
+   
+   // print an integer, given as its magnitude (an unsigned type) 
+   // and its sign
+   template< typename T >
+   void print_integer( T magnitude, bool minus, const format_spec & f ){
+      char buffer[ integer_buffer_length ];
+      char * const end = buffer + integer_buffer_length;
+      char * p;
+      switch( f.radix ){
+         case 2  : 
+            p = power_of_two_digits< 1 >( end, magnitude, f.hex_base ); 
+            break;
+         case 8  : 
+            p = power_of_two_digits< 3 >( end, magnitude, f.hex_base ); 
+            break;
+         case 16 : 
+            p = power_of_two_digits< 4 >( end, magnitude, f.hex_base ); 
+            break;
+         case 10 : 
+            p = decimal_digits( end, magnitude );           
+            break;
+         default : 
+            p = ( ( f.radix < 2 ) || ( f.radix > 36 ) )
+               ? decimal_digits( end, magnitude )
+               : radix_digits( 
+                    end, magnitude, static_cast< T >( f.radix ), f.hex_base );
+            break;
+      }
+      char * const digits = p;
+      if( f.show_base ){
+         switch( f.radix ){
+            case 2  : *--p = 'b'; break;
+            case 8  : *--p = 'o'; break;
+            case 10 : break;
+            case 16 : *--p = f.upper_prefix ? 'X' : 'x'; break;
+            default : *--p = '?'; break; 
+         }
+         if( f.radix != 10 ){
+            *--p = '0';
+         }
+      }
+      if( minus ){
+         *--p = '-';
+      } else if( f.show_pos ){
+         *--p = '+';
+      }
+      write_number( p, digits, end, f );
+   }
+   
+   // write a number: its sign (and prefix) from p to digits, 
+   // and its digits from digits to end
+   void write_number( 
+      const char * p, 
+      const char * digits, 
+      const char * end, 
+      const format_spec & f 
+   ){
+      if( f.zero_pad ){
          
-      void add_digit( char c, char hex_base ){
-         if( c > 9 ){
-            c += ( hex_base - 10 );
+         // the zeros go between the sign and prefix, and the digits
+         write( p, digits - p );
+         filler( 
+            static_cast< int_fast16_t >( f.width ) - ( end - p ), '0' );
+         write( digits, end - digits );
+      } else {
+         write_field( p, end - p, f );
+      }
+   }
+   
+   template< typename T >
+   void print_integer( T magnitude, bool minus ){
+      print_integer( magnitude, minus, spec() );
+      field_width = 0;
+   }
+   
+   // =======================================================================
+   //
+   // helpers for printing fixed-point and floating-point values
+   //
+   // A value is printed from its integer part and its fraction,
+   // which is already scaled and rounded to an integer of the 
+   // requested number of decimals.
+   // Only integer arithmetic is used to print these, 
+   // so no printf (or other library) code is needed.
+   //
+   // =======================================================================
+   
+   template< typename T >
+   static T power_of_10( uint_fast8_t n ){
+      T result = 1;
+      while( n-- > 0 ){
+         result *= 10;
+      }
+      return result;
+   }
+   
+   // print a value from its integer part, its (scaled) fraction 
+   // and number of decimals, and its (decimal) exponent when it has one
+   template< typename U, typename F >
+   void print_fraction( 
+      bool minus, 
+      U whole, 
+      F fraction, 
+      uint_fast8_t decimals,
+      int_fast16_t exponent,
+      bool has_exponent,
+      const format_spec & f 
+   ){
+      char buffer[ integer_buffer_length ];
+      char * const end = buffer + integer_buffer_length;
+      char * p = end;
+      if( has_exponent ){
+         const auto e = ( exponent < 0 ) ? - exponent : exponent;
+         p = decimal_digits( p, static_cast< unsigned int >( e ) );
+         if( e < 10 ){
+            *--p = '0';
+         }
+         *--p = ( exponent < 0 ) ? '-' : '+';
+         *--p = 'e';
+      }
+      if( decimals > 0 ){
+         char * const first = p - decimals;
+         p = decimal_digits( p, fraction );
+         while( p > first ){
+            *--p = '0';
+         }
+         *--p = '.';
+      }
+      p = decimal_digits( p, whole );
+      char * const digits = p;
+      if( minus ){
+         *--p = '-';
+      } else if( f.show_pos ){
+         *--p = '+';
+      }
+      write_number( p, digits, end, f );
+   }
+   
+   // print a fixed_point value
+   //
+   // The decimals are computed one at a time: the fraction 
+   // (below 2 ^ 32) times 10 fits in 64 bits. A value with n fraction
+   // bits has at most n decimals, so all printed decimals are exact.
+   template< unsigned int fraction_bits, typename T >
+   void print_fixed_point( 
+      const fixed_point< fraction_bits, T > & x, 
+      const format_spec & f 
+   ){
+      const auto m = static_cast< uint_fast64_t >( magnitude( x.raw ) );
+      constexpr uint_fast64_t one = uint_fast64_t( 1 ) << fraction_bits;
+      
+      // the buffer limits the number of decimals
+      const uint_fast8_t decimals = ( f.precision < 40 ) ? f.precision : 40;
+      char buffer[ integer_buffer_length ];
+      char * const end = buffer + integer_buffer_length;
+      char * const first = end - decimals;
+      
+      auto whole = m >> fraction_bits;
+      auto rest = m & ( one - 1 );
+      for( char * p = first; p < end; ++p ){
+         rest *= 10;
+         *p = static_cast< char >( '0' + ( rest >> fraction_bits ) );
+         rest &= one - 1;
+      }
+      
+      // the decimals are rounded half to even, like printf does
+      const bool odd = ( decimals > 0 ) 
+         ? ( ( end[ -1 ] - '0' ) & 1 ) != 0
+         : ( whole & 1 ) != 0;
+      if( 
+         ( rest > ( one >> 1 ) ) 
+         || ( ( rest == ( one >> 1 ) ) && ( rest != 0 ) && odd ) 
+      ){
+         char * p = end;
+         while( ( p > first ) && ( p[ -1 ] == '9' ) ){
+            *--p = '0';
+         }
+         if( p > first ){
+            ++p[ -1 ];
          } else {
-            c += '0';
-         } 
-         add_char( c );
+            ++whole;
+         }
+      }
+      
+      char * p = first;
+      if( decimals > 0 ){
+         *--p = '.';
+      }
+      p = decimal_digits( p, whole );
+      char * const digits = p;
+      if( x.raw < 0 ){
+         *--p = '-';
+      } else if( f.show_pos ){
+         *--p = '+';
+      }
+      write_number( p, digits, end, f );
+   }
+   
+   // print a fixed_decimal value
+   template< typename T >
+   void print_fixed_decimal( 
+      const fixed_decimal< T > & x, 
+      const format_spec & f 
+   ){
+      const auto m = magnitude( x.value );
+      using U = typename std::make_unsigned< T >::type;
+      
+      // a scale that doesn't fit in U leaves the whole part 0,
+      // and the buffer limits the number of decimals
+      const uint_fast8_t wanted = ( x.decimals < 60 ) ? x.decimals : 60;
+      uint_fast8_t decimals = 0;
+      U scale = 1;
+      while( ( decimals < wanted ) && ( scale <= U( -1 ) / 10 ) ){
+         scale *= 10;
+         ++decimals;
+      }
+      const U whole = ( decimals < wanted ) ? 0 : m / scale;
+      const U fraction = ( decimals < wanted ) ? m : m % scale;
+      print_fraction( x.value < 0, whole, fraction, wanted, 0, false, f );
+   }
+   
+   // the powers 10 ^ ( 2 ^ n ) that fit in a float and in a double,
+   // used to scale a large value to [ 1, 10 )
+   static constexpr float float_powers_of_10[] = 
+      { 1e1f, 1e2f, 1e4f, 1e8f, 1e16f, 1e32f };
+   static constexpr double double_powers_of_10[] = 
+      { 1e1, 1e2, 1e4, 1e8, 1e16, 1e32
+#if __DBL_MAX_10_EXP__ >= 256
+      , 1e64, 1e128, 1e256 
+#endif
+      };
+      
+   static const float * powers_of_10( float, int_fast8_t & n ){
+      n = sizeof( float_powers_of_10 ) / sizeof( float );
+      return float_powers_of_10;
+   }
+      
+   static const double * powers_of_10( double, int_fast8_t & n ){
+      n = sizeof( double_powers_of_10 ) / sizeof( double );
+      return double_powers_of_10;
+   }
+   
+   // the fraction r / 2 ^ k ( with 0 < k and r < 2 ^ k ), times scale:
+   // returns the whole part of the result, and sets rest to -1, 0 or 1 
+   // when the part that is left is below, at or above one half.
+   // The product r * scale needs 128 bits for a double (wide), 
+   // and 64 bits for a float.
+   template< bool wide >
+   static uint64_t scale_fraction( 
+      uint64_t r, 
+      int_fast16_t k, 
+      uint64_t scale,
+      int_fast8_t & rest
+   ){
+      rest = -1;
+      
+      // r is below 2 ^ 53 and scale below 2 ^ 57,
+      // so the product is below 2 ^ 110
+      if( ( r == 0 ) || ( k > 110 ) ){
+         return 0;
+      }
+      
+      uint64_t high = 0, low = r * scale;
+      if constexpr( wide ){
+         constexpr uint64_t mask = 0xFFFF'FFFF;
+         const uint64_t p00 = ( r & mask ) * ( scale & mask );
+         const uint64_t p01 = ( r & mask ) * ( scale >> 32 );
+         const uint64_t p10 = ( r >> 32 ) * ( scale & mask );
+         const uint64_t p11 = ( r >> 32 ) * ( scale >> 32 );
+         const uint64_t middle = ( p00 >> 32 ) + ( p01 & mask ) + ( p10 & mask );
+         low = ( middle << 32 ) | ( p00 & mask );
+         high = p11 + ( p01 >> 32 ) + ( p10 >> 32 ) + ( middle >> 32 );
+      }
+      
+      // the bit n of the product, and whether a bit below it is set
+      const auto bit = [ & ]( int_fast16_t n ) -> bool {
+         return ( ( n < 64 ) ? ( low >> n ) : ( high >> ( n - 64 ) ) ) & 1;
+      };
+      const auto below = [ & ]( int_fast16_t n ) -> bool {
+         return ( n > 64 )
+            ? ( ( low != 0 ) 
+                || ( ( high & ( ( uint64_t( 1 ) << ( n - 64 ) ) - 1 ) ) != 0 ) )
+            : ( ( n == 64 ) 
+                ? ( low != 0 ) 
+                : ( ( low & ( ( uint64_t( 1 ) << n ) - 1 ) ) != 0 ) );
+      };
+      
+      if( bit( k - 1 ) ){
+         rest = below( k - 1 ) ? 1 : 0;
+      }
+      if( k >= 64 ){
+         return ( k == 64 ) ? high : ( high >> ( k - 64 ) );
       }
+      return ( high << ( 64 - k ) ) | ( low >> k );
+   }
+   
+   // print a floating-point value:
+   // the whole part of a float in 32-bit integer arithmetic, 
+   // and of a double in 64-bit. The fraction is scaled by a 64-bit
+   // product for a float, and by a 128-bit product (emulated 
+   // with four 32 x 32 bit multiplications) for a double.
+   //
+   // In the fixed notation, the value is split into its integer 
+   // mantissa and binary exponent, so the decimals are exact, 
+   // and rounded half to even like printf does.
+   // In the scientific notation (for large values) the value is first 
+   // scaled by powers of 10, which can change the last decimal.
+   template< typename T >
+   void print_floating( T x, const format_spec & f ){
+      constexpr bool is_double = sizeof( T ) > sizeof( uint32_t );
+      using U = typename std::conditional< 
+         is_double, uint_fast64_t, uint_fast32_t >::type;
+      using B = typename std::conditional< 
+         is_double, uint64_t, uint32_t >::type;
+      static_assert( sizeof( B ) == sizeof( T ), 
+         "a float must be 32 or 64 bits" );
+         
+      // the IEEE 754 format: x = m * 2 ^ ( - k ),
+      // with k = bias - the exponent field 
+      constexpr int_fast16_t mantissa_bits = is_double ? 52 : 23;
+      constexpr int_fast16_t exponent_mask = is_double ? 0x7FF : 0xFF;
+      constexpr int_fast16_t bias = is_double ? 1075 : 150;
          
-      void add_prefix( const ostream & s ){
-         if( s.show_base ){
-            switch( s.numerical_radix ){
-               case 2  : add_char( 'b' ); break;
-               case 8  : add_char( 'o' ); break;
-               case 10 : return;
-               case 16 : add_char( 'x' ); break;
-               default : add_char( '?' ); break; 
+      // the largest precision for which the scaled fraction fits in U,
+      // and the limit for the fixed (not scientific) notation
+      constexpr uint_fast8_t max_precision = is_double ? 17 : 9;
+      constexpr T fixed_limit = is_double ? T( 1e19 ) : T( 4e9 );
+      
+      if( x != x ){
+         write_field( "nan", 3, f );
+         return;
+      }
+      
+      // the sign bit, so -0.0 is printed with its sign, like printf does
+      B bits;
+      __builtin_memcpy( & bits, & x, sizeof( bits ) );
+      const bool minus = ( bits >> ( 8 * sizeof( B ) - 1 ) ) != 0;
+      if( minus ){
+         x = -x;
+      }
+      if( x - x != 0 ){
+         write_field( minus ? "-inf" : "inf", minus ? 4 : 3, f );
+         return;
+      }
+      
+      // scale a large value to [ 1, 10 ), and use the exponent
+      int_fast16_t exponent = 0;
+      const bool has_exponent = ( x >= fixed_limit );
+      if( has_exponent ){
+         int_fast8_t n;
+         const T * const powers = powers_of_10( x, n );
+         for( int_fast8_t i = n - 1; i >= 0; --i ){
+            if( x >= powers[ i ] ){
+               x /= powers[ i ];
+               exponent += 1 << i;
             }
-            add_char( '0' );
          }
-      }          
-   };
+      }
+      
+      // x = m * 2 ^ ( - k ), exactly
+      __builtin_memcpy( & bits, & x, sizeof( bits ) );
+      const auto field = static_cast< int_fast16_t >( 
+         ( bits >> mantissa_bits ) & exponent_mask );
+      uint64_t m = bits & ( ( B( 1 ) << mantissa_bits ) - 1 );
+      int_fast16_t k = bias - 1;
+      if( field != 0 ){
+         m |= uint64_t( 1 ) << mantissa_bits;
+         k = bias - field;
+      }
+      
+      // the whole part (which fits in U), and the fraction r / 2 ^ k
+      U whole = 0;
+      uint64_t r = m;
+      if( k <= 0 ){
+         whole = static_cast< U >( m ) << -k;
+         r = 0;
+      } else if( k < 64 ){
+         whole = static_cast< U >( m >> k );
+         r = m & ( ( uint64_t( 1 ) << k ) - 1 );
+      }
+      
+      const uint_fast8_t decimals = 
+         ( f.precision < max_precision ) ? f.precision : max_precision;
+      const auto scale = power_of_10< U >( decimals );
+      
+      // the fraction is rounded half to even, like printf does
+      int_fast8_t rest;
+      auto fraction = static_cast< U >( 
+         scale_fraction< is_double >( r, k, scale, rest ) );
+      const U last = ( decimals > 0 ) ? fraction : whole;
+      if( ( rest > 0 ) || ( ( rest == 0 ) && ( last & 1 ) ) ){
+         ++fraction;
+      }
+      if( fraction >= scale ){
+         fraction -= scale;
+         ++whole;
+         if( has_exponent && ( whole == 10 ) ){
+            whole = 1;
+            ++exponent;
+         }
+      }
+      print_fraction( 
+         minus, whole, fraction, decimals, exponent, has_exponent, f );
+   }
+  
+   // the magnitude of a signed value, also for the most negative value
+   template< typename T >
+   static typename std::make_unsigned< T >::type magnitude( T x ){
+      using U = typename std::make_unsigned< T >::type;
+      return ( x < 0 ) 
+         ? static_cast< U >( 0u - static_cast< U >( x ) ) 
+         : static_cast< U >( x );
+   }
   
 public:
       
    constexpr ostream(): 
       field_width( 0 ), 
       numerical_radix( 10 ),
+      float_precision( 6 ),
       fill_char( ' ' ), 
       hex_base( 'A' ),
       align_right( true ), 
@@ -311,6 +910,21 @@ public:
    /// This function is called by the other functions to output
    /// each character.
    virtual void putc( char c ) = 0;    
+   
+   /// block output function
+   ///
+   /// This function writes n characters.
+   /// The strings, integers and fill characters are written by
+   /// calling this function, so a sink that can write a block of
+   /// characters faster than one character at a time 
+   /// (for instance by a single transfer) should override it.
+   ///
+   /// The default implementation calls putc() for each character.
+   virtual void write( const char * s, size_t n ){
+      for( size_t i = 0; i < n; ++i ){
+         putc( s[ i ] );
+      }
+   }
        
    /// char output operator 
    ostream & operator<< ( char c ){ 
@@ -357,6 +971,23 @@ public:
    }
    /// \endcond 
       
+   /// return the current precision
+   uint_fast8_t precision( void ) const { return float_precision; }
+      
+   /// set the precision, return the old precision
+   uint_fast8_t precision( uint_fast8_t x ) { 
+      auto temp = float_precision; 
+      float_precision = x; 
+      return temp;
+   }
+      
+   /// \cond INTERNAL      
+   friend ostream & operator<< ( ostream & stream, const setprecision & x ){
+      stream.precision( x.x );
+      return stream;
+   }
+   /// \endcond 
+      
    /// return the numerical radix       
    uint_fast16_t base( void ) const { return numerical_radix; }
       
@@ -479,18 +1110,7 @@ public:
   
    /// output operator for const char pointer (literal string)
    friend ostream & operator<< ( ostream & stream, const char *s ){
-      if( stream.align_right ){
-         stream.filler( static_cast< int_fast16_t >( 
-		    stream.width()) - strlen( s )); 
-      }       
-      for( const char *p = s; *p != '\0'; p++ ){
-         stream << *p;
-      }
-      if( ! stream.align_right ){
-        stream.filler( static_cast< int_fast16_t >( 
-		   stream.width()) - strlen( s )); 
-      }  
-      stream.width( 0 );
+      stream.write_field( s, strlen( s ) );
       return stream;
    }    
   
@@ -503,27 +1123,7 @@ public:
       
    /// output operator for integer      
    friend ostream & operator<< ( ostream & stream, int x ){
-      reverse s;
-         
-      bool minus = ( x < 0 );
-      if( x < 0 ){ x = -x; }
-         
-      if( x == 0 ){
-         s.add_digit( 0, stream.hex_base );
-      }
-      while( x > 0 ){
-         s.add_digit( x % stream.base(), stream.hex_base );
-         x = x / stream.base();
-      }
-      s.add_prefix( stream );
-         
-      if( minus ){
-         s.add_char( '-' );
-      } else if( stream.showpos() ){
-         s.add_char( '+' );
-      }        
-         
-      stream << s.content;
+      stream.print_integer( magnitude( x ), x < 0 );
       return stream;   
    }
    
@@ -534,53 +1134,37 @@ public:
    
    /// output operator for long integer   
    friend ostream & operator<< ( ostream & stream, long int x ){
-      return stream << static_cast< int >( x );
+      stream.print_integer( magnitude( x ), x < 0 );
+      return stream;   
    }
    
    /// output operator for long long integer   
    friend ostream & operator<< ( ostream & stream, long long int x ){
-      reverse s;
-
-      bool minus = ( x < 0 );
-      if( x < 0 ){ x = -x; }
-
-      if( x == 0 ){
-         s.add_digit( 0, stream.hex_base );
-      }
-      while( x != 0 ){
-         s.add_digit( x % stream.base(), stream.hex_base );
-         x = x / stream.base();
-      }
-      s.add_prefix( stream );
-
-      if( minus ){
-         s.add_char( '-' );
-      } else if( stream.showpos() ){
-         s.add_char( '+' );
-      }   
-         
-      stream << s.content;
+      stream.print_integer( magnitude( x ), x < 0 );
       return stream;   
    }
    
    /// output operator for short unsigned integer   
    friend ostream & operator<< ( ostream & stream, short unsigned int x ){
-      return stream << static_cast< long long int >( x );      
+      return stream << static_cast< unsigned int >( x );      
    }
    
    /// output operator for unsigned integer   
    friend ostream & operator<< ( ostream & stream, unsigned int x ){
-      return stream << static_cast< long long int >( x );      
+      stream.print_integer( x, false );
+      return stream;   
    }
    
    /// output operator for unsigned long integer   
    friend ostream & operator<< ( ostream & stream, unsigned long int x ){
-      return stream << static_cast< long long int >( x ); 
+      stream.print_integer( x, false );
+      return stream;   
    }
  
    /// output operator for unsigned long long integer    
    friend ostream & operator<< ( ostream & stream, unsigned long long x ){
-      return stream << static_cast< long long int >( x ); 
+      stream.print_integer( x, false );
+      return stream;   
    }
    
    /// output operator for signed char (prints as integer)   
@@ -596,7 +1180,95 @@ public:
       //stream.putc( c );
       //return stream;
    }
+  
+  
+   // =======================================================================
+   //
+   // print fixed-point and floating-point values
+   //
+   // =======================================================================
+   
+   /// output operator for a binary fixed-point value
+   template< unsigned int fraction_bits, typename T >
+   friend ostream & operator<< ( 
+      ostream & stream, 
+      const fixed_point< fraction_bits, T > & x 
+   ){
+      stream.print_fixed_point( x, stream.spec() );
+      stream.field_width = 0;
+      return stream;
+   }
+   
+   /// output operator for a decimal fixed-point value
+   template< typename T >
+   friend ostream & operator<< ( 
+      ostream & stream, 
+      const fixed_decimal< T > & x 
+   ){
+      stream.print_fixed_decimal( x, stream.spec() );
+      stream.field_width = 0;
+      return stream;
+   }
+   
+   /// output operator for float
+   ///
+   /// The value is printed with precision (by default 6) decimals.
+   /// A value of 4e9 or more is printed in scientific notation
+   /// (like 1.234560e+12).
+   /// Only float arithmetic is used (no double), and at most
+   /// 9 decimals are printed.
+   friend ostream & operator<< ( ostream & stream, float x ){
+      stream.print_floating( x, stream.spec() );
+      stream.field_width = 0;
+      return stream;
+   }
+   
+   /// output operator for double
+   ///
+   /// The value is printed with precision (by default 6) decimals.
+   /// A value of 1e19 or more is printed in scientific notation
+   /// (like 1.234560e+22).
+   /// At most 17 decimals are printed.
+   friend ostream & operator<< ( ostream & stream, double x ){
+      stream.print_floating( x, stream.spec() );
+      stream.field_width = 0;
+      return stream;
+   }
       
 }; // class ostream  
 
+
+// ===========================================================================
+//
+// implementations
+//
+// ===========================================================================
+
+#ifdef _HWLIB_ONCE
+
+const char ostream::decimal_pairs[ 200 ] = {
+   '0','0', '0','1', '0','2', '0','3', '0','4', 
+   '0','5', '0','6', '0','7', '0','8', '0','9',
+   '1','0', '1','1', '1','2', '1','3', '1','4', 
+   '1','5', '1','6', '1','7', '1','8', '1','9',
+   '2','0', '2','1', '2','2', '2','3', '2','4', 
+   '2','5', '2','6', '2','7', '2','8', '2','9',
+   '3','0', '3','1', '3','2', '3','3', '3','4', 
+   '3','5', '3','6', '3','7', '3','8', '3','9',
+   '4','0', '4','1', '4','2', '4','3', '4','4', 
+   '4','5', '4','6', '4','7', '4','8', '4','9',
+   '5','0', '5','1', '5','2', '5','3', '5','4', 
+   '5','5', '5','6', '5','7', '5','8', '5','9',
+   '6','0', '6','1', '6','2', '6','3', '6','4', 
+   '6','5', '6','6', '6','7', '6','8', '6','9',
+   '7','0', '7','1', '7','2', '7','3', '7','4', 
+   '7','5', '7','6', '7','7', '7','8', '7','9',
+   '8','0', '8','1', '8','2', '8','3', '8','4', 
+   '8','5', '8','6', '8','7', '8','8', '8','9',
+   '9','0', '9','1', '9','2', '9','3', '9','4', 
+   '9','5', '9','6', '9','7', '9','8', '9','9'
+};
+
+#endif // _HWLIB_ONCE
+
 }; // namespace hwlib
@@ -17,44 +17,548 @@
 
 namespace hwlib {
 
-class ostream_prefix : ostream {
+// ==========================================================================
+//
+// COBS
+//
+// ==========================================================================
+
+/// the maximum length of the COBS encoding of n bytes
+///
+/// This includes the frame delimiter.
+constexpr size_t cobs_max_length( size_t n ){
+   return n + ( n / 254 ) + 2;
+}
+
+/// COBS-encode n bytes, return the length of the encoding
+///
+/// This function writes the Consistent Overhead Byte Stuffing 
+/// encoding of the bytes, followed by a '\\0' frame delimiter, 
+/// to out, which must have room for cobs_max_length( n ) bytes.
+/// The encoding contains no '\\0' bytes, 
+/// so the delimiter marks the end of the frame.
+size_t cobs_encode( const char * p, size_t n, char * out );
+
+/// the value returned by cobs_decode() for an invalid encoding
+constexpr size_t cobs_invalid = static_cast< size_t >( -1 );
+
+/// COBS-decode a frame, return the length of the decoded bytes
+///
+/// This function decodes the n bytes of a COBS-encoded frame 
+/// (without its '\0' delimiter) to out.
+/// The decoded bytes are never more than the encoded bytes,
+/// and out can be the same as p.
+/// When the frame is not a valid encoding, cobs_invalid is returned.
+size_t cobs_decode( const char * p, size_t n, char * out );
+
+/// \cond INTERNAL 
+class istream_demux_base;
+/// \endcond
+
+
+// ==========================================================================
+//
+// ostream_mux
+//
+// ==========================================================================
+
+/// one channel of a multiplexed serial link
+///
+/// An ostream_mux collects the characters written to it,
+/// and writes them to a link (an ostream) as a single COBS-encoded frame,
+/// that starts with the channel number:
+///    - when its buffer is full,
+///    - when a '\\n' is written (unless this is disabled), or
+///    - when it is flushed (which also flushes the link).
+///
+/// Each frame is written to the link with a single write() call,
+/// so several ostream_mux objects (for instance for logging, telemetry 
+/// and the replies to commands) can share one link.
+/// At the other end of the link, a stream_demux splits the frames 
+/// over the channels.
+///
+/// Use ostream_mux< N > to declare one,
+/// and ostream_mux_base for references.
+class ostream_mux_base : public ostream {
 private:
 
-   ostream & minion;
-   const char marker;
+   ostream & link;
+   char * const buffer;
+   char * const frame;
+   const size_t allocated_length;
+   size_t current_length;
+   const bool flush_on_newline;
 
-public:
+   // only ostream_mux< N > is allowed to construct
+   // an ostream_mux_base
+   template< size_t > friend class ostream_mux;
 
-   ostream_mux( ostream & minion, char marker ): 
-      minion( minion ), marker( marker )
-   {}
+   // buffer[ 0 ] is the channel number
+   ostream_mux_base(
+      ostream & link,
+      uint8_t channel,
+      char * buffer,
+      char * frame,
+      size_t allocated_length,
+      bool flush_on_newline
+   ):
+      link( link ),
+      buffer( buffer ),
+      frame( frame ),
+      allocated_length( allocated_length ),
+      current_length( 1 ),
+      flush_on_newline( flush_on_newline )
+   {
+      buffer[ 0 ] = static_cast< char >( channel );
+   }
+
+   // write the buffered characters as a frame, without flushing the link
+   void write_frame(){
+      if( current_length > 1 ){
+         link.write( frame, cobs_encode( buffer, current_length, frame ) );
+         current_length = 1;
+      }
+   }
+
+public:
 
+   /// write a character
    void putc( char c ) override {
-      minion.putc( marker );
-      minion.putc( c );
+      buffer[ current_length++ ] = c;
+      if(
+         ( current_length == allocated_length )
+         || ( flush_on_newline && ( c == '\n' ))
+      ){
+         write_frame();
+      }
+   }
+
+   /// write a block of characters
+   void write( const char * p, size_t n ) override {
+      bool newline = false;
+      while( n > 0 ){
+         size_t k = allocated_length - current_length;
+         if( k > n ){
+            k = n;
+         }
+         for( size_t i = 0; i < k; ++i ){
+            newline = newline || ( p[ i ] == '\n' );
+            buffer[ current_length++ ] = p[ i ];
+         }
+         p += k;
+         n -= k;
+         if( current_length == allocated_length ){
+            write_frame();
+         }
+      }
+      if( newline && flush_on_newline ){
+         write_frame();
+      }
    }
- 
+
+   /// write the buffered characters, and flush the link
    void flush() override {
-      minion.flush();
+      write_frame();
+      link.flush();
    }
 
-}; // class ostream_prefix
+   /// the channel number
+   uint8_t channel() const {
+      return static_cast< uint8_t >( buffer[ 0 ] );
+   }
+
+}; // class ostream_mux_base
 
-class istream_mux : ostream {
+/// concrete multiplexed channel
+///
+/// This is the concrete multiplexed channel class template.
+/// Use it to declare an ostream_mux that sends 
+/// (up to) N characters in a frame.
+/// Use ostream_mux_base for references and parameters.
+template< size_t buffer_length = 64 >
+class ostream_mux : public ostream_mux_base {
 private:
 
-   ostream & minion;
+   char content[ buffer_length + 1 ];
+   char encoded[ cobs_max_length( buffer_length + 1 ) ];
 
 public:
 
-   ostream_mux( ostream & minion ): minion( minion ){}
+   /// create a channel with the specified number, that writes to link
+   ///
+   /// By default a frame is also written when a '\\n' is written.
+   ostream_mux( 
+      ostream & link, 
+      uint8_t channel, 
+      bool flush_on_newline = true 
+   ):
+      ostream_mux_base( 
+         link, channel, content, encoded, 
+         buffer_length + 1, flush_on_newline )
+   {}
 
-   void putc( char x ) override {
-   }
- 
-   void flush() override {
+   /// write the buffered characters
+   ~ostream_mux(){
+      flush();
    }
 
 }; // class ostream_mux
+
+
+// ==========================================================================
+//
+// stream_demux
+//
+// ==========================================================================
+
+/// demultiplexer for a multiplexed serial link
+///
+/// A stream_demux reads COBS-encoded frames (as written by ostream_mux 
+/// objects) from a link (an istream), and stores the characters 
+/// of each frame in the istream_demux for its channel.
+///
+/// Only complete and correctly encoded frames are delivered.
+/// A frame that is too long, that is not correctly encoded,
+/// or that is for a channel that has no istream_demux, is dropped.
+///
+/// Reading from an istream_demux calls poll() when needed,
+/// so the link is read only when an application reads one of 
+/// its channels, or calls poll().
+///
+/// Use stream_demux< N > to declare one,
+/// and stream_demux_base for references.
+class stream_demux_base : public noncopyable {
+private:
+
+   istream & link;
+   char * const frame;
+   const size_t allocated_length;
+   size_t current_length;
+   uint_fast16_t block_code;
+   uint_fast16_t block_remaining;
+   bool discarding;
+   uint_fast32_t dropped;
+   istream_demux_base * first;
+   
+   friend class istream_demux_base;
+   
+   // only stream_demux< N > is allowed to construct
+   // a stream_demux_base
+   template< size_t > friend class stream_demux;
+
+   stream_demux_base( istream & link, char * frame, size_t allocated_length ):
+      link( link ),
+      frame( frame ),
+      allocated_length( allocated_length ),
+      current_length( 0 ),
+      block_code( 0 ),
+      block_remaining( 0 ),
+      discarding( false ),
+      dropped( 0 ),
+      first( nullptr )
+   {}
+   
+   // store a decoded byte
+   void store( char c ){
+      if( current_length == allocated_length ){
+         discarding = true;
+      } else {
+         frame[ current_length++ ] = c;
+      }
+   }
+   
+   // deliver the frame, return whether it was delivered
+   bool deliver();
    
+   // process a byte read from the link, return whether a frame 
+   // was delivered
+   bool decode( char c ){
+      const auto b = static_cast< uint8_t >( c );
+      if( b == 0 ){
+         const bool ok = 
+            ( ! discarding ) && ( block_remaining == 0 ) 
+            && ( current_length > 0 ) && deliver();
+         if( ( ! ok ) && ( ( current_length > 0 ) || discarding ) ){
+            ++dropped;
+         }
+         current_length = 0;
+         block_code = 0;
+         block_remaining = 0;
+         discarding = false;
+         return ok;
+      }
+      if( block_remaining == 0 ){
+      
+         // a code byte: the block before it, if any, 
+         // ended with a 0 unless it was a full block
+         if( ( block_code != 0 ) && ( block_code != 0xFF ) ){
+            store( '\0' );
+         }
+         block_code = b;
+         block_remaining = b - 1;
+      } else {
+         store( c );
+         --block_remaining;
+      }
+      return false;
+   }
+
+public:
+
+   /// read the available characters from the link, 
+   /// return whether a frame was delivered
+   ///
+   /// This function reads characters as long as they are available,
+   /// and stops after a frame has been delivered.
+   bool poll(){
+      while( link.available() ){
+         if( decode( link.get() ) ){
+            return true;
+         }
+      }
+      return false;
+   }
+
+   /// the number of frames that were dropped
+   uint_fast32_t frames_dropped() const {
+      return dropped;
+   }
+
+}; // class stream_demux_base
+
+/// concrete demultiplexer
+///
+/// This is the concrete demultiplexer class template.
+/// Use it to declare a stream_demux that accepts frames of
+/// (up to) N characters.
+/// Use stream_demux_base for references and parameters.
+template< size_t buffer_length = 64 >
+class stream_demux : public stream_demux_base {
+private:
+
+   char content[ buffer_length + 1 ];
+
+public:
+
+   /// create a demultiplexer that reads from link
+   stream_demux( istream & link ):
+      stream_demux_base( link, content, buffer_length + 1 )
+   {}
+
+}; // class stream_demux
+
+
+// ==========================================================================
+//
+// istream_demux
+//
+// ==========================================================================
+
+/// one channel of a demultiplexed serial link
+///
+/// An istream_demux stores the characters of the frames for its channel,
+/// which it gets from a stream_demux.
+/// When it has no character available, it polls the stream_demux.
+/// The characters of a frame that don't fit are lost, 
+/// which is counted.
+///
+/// Use istream_demux< N > to declare one,
+/// and istream_demux_base for references.
+class istream_demux_base : public istream {
+private:
+
+   stream_demux_base & demux;
+   const uint8_t number;
+   char * const buffer;
+   const size_t allocated_length;
+   size_t start;
+   size_t current_length;
+   uint_fast32_t lost;
+   istream_demux_base * next;
+   
+   friend class stream_demux_base;
+
+   // only istream_demux< N > is allowed to construct
+   // an istream_demux_base
+   template< size_t > friend class istream_demux;
+
+   istream_demux_base( 
+      stream_demux_base & demux, 
+      uint8_t number,
+      char * buffer, 
+      size_t allocated_length 
+   ):
+      demux( demux ),
+      number( number ),
+      buffer( buffer ),
+      allocated_length( allocated_length ),
+      start( 0 ),
+      current_length( 0 ),
+      lost( 0 ),
+      next( demux.first )
+   {
+      demux.first = this;
+   }
+
+   ~istream_demux_base(){
+      for( 
+         istream_demux_base **p = &demux.first; 
+         *p != nullptr; 
+         p = &(*p)->next 
+      ){
+         if( (*p) == this ){
+            (*p) = next;
+            return;
+         }
+      }
+   }
+   
+   void store( const char * p, size_t n ){
+      for( size_t i = 0; i < n; ++i ){
+         if( current_length == allocated_length ){
+            lost += n - i;
+            return;
+         }
+         size_t end = start + current_length;
+         if( end >= allocated_length ){
+            end -= allocated_length;
+         }
+         buffer[ end ] = p[ i ];
+         ++current_length;
+      }
+   }
+
+public:
+
+   /// reports whether a character is available
+   ///
+   /// When none is, the stream_demux is polled.
+   bool char_available() override {
+      if( current_length == 0 ){
+         demux.poll();
+      }
+      return current_length > 0;
+   }
+   
+   /// read a character
+   ///
+   /// When no character is available this function 
+   /// polls the stream_demux (and does background work) until
+   /// one is.
+   char getc() override {
+      while( current_length == 0 ){
+         if( ! demux.poll() ){
+            background::do_background_work();
+         }
+      }
+      const char c = buffer[ start ];
+      start = ( start + 1 == allocated_length ) ? 0 : start + 1;
+      --current_length;
+      return c;
+   }
+   
+   /// the channel number
+   uint8_t channel() const {
+      return number;
+   }
+   
+   /// the number of characters that were lost because
+   /// the buffer was full
+   uint_fast32_t characters_lost() const {
+      return lost;
+   }
+
+}; // class istream_demux_base
+
+/// concrete demultiplexed channel
+///
+/// This is the concrete demultiplexed channel class template.
+/// Use it to declare an istream_demux that stores
+/// (up to) N characters.
+/// Use istream_demux_base for references and parameters.
+template< size_t buffer_length = 64 >
+class istream_demux : public istream_demux_base {
+private:
+
+   char content[ buffer_length ];
+
+public:
+
+   /// create a channel with the specified number, that gets
+   /// its characters from demux
+   istream_demux( stream_demux_base & demux, uint8_t channel ):
+      istream_demux_base( demux, channel, content, buffer_length )
+   {}
+
+}; // class istream_demux
+
+
+// ===========================================================================
+//
+// implementations
+//
+// ===========================================================================
+
+#ifdef _HWLIB_ONCE
+
+size_t cobs_encode( const char * p, size_t n, char * out ){
+   size_t code_index = 0;
+   size_t length = 1;
+   uint_fast16_t code = 1;
+   for( size_t i = 0; i < n; ++i ){
+      if( p[ i ] == '\0' ){
+         out[ code_index ] = static_cast< char >( code );
+         code_index = length++;
+         code = 1;
+      } else {
+         out[ length++ ] = p[ i ];
+         if( ++code == 0xFF ){
+            out[ code_index ] = static_cast< char >( code );
+            code_index = length++;
+            code = 1;
+         }
+      }
+   }
+   out[ code_index ] = static_cast< char >( code );
+   out[ length++ ] = '\0';
+   return length;
+}
+
+size_t cobs_decode( const char * p, size_t n, char * out ){
+   if( n == 0 ){
+      return cobs_invalid;
+   }
+   size_t length = 0;
+   size_t i = 0;
+   while( i < n ){
+      const uint_fast16_t code = static_cast< uint8_t >( p[ i++ ] );
+      if( ( code == 0 ) || ( i + code - 1 > n ) ){
+         return cobs_invalid;
+      }
+      for( uint_fast16_t k = 1; k < code; ++k ){
+         if( p[ i ] == '\0' ){
+            return cobs_invalid;
+         }
+         out[ length++ ] = p[ i++ ];
+      }
+      if( ( code != 0xFF ) && ( i < n ) ){
+         out[ length++ ] = '\0';
+      }
+   }
+   return length;
+}
+
+bool stream_demux_base::deliver(){
+   const auto channel = static_cast< uint8_t >( frame[ 0 ] );
+   for( auto p = first; p != nullptr; p = p->next ){
+      if( p->number == channel ){
+         p->store( frame + 1, current_length - 1 );
+         return true;
+      }
+   }
+   return false;
+}
+
+#endif // _HWLIB_ONCE
+
 }; // namespace hwlib
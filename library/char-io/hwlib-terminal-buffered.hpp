@@ -0,0 +1,180 @@
+// ==========================================================================
+//
+// File      : hwlib-terminal-buffered.hpp
+// Part of   : C++ hwlib library for close-to-the-hardware OO programming
+// Copyright : wouter@voti.nl 2017-2019
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at 
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// included only via hwlib.hpp, hence no multiple-include guard is needed
+
+// this file contains Doxygen lines
+/// @file
+
+namespace hwlib {
+
+
+// ==========================================================================
+//
+// terminal_buffered_base
+//
+// ==========================================================================
+
+/// terminal that writes only the changed characters to a terminal
+///
+/// A terminal_buffered stores the characters that are written to it.
+/// flush() writes only the characters that differ from what 
+/// was written to the (slower) terminal it decorates,
+/// and then flushes that terminal.
+/// Adjacent changed characters are written as one cursor_set()
+/// followed by the characters.
+/// A clear() only clears the stored characters.
+///
+/// This is meant for a display that is rewritten completely,
+/// for instance a status screen that is rewritten every second
+/// while only a few digits change: the display gets only
+/// a few cursor moves and characters.
+///
+/// Use terminal_buffered< N > to declare one, 
+/// and terminal_buffered_base for references.
+class terminal_buffered_base : public terminal {
+private:
+
+   terminal & t;
+
+   // the characters that were written to this terminal,
+   // and the characters that were written to t
+   char * wanted;
+   char * shown;
+
+   // whether the characters of t are not known
+   bool unknown;
+
+   // only terminal_buffered< N > is allowed to construct 
+   // a terminal_buffered_base
+   template< int > friend class terminal_buffered;
+
+   terminal_buffered_base( 
+      terminal & t, 
+      xy size, 
+      char * wanted, 
+      char * shown 
+   ):
+      terminal( size ),
+      t( t ),
+      wanted( wanted ),
+      shown( shown ),
+      unknown( true )
+   {
+      clear();
+   }
+
+   void putc_implementation( char c ) override {
+      wanted[ cursor.x + size.x * cursor.y ] = c;
+   }
+
+public:
+
+   void clear() override {
+      for( int_fast16_t i = 0; i < size.x * size.y; ++i ){
+         wanted[ i ] = ' ';
+      }
+      cursor_set( xy( 0, 0 ) );
+   }
+
+   /// write all characters by the next flush()
+   ///
+   /// Call this function when the decorated terminal has been 
+   /// written to directly.
+   void invalidate(){
+      unknown = true;
+   }
+
+   void flush() override;
+
+}; // class terminal_buffered_base
+
+
+// ==========================================================================
+//
+// terminal_buffered< N >
+//
+// ==========================================================================
+
+/// concrete terminal_buffered
+///
+/// This is the concrete terminal_buffered class template.
+/// It stores (at most) max_characters characters, twice.
+/// Its size is the size of the decorated terminal,
+/// with the number of lines limited to what fits in max_characters.
+/// The default 80 is the maximum for a hd44780.
+template< int max_characters = 80 >
+class terminal_buffered : public terminal_buffered_base {
+private:
+
+   char wanted_content[ max_characters ];
+   char shown_content[ max_characters ];
+
+   static xy fitting( const terminal & t ){
+      const auto x = ( t.size.x < max_characters ) ? t.size.x : max_characters;
+      const auto y = ( t.size.y * x <= max_characters ) 
+         ? t.size.y 
+         : max_characters / x;
+      return xy( x, y );
+   }
+
+public:
+
+   /// create a terminal_buffered for a terminal
+   terminal_buffered( terminal & t ):
+      terminal_buffered_base( 
+         t, fitting( t ), wanted_content, shown_content )
+   {}
+
+}; // class terminal_buffered
+
+
+// ===========================================================================
+//
+// implementations
+//
+// ===========================================================================
+
+#ifdef _HWLIB_ONCE
+
+void terminal_buffered_base::flush(){
+   for( int_fast16_t y = 0; y < size.y; ++y ){
+      const auto line = y * size.x;
+      int_fast16_t x = 0;
+      while( x < size.x ){
+         if( ( ! unknown ) && ( wanted[ line + x ] == shown[ line + x ] ) ){
+            ++x;
+            continue;
+         }
+
+         // write the run of changed characters that starts here
+         t.cursor_set( xy( x, y ) );
+         while( 
+            ( x < size.x ) 
+            && ( unknown || ( wanted[ line + x ] != shown[ line + x ] ) )
+         ){
+            t.putc( wanted[ line + x ] );
+            shown[ line + x ] = wanted[ line + x ];
+            ++x;
+         }
+      }
+   }
+   unknown = false;
+   if( t.cursor != cursor ){
+      t.cursor_set( cursor );
+   }
+   t << hwlib::flush;
+}
+
+#endif // _HWLIB_ONCE
+
+}; // namespace hwlib
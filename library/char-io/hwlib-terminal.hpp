@@ -77,7 +77,7 @@ public:
    xy cursor;
 
    /// construct a terminal from its size in characters in x and y direction
-   terminal( xy size ): size( size ){}
+   terminal( xy size ): goto_state( 0 ), size( size ){}
 
    /// put the cursor (write location) at x, y
    virtual void cursor_set( xy target ){
@@ -144,6 +144,16 @@ public:
       }
    }
 
+   /// write a block of characters
+   ///
+   /// This function writes the characters like putc() does,
+   /// without a virtual call per character.
+   void write( const char * s, size_t n ) override {
+      for( size_t i = 0; i < n; ++i ){
+         terminal::putc( s[ i ] );
+      }
+   }
+
    /// clear the terminal
    /// 
    /// This function clears the terminal and puts the cursor at (0,0).
@@ -0,0 +1,190 @@
+// ==========================================================================
+//
+// File      : hwlib-uart-buffered.hpp
+// Part of   : C++ hwlib library for close-to-the-hardware OO programming
+// Copyright : wouter@voti.nl 2017-2019
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at 
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// included only via hwlib.hpp, hence no multiple-include guard is needed
+
+// this file contains Doxygen lines
+/// @file
+
+namespace hwlib {
+
+
+// ==========================================================================
+//
+// uart_buffered
+//
+// ==========================================================================
+
+/// buffered UART 
+///
+/// A uart_buffered is an ostream and an istream that 
+/// puts the characters to be sent in a transmit ring buffer,
+/// and gets the received characters from a receive ring buffer.
+/// Writing only waits when the transmit buffer is full,
+/// so a log line that fits in the buffer costs only the time
+/// to copy it.
+///
+/// The hardware side, which moves the characters between
+/// the buffers and the UART, is implemented by a subclass:
+/// an interrupt service routine, or (on a target without UART
+/// interrupts, or on a native host) background work or a thread.
+/// The ring buffers are lock-free, so the hardware side 
+/// doesn't need to synchronize with the application side:
+///    - the application side calls putc(), write(), 
+///      flush(), char_available() and getc(),
+///    - the hardware side calls tx_get() and rx_put(), 
+///      and implements tx_start().
+///
+/// While waiting (for room in the transmit buffer, or for a
+/// received character) idle() is called, which does background work.
+///
+/// Two targets implement the hardware side:
+///    - the Arduino Due has target::uart_interrupt, which serves
+///      cout and cin when HWLIB_UART_BUFFERED is defined,
+///    - the native target has target::uart_thread, which is used
+///      by the native tests.
+///
+/// The other targets have no hardware side yet: their console
+/// keeps using the polled UART. 
+/// The Due implementation is not compiled by the native tests.
+template< size_t tx_size = 128, size_t rx_size = 64 >
+class uart_buffered : public ostream, public istream {
+private:
+
+   ring_buffer< char, tx_size > tx_buffer;
+   ring_buffer< char, rx_size > rx_buffer;
+   uint_fast32_t rx_lost;
+
+protected:
+
+   /// hardware side: get the next character to transmit
+   ///
+   /// This function returns false when there is none.
+   bool tx_get( char & c ){
+      return tx_buffer.pop( c );
+   }
+
+   /// hardware side: get (up to n) characters to transmit
+   ///
+   /// This function returns the number of characters.
+   size_t tx_get( char * p, size_t n ){
+      return tx_buffer.read( p, n );
+   }
+
+   /// hardware side: store a received character
+   ///
+   /// When the receive buffer is full the character is lost,
+   /// which is counted, and false is returned.
+   bool rx_put( char c ){
+      if( ! rx_buffer.push( c ) ){
+         __atomic_store_n( &rx_lost, rx_lost + 1, __ATOMIC_RELAXED );
+         return false;
+      }
+      return true;
+   }
+   
+   /// hardware side: the number of characters rx_put() will accept
+   size_t rx_room() const {
+      return rx_size - rx_buffer.size();
+   }
+
+   /// hardware side: start transmitting
+   ///
+   /// This function is called (by the application side) after 
+   /// characters have been put in the transmit buffer.
+   /// An interrupt-driven UART enables its transmit interrupt. 
+   /// The default does nothing, which is appropriate when 
+   /// the transmit buffer is polled.
+   virtual void tx_start(){}
+   
+   /// application side: wait a little
+   ///
+   /// This function is called while the application side waits for
+   /// the hardware side. The default does background work.
+   virtual void idle(){
+      background::do_background_work();
+   }
+
+public:
+
+   /// create a buffered UART with empty buffers
+   uart_buffered():
+      rx_lost( 0 )
+   {}
+
+   /// write a character
+   ///
+   /// When the transmit buffer is full this function waits.
+   void putc( char c ) override {
+      while( ! tx_buffer.push( c ) ){
+         tx_start();
+         idle();
+      }
+      tx_start();
+   }
+
+   /// write a block of characters
+   ///
+   /// When the transmit buffer is full this function waits.
+   void write( const char * p, size_t n ) override {
+      for(;;){
+         const auto done = tx_buffer.write( p, n );
+         tx_start();
+         if( done == n ){
+            return;
+         }
+         p += done;
+         n -= done;
+         idle();
+      }
+   }
+
+   /// wait until all characters have been taken by the hardware side
+   ///
+   /// The last character(s) might still be in the UART hardware.
+   void flush() override {
+      while( ! tx_buffer.empty() ){
+         tx_start();
+         idle();
+      }
+   }
+
+   /// reports whether a received character is available
+   bool char_available() override {
+      return ! rx_buffer.empty();
+   }
+
+   /// read a character
+   ///
+   /// When no character has been received this function waits.
+   char getc() override {
+      char c;
+      while( ! rx_buffer.pop( c ) ){
+         idle();
+      }
+      return c;
+   }
+   
+   /// the number of characters in the transmit buffer
+   size_t tx_pending() const {
+      return tx_buffer.size();
+   }
+
+   /// the number of received characters lost because 
+   /// the receive buffer was full
+   uint_fast32_t rx_overruns() const {
+      return __atomic_load_n( &rx_lost, __ATOMIC_RELAXED );
+   }
+
+}; // class uart_buffered
+
+}; // namespace hwlib
@@ -75,7 +75,7 @@ namespace hwlib {
 ///
 /// This must be done by a macro 
 /// because Doxygen can't handle __attribute__.
-#define HWLIB_NOINLINE __attribute__((never_inline))
+#define HWLIB_NOINLINE __attribute__((noinline))
    
 /// \cond INTERNAL 
 #define HWLIB_STRINGYFY( X ) #X
@@ -0,0 +1,183 @@
+// ==========================================================================
+//
+// File      : hwlib-ring-buffer.hpp
+// Part of   : C++ hwlib library for close-to-the-hardware OO programming
+// Copyright : wouter@voti.nl 2017-2019
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at 
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// included only via hwlib.hpp, hence no multiple-include guard is needed
+
+// this file contains Doxygen lines
+/// @file
+
+namespace hwlib {
+
+
+// ==========================================================================
+//
+// ring_buffer
+//
+// ==========================================================================
+
+/// single-producer single-consumer lock-free ring buffer
+///
+/// A ring_buffer< T, N > stores (up to) N elements of type T.
+/// It is meant to pass data between two contexts, for instance
+/// between an interrupt service routine and the main code, or
+/// between two threads, without disabling interrupts or locking.
+///
+/// One context (the producer) calls push() and write(), 
+/// the other context (the consumer) calls pop() and read(). 
+/// The producer updates only the head, the consumer only the tail.
+/// Each publishes its update with a release store, 
+/// after it has written (or read) the elements, 
+/// and reads the other index with an acquire load.
+///
+/// The indexes are bytes when N < 255 (they count up to N), 
+/// so on an 8-bit target they are read and written in one instruction.
+template< typename T, size_t N >
+class ring_buffer : public noncopyable {
+private:
+
+   static_assert( N > 0, "a ring_buffer must have room for an element" );
+
+   using index_t = typename std::conditional< 
+      ( N < 255 ), uint8_t, uint_fast16_t >::type;
+   
+   static_assert( N < 65'535, "a ring_buffer must be smaller" );
+
+   // one element is never used, to distinguish full from empty
+   static constexpr index_t length = N + 1;
+
+   T elements[ length ];
+   index_t head;
+   index_t tail;
+   
+   static index_t next( index_t i ){
+      return ( i + 1 == length ) ? 0 : i + 1;
+   }
+   
+   static index_t load( const index_t & i ){
+      return __atomic_load_n( &i, __ATOMIC_ACQUIRE );
+   }
+
+   static void store( index_t & i, index_t x ){
+      __atomic_store_n( &i, x, __ATOMIC_RELEASE );
+   }
+
+public:
+
+   /// create an empty ring buffer
+   constexpr ring_buffer():
+      elements{}, head( 0 ), tail( 0 )
+   {}
+
+   /// the maximum number of elements
+   static constexpr size_t max_size(){
+      return N;
+   }
+   
+   /// the number of elements currently stored
+   ///
+   /// This is exact when called from the producer or the consumer
+   /// while the other context doesn't change the buffer,
+   /// otherwise it is a snapshot.
+   size_t size() const {
+      const index_t h = load( head );
+      const index_t t = load( tail );
+      return ( h >= t ) ? h - t : h + length - t;
+   }
+
+   /// reports whether the buffer is empty
+   bool empty() const {
+      return load( head ) == load( tail );
+   }
+
+   /// reports whether the buffer is full
+   bool full() const {
+      return next( load( head ) ) == load( tail );
+   }
+   
+   /// producer: add an element, return whether it was added
+   ///
+   /// When the buffer is full the element is not added.
+   bool push( const T & x ){
+      const index_t h = head;
+      const index_t n = next( h );
+      if( n == load( tail ) ){
+         return false;
+      }
+      elements[ h ] = x;
+      store( head, n );
+      return true;
+   }
+   
+   /// producer: add elements, return the number that was added
+   ///
+   /// The elements that fit are added, and made visible 
+   /// to the consumer at once.
+   size_t write( const T * p, size_t n ){
+      const index_t t = load( tail );
+      const index_t h = head;
+      const size_t room = ( t > h ) ? t - h - 1 : length - h + t - 1;
+      if( n > room ){
+         n = room;
+      }
+      
+      // copy up to the end of the array, and the rest from its start
+      const size_t first = ( n < size_t( length - h ) ) ? n : length - h;
+      for( size_t i = 0; i < first; ++i ){
+         elements[ h + i ] = p[ i ];
+      }
+      for( size_t i = first; i < n; ++i ){
+         elements[ i - first ] = p[ i ];
+      }
+      const size_t next_h = h + n;
+      store( head, static_cast< index_t >( 
+         ( next_h >= length ) ? next_h - length : next_h ) );
+      return n;
+   }
+   
+   /// consumer: remove the oldest element, return whether there was one
+   bool pop( T & x ){
+      const index_t t = tail;
+      if( t == load( head ) ){
+         return false;
+      }
+      x = elements[ t ];
+      store( tail, next( t ) );
+      return true;
+   }
+   
+   /// consumer: remove elements, return the number that was removed
+   ///
+   /// At most n of the oldest elements are removed, 
+   /// and their space is made available to the producer at once.
+   size_t read( T * p, size_t n ){
+      const index_t h = load( head );
+      const index_t t = tail;
+      const size_t available = ( h >= t ) ? h - t : length - t + h;
+      if( n > available ){
+         n = available;
+      }
+      const size_t first = ( n < size_t( length - t ) ) ? n : length - t;
+      for( size_t i = 0; i < first; ++i ){
+         p[ i ] = elements[ t + i ];
+      }
+      for( size_t i = first; i < n; ++i ){
+         p[ i ] = elements[ i - first ];
+      }
+      const size_t next_t = t + n;
+      store( tail, static_cast< index_t >( 
+         ( next_t >= length ) ? next_t - length : next_t ) );
+      return n;
+   }
+
+}; // class ring_buffer
+
+}; // namespace hwlib
@@ -206,7 +206,7 @@ private:
       uint8_t data_in[] 
    ) override {
 
-      for( uint_fast8_t i = 0; i < n; ++i ){
+      for( size_t i = 0; i < n; ++i ){
           
          uint_fast8_t d = 
             ( data_out == nullptr )
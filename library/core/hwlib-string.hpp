@@ -100,6 +100,17 @@ private:
          : content + current_length;
    }
    
+   // write the string to an ostream, or to another target
+   void write_to( ostream & lhs, std::true_type ) const {
+      lhs.write( content, current_length );
+   }
+   template< typename T > 
+   void write_to( T & lhs, std::false_type ) const {
+      for( size_t i = 0; i < current_length; ++i ){
+         lhs << content[ i ];
+      }   
+   }
+   
    // object constructor, called by string< N >'s constructors
    template< typename T > 
    constexpr string_base( size_t allocated_length, char * content, const T & x ):
@@ -192,11 +203,11 @@ public:
    }
      
    /// output to any target that supports operator<< for a char *
+   ///
+   /// An ostream gets the whole string in a single write() call.
    template< typename T >
    friend T & operator<< ( T & lhs, const string_base & rhs ){
-      for( char c : rhs ){
-         lhs << c;
-      }   
+      rhs.write_to( lhs, std::is_base_of< ostream, T >() );
       return lhs;
    }     
    
@@ -98,7 +98,115 @@ public:
       return xy( rhs.y, rhs.x );      
    }      
 
-}; 
+};
+
+
+// ==========================================================================
+//
+// box
+//
+// ==========================================================================
+
+/// an xy-aligned rectangular area
+///
+/// This class abstracts a rectangular area of pixel (or character)
+/// locations, for instance the part of a window that must be redrawn.
+/// The start is the top-left location, which is part of the box.
+/// The end is the location just beyond the bottom-right location,
+/// which is not part of the box.
+/// A box that contains no locations is empty.
+class box final {
+private:
+
+   static constexpr int_fast16_t min( int_fast16_t a, int_fast16_t b ){
+      return a < b ? a : b;
+   }
+
+   static constexpr int_fast16_t max( int_fast16_t a, int_fast16_t b ){
+      return a > b ? a : b;
+   }
+
+public:
+
+   /// the top-left location (inclusive)
+   xy start;
+
+   /// the bottom-right location (exclusive)
+   xy end;
+
+   /// construct from its start (inclusive) and end (exclusive) locations
+   constexpr box( xy start, xy end ): start{ start }, end{ end }{}
+
+   /// default constructor, creates an empty box
+   constexpr box(): start{}, end{}{}
+
+   /// report whether the box contains no locations
+   constexpr bool is_empty() const {
+      return ( end.x <= start.x ) || ( end.y <= start.y );
+   }
+
+   /// the size of the box
+   constexpr xy size() const {
+      return is_empty() ? xy( 0, 0 ) : end - start;
+   }
+
+   /// report whether a location is inside the box
+   constexpr bool contains( xy pos ) const {
+      return ( pos.x >= start.x ) && ( pos.x < end.x )
+          && ( pos.y >= start.y ) && ( pos.y < end.y );
+   }
+
+   /// the smallest box that contains both boxes
+   ///
+   /// An empty box doesn't contribute to the result.
+   constexpr box operator|( const box & rhs ) const {
+      return is_empty()
+         ? rhs
+         : ( rhs.is_empty()
+            ? *this
+            : box(
+               xy( min( start.x, rhs.start.x ), min( start.y, rhs.start.y ) ),
+               xy( max( end.x, rhs.end.x ), max( end.y, rhs.end.y ) ) ) );
+   }
+
+   /// the part that is in both boxes
+   ///
+   /// When the boxes don't overlap the result is empty.
+   constexpr box operator&( const box & rhs ) const {
+      return box(
+         xy( max( start.x, rhs.start.x ), max( start.y, rhs.start.y ) ),
+         xy( min( end.x, rhs.end.x ), min( end.y, rhs.end.y ) ) );
+   }
+
+   /// report whether the boxes have at least one location in common
+   constexpr bool overlaps( const box & rhs ) const {
+      return ! ( *this & rhs ).is_empty();
+   }
+
+   /// the box, moved by an offset
+   constexpr box operator+( const xy rhs ) const {
+      return box( start + rhs, end + rhs );
+   }
+
+   /// test whether two boxes are equal
+   constexpr bool operator==( const box & rhs ) const {
+      return ( start == rhs.start ) && ( end == rhs.end );
+   }
+
+   /// test whether two boxes are unequal
+   constexpr bool operator!=( const box & rhs ) const {
+      return ! ( *this == rhs );
+   }
+
+};
+
+/// a box that contains all possible locations
+///
+/// This is for instance the bounding box of a drawable
+/// that doesn't know its own extent.
+constexpr box box_all = box(
+   xy( INT_FAST16_MIN / 2, INT_FAST16_MIN / 2 ),
+   xy( INT_FAST16_MAX / 2, INT_FAST16_MAX / 2 ) );
 
 
 // ==========================================================================
@@ -185,6 +293,16 @@ T & operator<<( T & lhs, xy rhs ){
    return lhs << "[" << rhs.x << ":" << rhs.y << "]";
 }
 
+/// print a box
+///
+/// A box is printed in [x,y]-[x,y] format
+///
+/// \relates box
+template< typename T >
+T & operator<<( T & lhs, const box & rhs ){
+   return lhs << rhs.start << "-" << rhs.end;
+}
+
 
 // ===========================================================================
 //
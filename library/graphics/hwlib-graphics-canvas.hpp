@@ -27,7 +27,7 @@ private:
        buffer[ pos.x ][ pos.y ] = col;
    }    
    
-   color get_implementation( xy pos ) const override {
+   color read_implementation( xy pos ) const override {
        return buffer[ pos.x ][ pos.y ];
    }
    
@@ -54,22 +54,29 @@ template< int size_x, int size_y >
 class canvas_bw : public window, private image  {
 private:
 
-   uint8_t buffer[ ( size_x + 7 ) / 8 ][ size_y ];
+   static constexpr int_fast16_t stride = ( size_x + 7 ) / 8;
+
+   uint8_t buffer[ size_y ][ stride ];
     
    void write_implementation( xy pos, color col ) override {
-       uint8_t & b = buffer[ pos.x / 8 ][ pos.y ];
+       uint8_t & b = buffer[ pos.y ][ pos.x / 8 ];
        if( col == foreground ){
-          b |= ( 0b1 << pos.y % 8 );
+          b |= ( 0b1 << pos.x % 8 );
        } else {
-          b &= ~ ( 0b1 << pos.y % 8 );
+          b &= ~ ( 0b1 << pos.x % 8 );
        }          
    }    
    
    color read_implementation( xy pos ) const override {
-       return buffer[ pos.x ][ pos.y ]
+       return ( buffer[ pos.y ][ pos.x / 8 ] & ( 0b1 << pos.x % 8 ) )
           ? foreground
           : background;
    }
+
+   bool packed( image_bits & layout ) const override {
+       layout = image_bits{ & buffer[ 0 ][ 0 ], stride, background, foreground };
+       return true;
+   }
    
 public:
 
@@ -0,0 +1,439 @@
+// ==========================================================================
+//
+// File      : hwlib-graphics-compositor.hpp
+// Part of   : C++ hwlib library for close-to-the-hardware OO programming
+// Copyright : wouter@voti.nl 2017-2019
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// included only via hwlib.hpp, hence no multiple-include guard is needed
+
+// this file contains Doxygen lines
+/// @file
+
+namespace hwlib {
+
+
+// ==========================================================================
+//
+// layer_base
+//
+// ==========================================================================
+
+/// a window that is shown by a compositor, on top of other layers
+///
+/// A layer is a window that stores its pixels in memory.
+/// A compositor shows it, at its offset, in its output window.
+/// Where a pixel of a layer is transparent, the layers below it
+/// (or the background of the output window) are shown.
+///
+/// The background color of a layer is transparent by default,
+/// so clear() makes the whole layer transparent.
+/// Unlike for other windows, clear( transparent ) and erase()
+/// make pixels transparent.
+///
+/// A layer keeps track of the areas that have been written since
+/// the compositor last showed it.
+/// The flush() of a layer has no effect: call the flush() of the
+/// compositor to update the output window.
+///
+/// Use layer< size_x, size_y > to declare a layer,
+/// and layer_base for references.
+class layer_base : public window {
+private:
+
+   color * const pixels;
+   xy current_offset;
+   bool visible;
+
+   // the areas (in layer coordinates) that were written
+   // since the compositor last showed the layer
+   damage_set damage;
+
+   // the area (in output coordinates) that the compositor showed
+   box shown;
+
+   friend class compositor_base;
+
+   // only layer< X, Y > is allowed to construct a layer_base
+   template< int, int > friend class layer;
+
+   layer_base(
+      xy size,
+      color * pixels,
+      xy offset,
+      color foreground,
+      color background
+   ):
+      window( size, foreground, background ),
+      pixels( pixels ),
+      current_offset( offset ),
+      visible( true )
+   {}
+
+   color & at( xy pos ){
+      return pixels[ pos.x + size.x * pos.y ];
+   }
+
+   // write a color, which can be transparent, to an area
+   void fill( const box & area, color col );
+
+   void write_implementation( xy pos, color col ) override {
+      at( pos ) = col;
+      damage.add( box( pos, pos + xy( 1, 1 ) ) );
+   }
+
+   void write_span_implementation(
+      xy pos,
+      int_fast16_t n,
+      color col
+   ) override {
+      auto p = & at( pos );
+      for( int_fast16_t i = 0; i < n; ++i ){
+         p[ i ] = col;
+      }
+      damage.add( box( pos, pos + xy( n, 1 ) ) );
+   }
+
+public:
+
+   /// read a pixel
+   ///
+   /// A pixel that was not written since the last clear() or erase()
+   /// is transparent (unless the background color is not transparent).
+   color read( xy pos ) const {
+      return pixels[ pos.x + size.x * pos.y ];
+   }
+
+   /// clear the layer
+   ///
+   /// This function writes the specified color, which can be
+   /// transparent, to all pixels of the layer.
+   /// When no color is specified, the background color is used.
+   void clear( color col = unspecified ) override {
+      fill( box( xy( 0, 0 ), size ), col.specify( background ) );
+   }
+
+   /// make an area of the layer transparent
+   void erase( const box & area ){
+      fill( area, transparent );
+   }
+
+   /// the location of the top-left pixel of the layer in the output window
+   xy offset() const {
+      return current_offset;
+   }
+
+   /// move the layer to a new location in the output window
+   void move_to( xy offset ){
+      current_offset = offset;
+   }
+
+   /// show or hide the layer
+   void show( bool show = true ){
+      visible = show;
+   }
+
+   /// report whether the layer is shown
+   bool is_visible() const {
+      return visible;
+   }
+
+   /// the flush() of a layer has no effect
+   void flush() override {}
+
+}; // class layer_base
+
+
+// ==========================================================================
+//
+// layer< size_x, size_y >
+//
+// ==========================================================================
+
+/// concrete layer
+///
+/// This is the concrete layer class template.
+/// It stores a color (4 bytes) for each pixel.
+/// Use layer_base for references and parameters.
+template< int size_x, int size_y >
+class layer : public layer_base {
+private:
+
+   color content[ size_x * size_y ];
+
+public:
+
+   /// create a layer, at an offset in the output window
+   ///
+   /// The background color is transparent by default, hence the
+   /// initial layer is transparent.
+   layer(
+      xy offset = xy( 0, 0 ),
+      color foreground = white,
+      color background = transparent
+   ):
+      layer_base(
+         xy( size_x, size_y ), content, offset, foreground, background )
+   {
+      // not in the layer_base constructor: the content is 
+      // (default) constructed after that
+      fill( box( xy( 0, 0 ), size ), background );
+   }
+
+}; // class layer
+
+
+// ==========================================================================
+//
+// compositor_base
+//
+// ==========================================================================
+
+/// shows a stack of layers in a window
+///
+/// A compositor shows its layers in its output window.
+/// The order in which the layers are added is the z-order:
+/// a layer that is added later is shown on top of the earlier ones.
+/// Where no layer has a (non-transparent) pixel,
+/// the background color of the output window is shown.
+///
+/// The flush() of the compositor updates only the areas of the output
+/// window that have changed: the areas that were written in each layer,
+/// and the old and new area of a layer that was added, removed,
+/// moved, shown or hidden.
+/// These areas are rounded to tiles (of 8 x 8 pixels by default),
+/// and a small number of rectangles of tiles is updated.
+/// Hence a small overlay like a cursor, a popup or a status bar costs
+/// only its own area, not a redraw of what lies underneath.
+///
+/// The updated areas are written row by row,
+/// with runs of equal pixels written as a single span.
+///
+/// Use compositor< N > to declare a compositor that can hold
+/// (up to) N layers, and compositor_base for references.
+class compositor_base : public noncopyable {
+private:
+
+   window & w;
+   layer_base ** const layers;
+   const size_t allocated_length;
+   size_t current_length;
+   const int_fast16_t tile;
+
+   damage_set damage;
+
+   // only compositor< N > is allowed to construct a compositor_base
+   template< size_t > friend class compositor;
+
+   compositor_base(
+      window & w,
+      layer_base ** layers,
+      size_t allocated_length,
+      int_fast16_t tile
+   ):
+      w( w ),
+      layers( layers ),
+      allocated_length( allocated_length ),
+      current_length( 0 ),
+      tile( tile )
+   {}
+
+   // the area (in output coordinates) that a layer occupies now
+   static box occupied( const layer_base & l ){
+      return l.visible
+         ? box( l.current_offset, l.current_offset + l.size )
+         : box();
+   }
+
+   // add an area (in output coordinates), rounded to whole tiles
+   void add_damage( const box & b );
+
+   // write the composed pixels of an area to the output window
+   void compose( const box & area );
+
+public:
+
+   /// add a layer on top of the others
+   ///
+   /// A layer that doesn't fit in the compositor is ignored.
+   void add( layer_base & l ){
+      if( current_length < allocated_length ){
+         layers[ current_length++ ] = & l;
+         l.damage.clear();
+         l.shown = occupied( l );
+         add_damage( l.shown );
+      }
+   }
+
+   /// remove a layer
+   ///
+   /// The area that was covered by the layer will be updated
+   /// by the next flush().
+   void remove( layer_base & l ){
+      for( size_t i = 0; i < current_length; ++i ){
+         if( layers[ i ] == & l ){
+            add_damage( l.shown );
+            for( size_t j = i + 1; j < current_length; ++j ){
+               layers[ j - 1 ] = layers[ j ];
+            }
+            --current_length;
+            return;
+         }
+      }
+   }
+
+   /// the number of layers
+   size_t length() const {
+      return current_length;
+   }
+
+   /// mark the whole window for updating
+   void invalidate(){
+      add_damage( box( xy( 0, 0 ), w.size ) );
+   }
+
+   /// mark an area of the window for updating
+   void invalidate( const box & area ){
+      add_damage( area );
+   }
+
+   /// update the window
+   ///
+   /// This function writes the changed areas of the layers
+   /// to the output window, and flushes the output window.
+   void flush();
+
+}; // class compositor_base
+
+
+// ==========================================================================
+//
+// compositor< N >
+//
+// ==========================================================================
+
+/// concrete compositor
+///
+/// This is the concrete compositor class template.
+/// Use it to declare a compositor that can hold (up to) N layers.
+/// Use compositor_base for references and parameters.
+template< size_t maximum_length >
+class compositor : public compositor_base {
+private:
+
+   // the store for the layer references
+   layer_base * content[ maximum_length ];
+
+public:
+
+   /// create an empty compositor for a window
+   ///
+   /// The changed areas are updated in whole tiles
+   /// of tile x tile pixels.
+   compositor( window & w, int_fast16_t tile = 8 ):
+      compositor_base( w, content, maximum_length, tile )
+   {}
+
+}; // class compositor
+
+
+// ===========================================================================
+//
+// implementations
+//
+// ===========================================================================
+
+#ifdef _HWLIB_ONCE
+
+void layer_base::fill( const box & area, color col ){
+   const auto b = area & box( xy( 0, 0 ), size );
+   if( b.is_empty() ){
+      return;
+   }
+   for( int_fast16_t y = b.start.y; y < b.end.y; ++y ){
+      auto p = & at( xy( b.start.x, y ) );
+      for( int_fast16_t x = b.start.x; x < b.end.x; ++x ){
+         *p++ = col;
+      }
+   }
+   damage.add( b );
+}
+
+void compositor_base::add_damage( const box & b ){
+   const auto clipped = b & box( xy( 0, 0 ), w.size );
+   if( clipped.is_empty() ){
+      return;
+   }
+   const auto start = xy(
+      ( clipped.start.x / tile ) * tile,
+      ( clipped.start.y / tile ) * tile );
+   const auto end = xy(
+      ( ( clipped.end.x + tile - 1 ) / tile ) * tile,
+      ( ( clipped.end.y + tile - 1 ) / tile ) * tile );
+   damage.add( box( start, end ) & box( xy( 0, 0 ), w.size ) );
+}
+
+void compositor_base::compose( const box & area ){
+   for( int_fast16_t y = area.start.y; y < area.end.y; ++y ){
+      int_fast16_t first = area.start.x;
+      color run = transparent;
+      for( int_fast16_t x = area.start.x; x < area.end.x; ++x ){
+
+         // the topmost non-transparent pixel of a visible layer
+         auto col = w.background;
+         for( size_t i = current_length; i > 0; --i ){
+            const auto & l = *layers[ i - 1 ];
+            const auto pos = xy( x, y ) - l.current_offset;
+            if(
+               l.visible
+               && ( pos.x >= 0 ) && ( pos.x < l.size.x )
+               && ( pos.y >= 0 ) && ( pos.y < l.size.y )
+            ){
+               const auto c = l.read( pos );
+               if( ! c.is_transparent() ){
+                  col = c;
+                  break;
+               }
+            }
+         }
+
+         if( col != run ){
+            w.write_span( xy( first, y ), x - first, run );
+            first = x;
+            run = col;
+         }
+      }
+      w.write_span( xy( first, y ), area.end.x - first, run );
+   }
+}
+
+void compositor_base::flush(){
+   for( size_t i = 0; i < current_length; ++i ){
+      auto & l = *layers[ i ];
+      const auto now = occupied( l );
+      if( now != l.shown ){
+         add_damage( l.shown );
+         add_damage( now );
+         l.shown = now;
+      } else if( l.visible ){
+         for( size_t j = 0; j < l.damage.length; ++j ){
+            add_damage( l.damage.boxes[ j ] + l.current_offset );
+         }
+      }
+      l.damage.clear();
+   }
+   for( size_t i = 0; i < damage.length; ++i ){
+      compose( damage.boxes[ i ] );
+   }
+   damage.clear();
+   w.flush();
+}
+
+#endif // _HWLIB_ONCE
+
+}; // namespace hwlib
@@ -0,0 +1,283 @@
+// ==========================================================================
+//
+// File      : hwlib-graphics-display-list.hpp
+// Part of   : C++ hwlib library for close-to-the-hardware OO programming
+// Copyright : wouter@voti.nl 2017-2019
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// included only via hwlib.hpp, hence no multiple-include guard is needed
+
+// this file contains Doxygen lines
+/// @file
+
+namespace hwlib {
+
+
+// ==========================================================================
+//
+// damage_set
+//
+// ==========================================================================
+
+/// \cond INTERNAL
+
+// a small number of boxes that together cover the areas that have changed
+//
+// When more areas have changed, the boxes are merged,
+// which can cause some unchanged locations to be covered.
+class damage_set {
+public:
+
+   // the maximum number of separate changed areas
+   static constexpr size_t max_length = 4;
+
+   box boxes[ max_length ];
+   size_t length = 0;
+
+   static int_fast32_t surface( const box & b ){
+      const auto s = b.size();
+      return static_cast< int_fast32_t >( s.x ) * s.y;
+   }
+
+   // add an area
+   void add( const box & b ){
+      if( b.is_empty() ){
+         return;
+      }
+
+      // merge with an area it overlaps
+      for( size_t i = 0; i < length; ++i ){
+         if( boxes[ i ].overlaps( b ) ){
+            boxes[ i ] = boxes[ i ] | b;
+            return;
+         }
+      }
+
+      // use a free slot
+      if( length < max_length ){
+         boxes[ length++ ] = b;
+         return;
+      }
+
+      // merge with the area that grows the least
+      size_t best = 0;
+      int_fast32_t best_growth = INT_FAST32_MAX;
+      for( size_t i = 0; i < length; ++i ){
+         const auto growth = surface( boxes[ i ] | b ) - surface( boxes[ i ] );
+         if( growth < best_growth ){
+            best = i;
+            best_growth = growth;
+         }
+      }
+      boxes[ best ] = boxes[ best ] | b;
+   }
+
+   void clear(){
+      length = 0;
+   }
+
+}; // class damage_set
+
+/// \endcond
+
+
+// ==========================================================================
+//
+// display_list_base
+//
+// ==========================================================================
+
+/// retained collection of drawables
+///
+/// A display list holds references to drawable objects that are shown
+/// in a window.
+/// The order in which the objects are added is the z-order:
+/// an object that is added later is drawn on top of the earlier ones.
+///
+/// The display list remembers the area (bounding box) that each object
+/// covered when it was last drawn.
+/// When an object has changed (it is marked dirty, or its bounding box
+/// is different) flush() erases its old and its new area,
+/// and redraws (in z-order) only the objects that overlap those areas.
+/// Hence the cost of a flush depends on the size of what has changed,
+/// not on the number of objects in the list.
+///
+/// The changed areas are collected in a small number of boxes.
+/// When more areas have changed, the boxes are merged,
+/// which can cause some unchanged pixels to be redrawn.
+///
+/// An object that is changed by assigning to its attributes must be
+/// marked by calling its changed() function,
+/// unless the change affects its bounding box.
+///
+/// The display list itself is a drawable: its draw() draws all
+/// objects, in z-order, into any window.
+///
+/// Use display_list< N > to declare a display list that can hold
+/// (up to) N objects, and display_list_base for references.
+class display_list_base : public drawable {
+private:
+
+   // an object, and the area it covered when it was last drawn
+   struct entry {
+      drawable * item;
+      box drawn;
+   };
+
+   window & w;
+   entry * const entries;
+   const size_t allocated_length;
+   size_t current_length;
+
+   damage_set damage;
+
+   // only display_list< N > is allowed to construct a display_list_base
+   template< size_t > friend class display_list;
+
+   display_list_base( window & w, entry * entries, size_t allocated_length ):
+      drawable( xy( 0, 0 ) ),
+      w( w ),
+      entries( entries ),
+      allocated_length( allocated_length ),
+      current_length( 0 )
+   {}
+
+   // add an area to the areas that must be redrawn
+   void add_damage( const box & b ){
+      damage.add( b & box( xy( 0, 0 ), w.size ) );
+   }
+
+   // erase an area, and redraw the objects that overlap it
+   void redraw( const box & area ){
+      for( int_fast16_t y = area.start.y; y < area.end.y; ++y ){
+         w.write_span( xy( area.start.x, y ), area.size().x, w.background );
+      }
+      auto clipped = clip( w, area );
+      for( size_t i = 0; i < current_length; ++i ){
+         if( entries[ i ].drawn.overlaps( area ) ){
+            entries[ i ].item->draw( clipped );
+         }
+      }
+   }
+
+public:
+
+   /// add an object on top of the others
+   ///
+   /// An object that doesn't fit in the list is ignored.
+   void add( drawable & d ){
+      if( current_length < allocated_length ){
+         entries[ current_length++ ] = entry{ & d, box() };
+         d.changed();
+      }
+   }
+
+   /// remove an object
+   ///
+   /// The area that was covered by the object will be redrawn
+   /// by the next flush().
+   void remove( drawable & d ){
+      for( size_t i = 0; i < current_length; ++i ){
+         if( entries[ i ].item == & d ){
+            add_damage( entries[ i ].drawn );
+            for( size_t j = i + 1; j < current_length; ++j ){
+               entries[ j - 1 ] = entries[ j ];
+            }
+            --current_length;
+            return;
+         }
+      }
+   }
+
+   /// the number of objects in the list
+   size_t length() const {
+      return current_length;
+   }
+
+   /// mark the whole window for redrawing
+   ///
+   /// The next flush() will erase and redraw the whole window.
+   void invalidate(){
+      add_damage( box( xy( 0, 0 ), w.size ) );
+   }
+
+   /// mark an area of the window for redrawing
+   void invalidate( const box & area ){
+      add_damage( area );
+   }
+
+   /// update the window
+   ///
+   /// This function erases and redraws the areas of the window
+   /// that are affected by objects that have changed, and flushes
+   /// the window.
+   void flush(){
+      for( size_t i = 0; i < current_length; ++i ){
+         auto & e = entries[ i ];
+         const auto now = e.item->bounding_box();
+         if( e.item->dirty || ( now != e.drawn ) ){
+            add_damage( e.drawn );
+            add_damage( now );
+            e.drawn = now;
+            e.item->dirty = false;
+         }
+      }
+      for( size_t i = 0; i < damage.length; ++i ){
+         redraw( damage.boxes[ i ] );
+      }
+      damage.clear();
+      w.flush();
+   }
+
+   /// draw all objects, in z-order
+   void draw( window & target ) override {
+      for( size_t i = 0; i < current_length; ++i ){
+         entries[ i ].item->draw( target );
+      }
+   }
+
+   /// the area covered by all objects
+   box bounding_box() const override {
+      box result;
+      for( size_t i = 0; i < current_length; ++i ){
+         result = result | entries[ i ].item->bounding_box();
+      }
+      return result;
+   }
+
+}; // class display_list_base
+
+
+// ==========================================================================
+//
+// display_list< N >
+//
+// ==========================================================================
+
+/// concrete display list
+///
+/// This is the concrete display list class template.
+/// Use it to declare a display list that can hold (up to) N objects.
+/// Use display_list_base for references and parameters.
+template< size_t maximum_length >
+class display_list : public display_list_base {
+private:
+
+   // the store for the entries
+   entry content[ maximum_length ];
+
+public:
+
+   /// create an empty display list for a window
+   display_list( window & w ):
+      display_list_base( w, content, maximum_length )
+   {}
+
+}; // class display_list
+
+}; // namespace hwlib
@@ -30,8 +30,15 @@ public:
    /// the location where the object is drawn
    xy start;
 
+   /// whether the object has changed since it was last drawn
+   ///
+   /// This flag is used by a display_list to find the objects
+   /// that must be redrawn. It is set by the constructor,
+   /// by changed() and by move_to().
+   bool dirty;
+
    /// create a drawable object by supplying its (initial) location
-   drawable( xy start ): start{ start }{}
+   drawable( xy start ): start{ start }, dirty{ true }{}
 
    /// \brief
    /// interface to draw the object buffered
@@ -40,7 +47,36 @@ public:
    ///
    /// If buffering is specified, the actual drawing can be delayed
    /// until flush() is called.
-   virtual void draw( window & w ) = 0;    
+   virtual void draw( window & w ) = 0;
+
+   /// the area that is covered by the object
+   ///
+   /// When the object is drawn, it writes only to pixels inside
+   /// this box.
+   /// The default returns box_all, which means that the extent
+   /// is unknown.
+   /// A concrete drawable should provide a tighter box.
+   virtual box bounding_box() const {
+      return box_all;
+   }
+
+   /// mark the object as changed
+   ///
+   /// Call this function after an attribute of the object has
+   /// been changed, to make a display_list redraw it.
+   void changed(){
+      dirty = true;
+   }
+
+   /// move the object to a new location
+   ///
+   /// The whole object is moved: its shape and size don't change.
+   /// A drawable that stores more locations than start
+   /// must override this function to move them too.
+   virtual void move_to( xy pos ){
+      start = pos;
+      dirty = true;
+   }
 
 }; // class drawable
 
@@ -133,6 +169,15 @@ public:
       }
    }
    
+   box bounding_box() const override {
+      return box( start, start + xy( 1, 1 ) ) | box( end, end + xy( 1, 1 ) );
+   }
+   
+   void move_to( xy pos ) override {
+      end = end + ( pos - start );
+      drawable::move_to( pos );
+   }
+   
 }; // class line   
 
 
@@ -166,6 +211,15 @@ public:
          xy( start.x, end.y   ), xy( end.x + 1, end.y     ), ink ).draw( w );
    }
 
+   box bounding_box() const override {
+      return box( start, start + xy( 1, 1 ) ) | box( end, end + xy( 1, 1 ) );
+   }
+
+   void move_to( xy pos ) override {
+      end = end + ( pos - start );
+      drawable::move_to( pos );
+   }
+
 };
 
 
@@ -190,6 +244,11 @@ public:
    )
       : drawable{ start }, radius{ radius }, ink{ ink }
    {}     
+
+   box bounding_box() const override {
+      const auto r = static_cast< int_fast16_t >( radius );
+      return box( start - xy( r, r ), start + xy( r + 1, r + 1 ) );
+   }
    
    void draw( window & w ) override { 
 
@@ -0,0 +1,423 @@
+// ==========================================================================
+//
+// File      : hwlib-graphics-font-proportional.hpp
+// Part of   : C++ hwlib library for close-to-the-hardware OO programming
+// Copyright : wouter@voti.nl 2017-2019
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// included only via hwlib.hpp, hence no multiple-include guard is needed
+
+// this file contains Doxygen lines
+/// @file
+
+namespace hwlib {
+
+
+// ==========================================================================
+//
+// glyph
+//
+// ==========================================================================
+
+/// the metrics and bitmap location of a character in a font_proportional
+///
+/// Only the bounding box of the set (ink) pixels of a character is stored.
+/// Its pixels are packed, 1 bit per pixel, row after row, without
+/// padding between the rows, most significant bit first.
+/// The bitmap of each glyph starts at a byte boundary.
+struct glyph {
+
+   /// index of the first byte of the bitmap of the glyph
+   uint16_t bitmap;
+
+   /// the size of the bounding box
+   uint8_t width, height;
+
+   /// the position of the bounding box in the character cell
+   int8_t x, y;
+
+   /// the horizontal distance from this character to the next one
+   uint8_t advance;
+};
+
+
+// ==========================================================================
+//
+// font_proportional
+//
+// ==========================================================================
+
+/// a proportional bitmap font
+///
+/// A font_proportional provides packed bitmaps and metrics for its
+/// characters. Each character has its own width (advance), and only the
+/// pixels inside the bounding box of its ink are stored.
+/// This is much smaller than a font that contains an image object
+/// (with its vtable pointer and size) for each character.
+///
+/// The characters of a font are either a contiguous range of code
+/// points, starting at first, or the (ascending) code points in
+/// a code point table, which is searched with a binary search.
+///
+/// A character is written one row at a time:
+/// each run of equal pixels is written with a single write_span().
+///
+/// A font_proportional doesn't provide an image for each character,
+/// hence it is not a font, and it can't be used by a terminal_from.
+class font_proportional : public noncopyable {
+private:
+
+   const glyph * glyphs;
+   uint_fast16_t n_glyphs;
+   const uint8_t * bitmaps;
+   int_fast16_t line_height;
+   uint_fast16_t first;
+   const uint16_t * code_points;
+
+public:
+
+   /// create a font from its glyphs and bitmaps
+   ///
+   /// The glyphs are for the code points first ... first + n - 1,
+   /// or, when code_points is not nullptr, for the n code points
+   /// in that (ascending) table.
+   constexpr font_proportional(
+      const glyph * glyphs,
+      uint_fast16_t n,
+      const uint8_t * bitmaps,
+      int_fast16_t line_height,
+      uint_fast16_t first,
+      const uint16_t * code_points = nullptr
+   ):
+      glyphs( glyphs ),
+      n_glyphs( n ),
+      bitmaps( bitmaps ),
+      line_height( line_height ),
+      first( first ),
+      code_points( code_points )
+   {}
+
+   /// the glyph for a code point
+   ///
+   /// This function returns nullptr when the font has no glyph
+   /// for the code point.
+   const glyph * find( uint_fast16_t code_point ) const;
+
+   /// the height of a line of text
+   int_fast16_t height() const {
+      return line_height;
+   }
+
+   /// the width of a character
+   ///
+   /// A character that is not in the font has width 0.
+   int_fast16_t width( char c ) const {
+      const auto g = find( static_cast< unsigned char >( c ) );
+      return ( g == nullptr ) ? 0 : g->advance;
+   }
+
+   /// the width of a text
+   int_fast16_t text_width( const char * s ) const;
+
+   /// write a character, return its width
+   ///
+   /// This function writes the character in the ink color,
+   /// with its top-left at pos.
+   /// The other pixels of the character cell are written in the
+   /// paper color, which is transparent by default.
+   /// A character that is not in the font is not written.
+   int_fast16_t write(
+      window & w,
+      xy pos,
+      char c,
+      color ink = unspecified,
+      color paper = transparent
+   ) const;
+
+   /// write a text, return its width
+   int_fast16_t write(
+      window & w,
+      xy pos,
+      const char * s,
+      color ink = unspecified,
+      color paper = transparent
+   ) const;
+
+}; // class font_proportional
+
+
+// ==========================================================================
+//
+// font_proportional_8x8
+//
+// ==========================================================================
+
+/// \cond INTERNAL
+
+// the glyphs and bitmaps of a font_proportional
+template< size_t n_glyphs, size_t n_bytes >
+struct font_proportional_data {
+   std::array< glyph, n_glyphs > glyphs;
+   std::array< uint8_t, n_bytes > bitmaps;
+};
+
+// whether a pixel of a character of the 8x8 font is set
+constexpr bool font_8x8_pixel( int c, int x, int y ){
+   return ( font_8x8_data[ c ][ y ] & ( 0x01 << x ) ) != 0;
+}
+
+// the leftmost set column of a character of the 8x8 font
+constexpr int font_8x8_left( int c ){
+   for( int x = 0; x < 8; ++x ){
+      for( int y = 0; y < 8; ++y ){
+         if( font_8x8_pixel( c, x, y ) ){
+            return x;
+         }
+      }
+   }
+   return 0;
+}
+
+// the glyph of a character of the 8x8 font, with its
+// blank columns at the left and right removed
+constexpr glyph font_8x8_glyph( int c, uint16_t bitmap ){
+   int left = 8, right = -1, top = 8, bottom = -1;
+   for( int y = 0; y < 8; ++y ){
+      for( int x = 0; x < 8; ++x ){
+         if( font_8x8_pixel( c, x, y ) ){
+            left   = x < left   ? x : left;
+            right  = x > right  ? x : right;
+            top    = y < top    ? y : top;
+            bottom = y > bottom ? y : bottom;
+         }
+      }
+   }
+   if( right < 0 ){
+      return glyph{ bitmap, 0, 0, 0, 0, 4 };
+   }
+   return glyph{
+      bitmap,
+      static_cast< uint8_t >( right - left + 1 ),
+      static_cast< uint8_t >( bottom - top + 1 ),
+      0,
+      static_cast< int8_t >( top ),
+      static_cast< uint8_t >( right - left + 2 ) };
+}
+
+// the printable characters of the 8x8 font
+constexpr int font_8x8_first = ' ';
+constexpr int font_8x8_count = 95;
+
+// the number of bitmap bytes of the proportional 8x8 font
+constexpr size_t font_8x8_proportional_length(){
+   size_t length = 0;
+   for( int c = 0; c < font_8x8_count; ++c ){
+      const auto g = font_8x8_glyph( font_8x8_first + c, 0 );
+      length += ( g.width * g.height + 7 ) / 8;
+   }
+   return length;
+}
+
+template< size_t n_bytes >
+constexpr font_proportional_data< font_8x8_count, n_bytes >
+   font_8x8_proportional()
+{
+   font_proportional_data< font_8x8_count, n_bytes > result = {};
+   uint16_t bitmap = 0;
+   for( int c = 0; c < font_8x8_count; ++c ){
+      const auto g = font_8x8_glyph( font_8x8_first + c, bitmap );
+      result.glyphs[ c ] = g;
+      const int left = font_8x8_left( font_8x8_first + c );
+      int bit = 0;
+      for( int y = g.y; y < g.y + g.height; ++y ){
+         for( int x = 0; x < g.width; ++x ){
+            if( font_8x8_pixel( font_8x8_first + c, left + x, y ) ){
+               result.bitmaps[ bitmap + bit / 8 ] |= 0x80 >> ( bit % 8 );
+            }
+            ++bit;
+         }
+      }
+      bitmap += ( bit + 7 ) / 8;
+   }
+   return result;
+}
+
+/// \endcond
+
+/// a proportional version of the 8x8 font
+///
+/// This font contains the printable ASCII characters of
+/// font_default_8x8, with their blank columns removed and
+/// one blank column between characters.
+/// The glyphs and bitmaps are computed at compile time.
+class font_proportional_8x8 : public font_proportional {
+private:
+
+   static constexpr auto data =
+      font_8x8_proportional< font_8x8_proportional_length() >();
+
+public:
+
+   constexpr font_proportional_8x8():
+      font_proportional(
+         data.glyphs.data(), font_8x8_count,
+         data.bitmaps.data(), 8, font_8x8_first )
+   {}
+
+}; // class font_proportional_8x8
+
+
+// ==========================================================================
+//
+// text
+//
+// ==========================================================================
+
+/// a text object
+///
+/// A text object writes a (zero-terminated) string in a
+/// font_proportional.
+/// Its bounding box is the width of the text by the height of the font.
+class text : public drawable {
+private:
+   const font_proportional & f;
+   const char * s;
+   color ink;
+   color paper;
+
+public:
+
+   /// create a text object
+   text(
+      xy start,
+      const font_proportional & f,
+      const char * s,
+      color ink = unspecified,
+      color paper = transparent
+   ):
+      drawable{ start }, f( f ), s( s ), ink( ink ), paper( paper )
+   {}
+
+   /// change the string
+   ///
+   /// The text object refers to the string, it doesn't copy it.
+   void set( const char * new_s ){
+      s = new_s;
+      changed();
+   }
+
+   void draw( window & w ) override {
+      f.write( w, start, s, ink, paper );
+   }
+
+   box bounding_box() const override {
+      return box( start, start + xy( f.text_width( s ), f.height() ) );
+   }
+
+}; // class text
+
+
+// ===========================================================================
+//
+// implementations
+//
+// ===========================================================================
+
+#ifdef _HWLIB_ONCE
+
+const glyph * font_proportional::find( uint_fast16_t code_point ) const {
+   if( code_points == nullptr ){
+      return ( code_point >= first ) && ( code_point - first < n_glyphs )
+         ? glyphs + ( code_point - first )
+         : nullptr;
+   }
+   uint_fast16_t low = 0;
+   uint_fast16_t high = n_glyphs;
+   while( low < high ){
+      const auto middle = ( low + high ) / 2;
+      if( code_points[ middle ] < code_point ){
+         low = middle + 1;
+      } else {
+         high = middle;
+      }
+   }
+   return ( low < n_glyphs ) && ( code_points[ low ] == code_point )
+      ? glyphs + low
+      : nullptr;
+}
+
+int_fast16_t font_proportional::text_width( const char * s ) const {
+   int_fast16_t result = 0;
+   while( *s != '\0' ){
+      result += width( *s++ );
+   }
+   return result;
+}
+
+int_fast16_t font_proportional::write(
+   window & w,
+   xy pos,
+   char c,
+   color ink,
+   color paper
+) const {
+   const auto g = find( static_cast< unsigned char >( c ) );
+   if( g == nullptr ){
+      return 0;
+   }
+   const uint8_t * p = bitmaps + g->bitmap;
+   const int_fast16_t right = g->x + g->width;
+   uint_fast16_t bit = 0;
+   for( int_fast16_t y = 0; y < line_height; ++y ){
+      const auto row = pos + xy( 0, y );
+
+      if( ( y < g->y ) || ( y >= g->y + g->height ) ){
+         w.write_span( row, g->advance, paper );
+         continue;
+      }
+
+      w.write_span( row, g->x, paper );
+
+      // write the runs of equal pixels of this row of the bitmap
+      int_fast16_t x = 0;
+      while( x < g->width ){
+         const bool set = ( p[ bit / 8 ] >> ( 7 - bit % 8 ) ) & 0x01;
+         int_fast16_t n = 0;
+         do {
+            ++n;
+            ++bit;
+         } while(
+            ( x + n < g->width )
+            && ( ( ( p[ bit / 8 ] >> ( 7 - bit % 8 ) ) & 0x01 ) == set )
+         );
+         w.write_span( row + xy( g->x + x, 0 ), n, set ? ink : paper );
+         x += n;
+      }
+
+      w.write_span( row + xy( right, 0 ), g->advance - right, paper );
+   }
+   return g->advance;
+}
+
+int_fast16_t font_proportional::write(
+   window & w,
+   xy pos,
+   const char * s,
+   color ink,
+   color paper
+) const {
+   const auto start = pos.x;
+   while( *s != '\0' ){
+      pos.x += write( w, pos, *s++, ink, paper );
+   }
+   return pos.x - start;
+}
+
+#endif // _HWLIB_ONCE
+
+}; // namespace hwlib
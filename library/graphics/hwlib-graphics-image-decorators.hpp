@@ -20,152 +20,354 @@ namespace hwlib {
 
 // ==========================================================================
 //
-// invert
+// image_transform_t
 //
 // ==========================================================================
 
-/// \cond INTERNAL    
-
-
-class image_part_t : public image {
+/// an image that is a transformed view of another image
+///
+/// An image_transform_t shows a part, mirror, transpose, integer
+/// scale and/or inversion of a source image, or any sequence of those.
+/// Applying a next transformation to an image_transform_t doesn't
+/// stack a next decorator object: it is folded into a single 2x3
+/// integer matrix (plus a divisor for the scaling) and a color
+/// inversion flag. Hence reading a pixel costs
+/// one read of the source image, no matter how many
+/// transformations are applied.
+///
+/// When the transformed image is written to a window, the source
+/// location is stepped incrementally (no multiplication or division
+/// per pixel), and equal pixels are written as spans.
+/// When the source stores its pixels as packed bits (image::packed()),
+/// those bits are read directly.
+///
+/// An image_transform_t refers to its source image, which must
+/// outlive it.
+///
+/// \code
+/// auto sprite = hwlib::transform( img ).part( start, size ).transpose();
+/// \endcode
+class image_transform_t : public image {
 private:
 
-   const image & slave;
-   const xy start;
-   
-   color read_implementation( xy pos ) const override {
-      return slave[ start + pos ];
-   }	  
-
-public:
-
-   constexpr image_part_t( const image & slave, xy start, xy size ):
-      image( size ), slave( slave ), start( start ){}
-	  
-};  
-
-
-class image_invert_t : public image {
-private:
+   const image & source;
+
+   // the source location of the center of pixel pos is
+   // ( m * ( 2 * pos.x + 1, 2 * pos.y + 1, 1 ) ) / divisor, rounded down
+   int_fast32_t m[ 2 ][ 3 ];
+   int_fast32_t divisor;
+   bool inverted;
+
+   // the visible source area, in the same units as m * ( ... ):
+   // a part can extend beyond the image it is taken from,
+   // the pixels outside that image are transparent
+   int_fast32_t low[ 2 ], high[ 2 ];
+
+   // copy a transformation, with a new size
+   constexpr image_transform_t( const image_transform_t & t, xy size ):
+      image( size ),
+      source( t.source ),
+      m{ { t.m[ 0 ][ 0 ], t.m[ 0 ][ 1 ], t.m[ 0 ][ 2 ] },
+         { t.m[ 1 ][ 0 ], t.m[ 1 ][ 1 ], t.m[ 1 ][ 2 ] } },
+      divisor( t.divisor ),
+      inverted( t.inverted ),
+      low{ t.low[ 0 ], t.low[ 1 ] },
+      high{ t.high[ 0 ], t.high[ 1 ] }
+   {}
+
+   // division that rounds towards minus infinity
+   static constexpr int_fast32_t floor_div( int_fast32_t n, int_fast32_t d ){
+      return ( n >= 0 ) ? n / d : - ( ( d - 1 - n ) / d );
+   }
+
+   // m * ( ux, uy, 1 ) for axis i
+   constexpr int_fast32_t apply( int i, int_fast32_t ux, int_fast32_t uy ) const {
+      return m[ i ][ 0 ] * ux + m[ i ][ 1 ] * uy + m[ i ][ 2 ];
+   }
+
+   // n / d, rounded down, for n increasing by step
+   struct stepper {
+      int_fast32_t n, q, r, dn, dq, dr, d;
+
+      stepper( int_fast32_t n, int_fast32_t step, int_fast32_t d ):
+         n( n ),
+         q( floor_div( n, d ) ),
+         r( n - q * d ),
+         dn( step ),
+         dq( floor_div( step, d ) ),
+         dr( step - dq * d ),
+         d( d )
+      {}
+
+      void next(){
+         n += dn;
+         q += dq;
+         r += dr;
+         if( r >= d ){
+            r -= d;
+            ++q;
+         }
+      }
+   };
+
+   // the color of a source pixel, or transparent when it is not visible
+   color source_read(
+      const stepper & x,
+      const stepper & y,
+      bool direct,
+      const image_bits & layout
+   ) const {
+      if(
+         ( x.n < low[ 0 ] ) || ( x.n >= high[ 0 ] )
+         || ( y.n < low[ 1 ] ) || ( y.n >= high[ 1 ] )
+      ){
+         return transparent;
+      }
+      const color col = direct
+         ? ( ( layout.data[ y.q * layout.stride + x.q / 8 ] >> ( x.q % 8 ) )
+               & 0x01 )
+            ? layout.one
+            : layout.zero
+         : source.read_implementation( xy( x.q, y.q ) );
+      return inverted ? - col : col;
+   }
 
-   const image & slave;
-   
    color read_implementation( xy pos ) const override {
-      return - slave[ pos ];
-   }	  
+      const image_bits layout{ nullptr, 0, transparent, transparent };
+      const int_fast32_t ux = 2 * pos.x + 1;
+      const int_fast32_t uy = 2 * pos.y + 1;
+      return source_read(
+         stepper( apply( 0, ux, uy ), 0, divisor ),
+         stepper( apply( 1, ux, uy ), 0, divisor ),
+         false, layout );
+   }
 
 public:
 
-   constexpr image_invert_t( const image & slave ): 
-      image( slave.size ), slave( slave ){}
-	  
-};  
-
+   /// create an (untransformed) view of an image
+   constexpr image_transform_t( const image & source ):
+      image( source.size ),
+      source( source ),
+      m{ { 1, 0, 0 }, { 0, 1, 0 } },
+      divisor( 2 ),
+      inverted( false ),
+      low{ 0, 0 },
+      high{ 2 * source.size.x, 2 * source.size.y }
+   {}
+
+   /// a part of this image
+   constexpr image_transform_t part( xy start, xy size ) const {
+      image_transform_t t( *this, size );
+      for( int i = 0; i < 2; ++i ){
+
+         // clip to the area of this image
+         const auto a = apply( i, 0, 0 );
+         const auto b = apply( i, 2 * this->size.x, 2 * this->size.y );
+         const auto first = a < b ? a : b;
+         const auto last  = a < b ? b : a;
+         t.low[ i ]  = first > low[ i ]  ? first : low[ i ];
+         t.high[ i ] = last  < high[ i ] ? last  : high[ i ];
+
+         t.m[ i ][ 2 ] += 2 * ( m[ i ][ 0 ] * start.x + m[ i ][ 1 ] * start.y );
+      }
+      return t;
+   }
+
+   /// this image, mirrored in the x direction
+   constexpr image_transform_t mirror_x() const {
+      image_transform_t t( *this, size );
+      for( int i = 0; i < 2; ++i ){
+         t.m[ i ][ 0 ] = - m[ i ][ 0 ];
+         t.m[ i ][ 2 ] += 2 * m[ i ][ 0 ] * size.x;
+      }
+      return t;
+   }
+
+   /// this image, mirrored in the y direction
+   constexpr image_transform_t mirror_y() const {
+      image_transform_t t( *this, size );
+      for( int i = 0; i < 2; ++i ){
+         t.m[ i ][ 1 ] = - m[ i ][ 1 ];
+         t.m[ i ][ 2 ] += 2 * m[ i ][ 1 ] * size.y;
+      }
+      return t;
+   }
+
+   /// this image, with x and y swapped
+   constexpr image_transform_t transpose() const {
+      image_transform_t t( *this, xy( size.y, size.x ) );
+      for( int i = 0; i < 2; ++i ){
+         t.m[ i ][ 0 ] = m[ i ][ 1 ];
+         t.m[ i ][ 1 ] = m[ i ][ 0 ];
+      }
+      return t;
+   }
+
+   /// this image, magnified by an integer factor
+   constexpr image_transform_t scale( int_fast16_t factor ) const {
+      image_transform_t t( *this, size * factor );
+      for( int i = 0; i < 2; ++i ){
+         t.m[ i ][ 2 ] *= factor;
+         t.low[ i ]    *= factor;
+         t.high[ i ]   *= factor;
+      }
+      t.divisor *= factor;
+      return t;
+   }
+
+   /// this image, with the colors of its pixels inverted
+   constexpr image_transform_t invert() const {
+      image_transform_t t( *this, size );
+      t.inverted = ! inverted;
+      return t;
+   }
+
+   /// write the image to a window, one source read per pixel
+   void write_to( window & w, xy pos ) const override;
+
+}; // class image_transform_t
 
-class image_transpose_t : public image {
-private:
 
-   const image & slave;
-   
-   color read_implementation( xy pos ) const override {
-      return slave[ transpose( pos ) ];
-   }	  
+// ===========================================================================
+//
+// constructor functions
+//
+// ===========================================================================
 
-public:
+/// return an (untransformed) view of an image
+///
+/// The result can be transformed by its part(), mirror_x(), mirror_y(),
+/// transpose(), scale() and invert() functions.
+image_transform_t transform( const image & source );
 
-   constexpr image_transpose_t( const image & slave ): 
-      image( transpose( slave.size ) ), slave( slave ){}
-	  
-};  
+/// return a part of an image
+const image_transform_t part( const image & source, xy start, xy size );
 
+/// return a part of a transformed image
+const image_transform_t part(
+   const image_transform_t & source, xy start, xy size );
 
-class image_mirror_x_t : public image {
-private:
+/// invert an image
+///
+/// This function returns the image, but with the color of 
+/// all its pixels inverted.
+const image_transform_t invert( const image & source );
 
-   const image & slave;
-   
-   color read_implementation( xy pos ) const override {
-      return slave[ xy( slave.size.x - 1 - pos.x, pos.y ) ];
-   }	  
+/// invert a transformed image
+const image_transform_t invert( const image_transform_t & source );
 
-public:
+/// return an image with x and y swapped
+const image_transform_t transpose( const image & source );
 
-   constexpr image_mirror_x_t( const image & slave ): 
-      image( slave.size ), slave( slave ){}
-	  
-};  
+/// return a transformed image with x and y swapped
+const image_transform_t transpose( const image_transform_t & source );
 
+/// return an image mirrored in the x direction
+const image_transform_t mirror_x( const image & source );
 
-class image_mirror_y_t : public image {
-private:
+/// return a transformed image mirrored in the x direction
+const image_transform_t mirror_x( const image_transform_t & source );
 
-   const image & slave;
-   
-   color read_implementation( xy pos ) const override {
-      return slave[ xy( pos.x, slave.size.y - 1 - pos.y ) ];
-   }	  
+/// return an image mirrored in the y direction
+const image_transform_t mirror_y( const image & source );
 
-public:
+/// return a transformed image mirrored in the y direction
+const image_transform_t mirror_y( const image_transform_t & source );
 
-   constexpr image_mirror_y_t( const image & slave ): 
-      image( slave.size ), slave( slave ){}
-	  
-};  
+/// return an image magnified by an integer factor
+const image_transform_t scale( const image & source, int_fast16_t factor );
 
-/// \endcond   
+/// return a transformed image magnified by an integer factor
+const image_transform_t scale(
+   const image_transform_t & source, int_fast16_t factor );
 
 
 // ===========================================================================
 //
-// constructor functions
+// implementations
 //
 // ===========================================================================
 
-/// return a part of an image
-const image_part_t part( const image & slave, xy start, xy size );
+#ifdef _HWLIB_ONCE 
 
-/// invert an image
-///
-/// This function returns the image, but with the color of 
-/// all its pixels inverted.
-const image_invert_t invert( const image & slave );
+void image_transform_t::write_to( window & w, xy pos ) const {
+   image_bits layout{ nullptr, 0, transparent, transparent };
+   const bool direct = source.packed( layout );
+   for( int_fast16_t y = 0; y < size.y; ++y ){
+      const int_fast32_t uy = 2 * y + 1;
+      stepper sx( apply( 0, 1, uy ), 2 * m[ 0 ][ 0 ], divisor );
+      stepper sy( apply( 1, 1, uy ), 2 * m[ 1 ][ 0 ], divisor );
+      color run = transparent;
+      int_fast16_t n = 0;
+      for( int_fast16_t x = 0; x < size.x; ++x ){
+         const auto col = source_read( sx, sy, direct, layout );
+         if( ( n > 0 ) && ( col != run ) ){
+            w.write_span( pos + xy( x - n, y ), n, run );
+            n = 0;
+         }
+         run = col;
+         ++n;
+         sx.next();
+         sy.next();
+      }
+      w.write_span( pos + xy( size.x - n, y ), n, run );
+   }
+}
 
-/// return a part of an image
-const image_transpose_t transpose( const image & slave );
+image_transform_t transform( const image & source ){
+   return image_transform_t( source );
+}
 
-/// return a part of an image
-const image_mirror_x_t mirror_x( const image & slave );
+const image_transform_t part( const image & source, xy start, xy size ){
+   return image_transform_t( source ).part( start, size );
+}
 
-/// return a part of an image
-const image_mirror_y_t mirror_y( const image & slave );
+const image_transform_t part(
+   const image_transform_t & source, xy start, xy size
+){
+   return source.part( start, size );
+}
 
+const image_transform_t invert( const image & source ){
+   return image_transform_t( source ).invert();
+}
 
-// ===========================================================================
-//
-// implementations
-//
-// ===========================================================================
+const image_transform_t invert( const image_transform_t & source ){
+   return source.invert();
+}
 
-#ifdef _HWLIB_ONCE 
+const image_transform_t transpose( const image & source ){
+   return image_transform_t( source ).transpose();
+}
+
+const image_transform_t transpose( const image_transform_t & source ){
+   return source.transpose();
+}
+
+const image_transform_t mirror_x( const image & source ){
+   return image_transform_t( source ).mirror_x();
+}
 
-const image_part_t part( const image & slave, xy start, xy size ){
-   return image_part_t( slave, start, size );
+const image_transform_t mirror_x( const image_transform_t & source ){
+   return source.mirror_x();
 }
 
-const image_invert_t invert( const image & slave ){
-   return image_invert_t( slave );
+const image_transform_t mirror_y( const image & source ){
+   return image_transform_t( source ).mirror_y();
 }
 
-const image_transpose_t transpose( const image & slave ){
-   return image_transpose_t( slave );
+const image_transform_t mirror_y( const image_transform_t & source ){
+   return source.mirror_y();
 }
 
-const image_mirror_x_t mirror_x( const image & slave ){
-   return image_mirror_x_t( slave );
+const image_transform_t scale( const image & source, int_fast16_t factor ){
+   return image_transform_t( source ).scale( factor );
 }
 
-const image_mirror_y_t mirror_y( const image & slave ){
-   return image_mirror_y_t( slave );
+const image_transform_t scale(
+   const image_transform_t & source, int_fast16_t factor
+){
+   return source.scale( factor );
 }
 
 #endif   
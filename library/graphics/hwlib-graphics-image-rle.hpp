@@ -0,0 +1,300 @@
+// ==========================================================================
+//
+// File      : hwlib-graphics-image-rle.hpp
+// Part of   : C++ hwlib library for close-to-the-hardware OO programming
+// Copyright : wouter@voti.nl 2017-2019
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// included only via hwlib.hpp, hence no multiple-include guard is needed
+
+// this file contains Doxygen lines
+/// @file
+
+namespace hwlib {
+
+
+// ==========================================================================
+//
+// run-length encoding
+//
+// ==========================================================================
+
+/// \cond INTERNAL
+
+// The pixels of an image_rle are stored as a sequence of palette indexes,
+// from left to right and top to bottom, in a PackBits-like format.
+// A sequence is a control byte c, followed by
+//    - when c & 0x80: one index byte, repeated ( c & 0x7F ) + 1 times
+//    - otherwise: c + 1 literal indexes, each bits wide, packed
+//      (first index in the most significant bits) in as few bytes
+//      as possible.
+// A sequence can continue on the next line.
+
+// the palette index for a pixel character
+constexpr uint_fast8_t rle_index( int bits, char c ){
+   return ( bits == 1 )
+      ? ( ( ( c == ' ' ) || ( c == '.' ) ) ? 0 : 1 )
+      : ( ( ( c >= '0' ) && ( c <= '9' ) )
+         ? c - '0'
+         : ( ( c >= 'a' ) && ( c <= 'z' ) )
+            ? c - 'a' + 10
+            : ( ( c >= 'A' ) && ( c <= 'Z' ) )
+               ? c - 'A' + 10
+               : 0 ) & ( ( 1 << bits ) - 1 );
+}
+
+// the shortest run for which a repeat sequence is used
+constexpr size_t rle_min_run( int bits ){
+   return ( bits >= 8 ) ? 3 : 24 / bits;
+}
+
+// the length (up to 128) of the run of equal pixels that starts at i
+constexpr size_t rle_run( int bits, size_t n, const char * pixels, size_t i ){
+   size_t run = 1;
+   while(
+      ( i + run < n )
+      && ( run < 128 )
+      && ( rle_index( bits, pixels[ i + run ] )
+         == rle_index( bits, pixels[ i ] ) )
+   ){
+      ++run;
+   }
+   return run;
+}
+
+// encode the n pixels to out, return the number of bytes
+// when out is nullptr, only the number of bytes is returned
+constexpr size_t rle_encode(
+   int bits,
+   size_t n,
+   const char * pixels,
+   uint8_t * out
+){
+   size_t length = 0;
+   size_t i = 0;
+   while( i < n ){
+      const auto run = rle_run( bits, n, pixels, i );
+      if( run >= rle_min_run( bits ) ){
+
+         // repeat sequence
+         if( out != nullptr ){
+            out[ length     ] = 0x80 | ( run - 1 );
+            out[ length + 1 ] = rle_index( bits, pixels[ i ] );
+         }
+         length += 2;
+         i += run;
+
+      } else {
+
+         // literal sequence: up to the next long run
+         const auto first = i;
+         size_t count = 0;
+         while( ( i < n ) && ( count < 128 ) ){
+            auto r = rle_run( bits, n, pixels, i );
+            if( r >= rle_min_run( bits ) ){
+               break;
+            }
+            if( r > 128 - count ){
+               r = 128 - count;
+            }
+            i += r;
+            count += r;
+         }
+         if( out != nullptr ){
+            out[ length ] = count - 1;
+            for( size_t j = 0; j < count; ++j ){
+               const auto bit = j * bits;
+               out[ length + 1 + bit / 8 ] |=
+                  rle_index( bits, pixels[ first + j ] )
+                     << ( 8 - bits - ( bit % 8 ) );
+            }
+         }
+         length += 1 + ( count * bits + 7 ) / 8;
+      }
+   }
+   return length;
+}
+
+/// \endcond
+
+/// the number of bytes needed to store an image_rle
+///
+/// This function returns the number of bytes needed to
+/// store an image of the specified size and bits per pixel,
+/// with pixels as specified by the characters in pixels.
+/// Use it to supply the length parameter of an image_rle.
+constexpr size_t rle_length( int bits, xy size, const char * pixels ){
+   return rle_encode( bits, size.x * size.y, pixels, nullptr );
+}
+
+/// the default palette for an image_rle
+///
+/// For 1 bit per pixel the palette is black, white.
+/// For more bits per pixel it is a gray scale, from black to white.
+template< int bits >
+constexpr std::array< color, 1 << bits > rle_default_palette(){
+   std::array< color, 1 << bits > palette;
+   for( int i = 0; i < ( 1 << bits ); ++i ){
+      const auto level = ( i * 0xFF ) / ( ( 1 << bits ) - 1 );
+      palette[ i ] = color( level, level, level );
+   }
+   return palette;
+}
+
+
+// ==========================================================================
+//
+// image_rle
+//
+// ==========================================================================
+
+/// a run-length compressed image
+///
+/// This image stores its pixels as run-length (PackBits-like) encoded
+/// palette indexes, with 1, 2, 4 or 8 bits per index.
+/// The encoding is done by the (constexpr) constructor,
+/// so a constexpr image_rle is encoded at compile time and
+/// only the compressed data and the palette end up in ROM.
+///
+/// The pixels are specified by a string with one character per pixel,
+/// from left to right and top to bottom.
+/// For 1 bit per pixel, ' ' and '.' are palette index 0,
+/// any other character is palette index 1.
+/// For more bits per pixel, '0' .. '9' and 'a' .. 'z'
+/// (or 'A' .. 'Z') are palette indexes 0 .. 35.
+/// A palette entry can be transparent.
+///
+/// The length template parameter must be the compressed length,
+/// as calculated by rle_length():
+///
+/// \code
+/// constexpr char logo_pixels[] =
+///    "..XXXX.."
+///    ".X....X."
+///    "..XXXX..";
+/// constexpr auto logo = hwlib::image_rle<
+///    1, hwlib::rle_length( 1, hwlib::xy( 8, 3 ), logo_pixels ) >(
+///    hwlib::xy( 8, 3 ), logo_pixels );
+/// \endcode
+///
+/// When written to a window, the image is decoded while
+/// it is written: a run of equal pixels is written as a
+/// span (write_span), without an intermediate buffer.
+///
+/// Reading a single pixel (operator[]) requires decoding from the
+/// start of the image, which is slow.
+template< int bits, size_t length >
+class image_rle : public image {
+private:
+
+   static_assert(
+      ( bits == 1 ) || ( bits == 2 ) || ( bits == 4 ) || ( bits == 8 ),
+      "bits must be 1, 2, 4 or 8" );
+
+   std::array< uint8_t, length > data;
+   std::array< color, 1 << bits > palette;
+
+   static constexpr std::array< uint8_t, length > encode(
+      xy size,
+      const char * pixels
+   ){
+      std::array< uint8_t, length > result = {};
+      rle_encode( bits, size.x * size.y, pixels, result.data() );
+      return result;
+   }
+
+   // call f( first, n, index ) for each run of n pixels,
+   // starting at pixel number first, until f returns false
+   template< typename F >
+   void decode( F f ) const {
+      const uint_fast32_t n = static_cast< uint_fast32_t >( size.x ) * size.y;
+      uint_fast32_t first = 0;
+      const uint8_t * p = data.data();
+      while( first < n ){
+         const uint_fast8_t c = *p++;
+         if( c & 0x80 ){
+            const uint_fast16_t count = ( c & 0x7F ) + 1;
+            if( ! f( first, count, *p++ ) ){
+               return;
+            }
+            first += count;
+         } else {
+            const uint_fast16_t count = c + 1;
+            for( uint_fast16_t j = 0; j < count; ++j ){
+               const uint_fast16_t bit = j * bits;
+               const uint_fast8_t index =
+                  ( p[ bit / 8 ] >> ( 8 - bits - ( bit % 8 ) ) )
+                  & ( ( 1 << bits ) - 1 );
+               if( ! f( first + j, 1, index ) ){
+                  return;
+               }
+            }
+            p += ( count * bits + 7 ) / 8;
+            first += count;
+         }
+      }
+   }
+
+   color read_implementation( xy pos ) const override {
+      const uint_fast32_t target =
+         static_cast< uint_fast32_t >( pos.y ) * size.x + pos.x;
+      color result = transparent;
+      decode( [ & ]( uint_fast32_t first, uint_fast16_t n, uint_fast8_t i ){
+         if( target < first + n ){
+            result = palette[ i ];
+            return false;
+         }
+         return true;
+      } );
+      return result;
+   }
+
+public:
+
+   /// create an image from its size, pixel characters and palette
+   constexpr image_rle(
+      xy size,
+      const char * pixels,
+      const std::array< color, 1 << bits > & palette
+         = rle_default_palette< bits >()
+   ):
+      image( size ),
+      data( encode( size, pixels ) ),
+      palette( palette )
+   {}
+
+   /// the number of bytes of compressed pixel data
+   static constexpr size_t data_length(){
+      return length;
+   }
+
+   /// write the image to a window, decoding runs into spans
+   void write_to( window & w, xy pos ) const override {
+      xy p( 0, 0 );
+      decode( [ & ]( uint_fast32_t, uint_fast16_t n, uint_fast8_t i ){
+         const auto col = palette[ i ];
+         while( n > 0 ){
+            const uint_fast16_t part =
+               ( n < static_cast< uint_fast16_t >( size.x - p.x ) )
+                  ? n
+                  : size.x - p.x;
+            w.write_span( pos + p, part, col );
+            n -= part;
+            p.x += part;
+            if( p.x == size.x ){
+               p.x = 0;
+               ++p.y;
+            }
+         }
+         return true;
+      } );
+   }
+
+}; // class image_rle
+
+}; // namespace hwlib
@@ -17,6 +17,34 @@
 
 namespace hwlib {
 
+class window;
+class image_transform_t;
+
+
+// ==========================================================================
+//
+// image_bits
+//
+// ==========================================================================
+
+/// the layout of an image that stores its pixels as packed bits
+///
+/// The pixels are stored 1 bit per pixel, row after row,
+/// each row starting at a byte boundary.
+/// Within a byte, bit 0 is the leftmost pixel.
+/// A cleared bit is pixel color zero, a set bit is pixel color one.
+struct image_bits {
+
+   /// the first byte of the top row
+   const uint8_t * data;
+
+   /// the number of bytes per row
+   int_fast16_t stride;
+
+   /// the colors of a cleared and of a set bit
+   color zero, one;
+};
+
 
 // ==========================================================================
 //
@@ -32,6 +60,9 @@ private:
 
    virtual color read_implementation( xy pos ) const = 0;
 
+   // reads the source image without the bounds check of read()
+   friend class image_transform_t;
+
 public:
 
    /// the size of the image
@@ -60,6 +91,26 @@ public:
    color operator[]( xy pos ) const {
       return read( pos );
    }
+
+   /// write the image to a window
+   ///
+   /// This function writes the pixels of the image to the window w,
+   /// with the top-left pixel at location pos.
+   /// It is used by window::write( pos, image ).
+   ///
+   /// The default implementation reads and writes each pixel.
+   /// A concrete image can provide a faster implementation.
+   virtual void write_to( window & w, xy pos ) const;
+
+   /// get the layout of the pixels, if they are stored as packed bits
+   ///
+   /// An image that stores its pixels as packed bits can return
+   /// true and fill in the layout, which allows
+   /// an image_transform_t to read the bits directly.
+   /// The default implementation returns false.
+   virtual bool packed( image_bits & ) const {
+      return false;
+   }
 };
 
 
@@ -95,6 +146,11 @@ public:
       image( xy( 8, 8 ) ),
       data{ d0, d1, d2, d3, d4, d5, d6, d7 }
    {}
+
+   bool packed( image_bits & layout ) const override {
+      layout = image_bits{ data, 1, white, black };
+      return true;
+   }
 };
 
 
@@ -0,0 +1,620 @@
+// ==========================================================================
+//
+// File      : hwlib-graphics-pixel-format.hpp
+// Part of   : C++ hwlib library for close-to-the-hardware OO programming
+// Copyright : wouter@voti.nl 2017-2019
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// included only via hwlib.hpp, hence no multiple-include guard is needed
+
+// this file contains Doxygen lines
+/// @file
+
+namespace hwlib {
+
+
+// ==========================================================================
+//
+// pixel formats
+//
+// ==========================================================================
+
+/// the formats in which a display receives its pixels
+///
+///    - rgb565 : 2 bytes per pixel, 5-6-5 bits, most significant byte first
+///    - rgb666 : 3 bytes per pixel, red, green, blue,
+///      each in the upper 6 bits of its byte
+///    - rgb332 : 1 byte per pixel, 3-3-2 bits
+///    - mono   : 1 bit per pixel, 8 pixels per byte, leftmost pixel in
+///      the most significant bit; a pixel is set when its brightness
+///      is at least half of white. A row that is not a multiple of
+///      8 pixels is padded with 0 bits.
+///
+/// The special (transparent, unspecified) colors are converted as
+/// if they were black.
+enum class pixel_format : uint8_t {
+   rgb565,
+   rgb666,
+   rgb332,
+   mono
+};
+
+/// the number of bytes for n pixels in a pixel format
+constexpr size_t pixel_format_bytes( pixel_format format, size_t n ){
+   return
+        ( format == pixel_format::rgb565 ) ? 2 * n
+      : ( format == pixel_format::rgb666 ) ? 3 * n
+      : ( format == pixel_format::rgb332 ) ? n
+      : ( n + 7 ) / 8;
+}
+
+/// the implementations of the batch pixel format conversion
+///
+/// A kernel that is not available in the build (because the
+/// target doesn't have the instructions, or they are not enabled
+/// by the compiler flags) falls back to the scalar kernel:
+/// use pixel_kernel_available() to check.
+enum class pixel_kernel : uint8_t {
+   scalar,
+   ssse3,
+   avx2,
+   neon
+};
+
+/// whether a kernel is available in this build
+///
+/// The scalar kernel is always available.
+/// The SSSE3 kernels need -mssse3 (or -mavx2), the AVX2 kernels
+/// need -mavx2, and the NEON kernels need a target with NEON.
+constexpr bool pixel_kernel_available( pixel_kernel kernel ){
+   return
+         ( kernel == pixel_kernel::scalar )
+   #if defined( __SSSE3__ ) || defined( __AVX2__ )
+      || ( kernel == pixel_kernel::ssse3 )
+   #endif
+   #if defined( __AVX2__ )
+      || ( kernel == pixel_kernel::avx2 )
+   #endif
+   #if defined( __ARM_NEON )
+      || ( kernel == pixel_kernel::neon )
+   #endif
+      ;
+}
+
+/// the fastest pixel format conversion kernel available in this build
+constexpr pixel_kernel pixel_kernel_best =
+#if defined( __AVX2__ )
+   pixel_kernel::avx2;
+#elif defined( __SSSE3__ )
+   pixel_kernel::ssse3;
+#elif defined( __ARM_NEON )
+   pixel_kernel::neon;
+#else
+   pixel_kernel::scalar;
+#endif
+
+/// convert an array of colors to a pixel format
+///
+/// This function converts the n colors at in to the pixel format,
+/// and writes the result (pixel_format_bytes( format, n ) bytes) to out.
+/// It is meant to be used on a whole row (or more) of pixels at once,
+/// for instance in the flush() of a display driver.
+void pixel_convert(
+   pixel_format format,
+   const color * in,
+   size_t n,
+   uint8_t * out,
+   pixel_kernel kernel = pixel_kernel_best
+);
+
+/// convert an array of pixels in a pixel format to colors
+///
+/// This function converts n pixels in the pixel format at in
+/// to colors, and writes them to out.
+/// The bits of each channel are replicated into the lower bits,
+/// so for instance 0x1F in 5 bits becomes 0xFF.
+void pixel_unconvert(
+   pixel_format format,
+   const uint8_t * in,
+   size_t n,
+   color * out
+);
+
+
+// ===========================================================================
+//
+// implementations
+//
+// ===========================================================================
+
+#ifdef _HWLIB_ONCE
+
+// the kernels read the colors as 4 bytes: special, red, green, blue
+static_assert( sizeof( color ) == 4, "color must be 4 bytes" );
+
+// the scalar kernels, which also handle what remains after
+// the vector kernels: they convert pixels i .. n - 1
+
+static void pixel_convert_rgb565_scalar(
+   const color * in, size_t i, size_t n, uint8_t * out
+){
+   for( ; i < n; ++i ){
+      out[ 2 * i     ] = ( in[ i ].red & 0xF8 ) | ( in[ i ].green >> 5 );
+      out[ 2 * i + 1 ] =
+         ( ( in[ i ].green & 0x1C ) << 3 ) | ( in[ i ].blue >> 3 );
+   }
+}
+
+static void pixel_convert_rgb666_scalar(
+   const color * in, size_t i, size_t n, uint8_t * out
+){
+   for( ; i < n; ++i ){
+      out[ 3 * i     ] = in[ i ].red   & 0xFC;
+      out[ 3 * i + 1 ] = in[ i ].green & 0xFC;
+      out[ 3 * i + 2 ] = in[ i ].blue  & 0xFC;
+   }
+}
+
+static void pixel_convert_rgb332_scalar(
+   const color * in, size_t i, size_t n, uint8_t * out
+){
+   for( ; i < n; ++i ){
+      out[ i ] =
+           ( in[ i ].red & 0xE0 )
+         | ( ( in[ i ].green & 0xE0 ) >> 3 )
+         | ( in[ i ].blue >> 6 );
+   }
+}
+
+// i must be a multiple of 8
+static void pixel_convert_mono_scalar(
+   const color * in, size_t i, size_t n, uint8_t * out
+){
+   for( ; i < n; i += 8 ){
+      uint8_t byte = 0;
+      for( size_t j = 0; ( j < 8 ) && ( i + j < n ); ++j ){
+         const auto & c = in[ i + j ];
+         if( ( c.red * 77 + c.green * 150 + c.blue * 29 ) >= 128 * 256 ){
+            byte |= 0x80 >> j;
+         }
+      }
+      out[ i / 8 ] = byte;
+   }
+}
+
+#if defined( __SSSE3__ ) || defined( __AVX2__ )
+
+// The x86 kernels load 4 (SSSE3) or 8 (AVX2) colors into 32-bit lanes,
+// in which red is in bits 8..15, green in 16..23 and blue in 24..31,
+// compute the pixel value in the low bits of each lane,
+// and gather the result bytes with a byte shuffle.
+
+static size_t pixel_convert_rgb565_ssse3(
+   const color * in, size_t n, uint8_t * out
+){
+   const auto shuffle = _mm_setr_epi8(
+      1, 0, 5, 4, 9, 8, 13, 12, -1, -1, -1, -1, -1, -1, -1, -1 );
+   size_t i = 0;
+   for( ; i + 4 <= n; i += 4 ){
+      const auto c = _mm_loadu_si128(
+         reinterpret_cast< const __m128i * >( in + i ) );
+      const auto v = _mm_or_si128(
+         _mm_or_si128(
+            _mm_and_si128( c, _mm_set1_epi32( 0xF800 ) ),
+            _mm_and_si128( _mm_srli_epi32( c, 13 ), _mm_set1_epi32( 0x07E0 ) ) ),
+         _mm_srli_epi32( c, 27 ) );
+      _mm_storel_epi64(
+         reinterpret_cast< __m128i * >( out + 2 * i ),
+         _mm_shuffle_epi8( v, shuffle ) );
+   }
+   return i;
+}
+
+static size_t pixel_convert_rgb666_ssse3(
+   const color * in, size_t n, uint8_t * out
+){
+   const auto shuffle = _mm_setr_epi8(
+      1, 2, 3, 5, 6, 7, 9, 10, 11, 13, 14, 15, -1, -1, -1, -1 );
+   const auto mask = _mm_set1_epi8( static_cast< char >( 0xFC ) );
+   size_t i = 0;
+
+   // the 16 byte store writes 4 bytes beyond the 12 result bytes,
+   // which must still be inside the output
+   for( ; i + 6 <= n; i += 4 ){
+      const auto c = _mm_loadu_si128(
+         reinterpret_cast< const __m128i * >( in + i ) );
+      _mm_storeu_si128(
+         reinterpret_cast< __m128i * >( out + 3 * i ),
+         _mm_and_si128( _mm_shuffle_epi8( c, shuffle ), mask ) );
+   }
+   return i;
+}
+
+// the rgb332 value in the low byte of each 32-bit lane
+static __m128i pixel_rgb332_ssse3( const color * in ){
+   const auto c = _mm_loadu_si128( reinterpret_cast< const __m128i * >( in ) );
+   return _mm_or_si128(
+      _mm_or_si128(
+         _mm_and_si128( _mm_srli_epi32( c, 8 ), _mm_set1_epi32( 0xE0 ) ),
+         _mm_and_si128( _mm_srli_epi32( c, 19 ), _mm_set1_epi32( 0x1C ) ) ),
+      _mm_srli_epi32( c, 30 ) );
+}
+
+static size_t pixel_convert_rgb332_ssse3(
+   const color * in, size_t n, uint8_t * out
+){
+   const auto low = _mm_setr_epi8(
+      0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 );
+   const auto high = _mm_setr_epi8(
+      -1, -1, -1, -1, 0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1 );
+   size_t i = 0;
+   for( ; i + 8 <= n; i += 8 ){
+      _mm_storel_epi64(
+         reinterpret_cast< __m128i * >( out + i ),
+         _mm_or_si128(
+            _mm_shuffle_epi8( pixel_rgb332_ssse3( in + i ), low ),
+            _mm_shuffle_epi8( pixel_rgb332_ssse3( in + i + 4 ), high ) ) );
+   }
+   return i;
+}
+
+// bit j of the index is pixel j, bit 3 - j of the value is pixel j:
+// the mono kernels use this to put the leftmost pixel in the msb
+static constexpr uint8_t pixel_mono_reverse[ 16 ] = {
+   0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE,
+   0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7, 0xF
+};
+
+// the brightness ( red * 77 + green * 150 + blue * 29 ) in each 
+// 32-bit lane: the pairs ( red, blue ) and ( green, 0 ) are 
+// multiplied and added as 16-bit words
+static __m128i pixel_brightness_ssse3( const color * in ){
+   const auto c = _mm_loadu_si128( reinterpret_cast< const __m128i * >( in ) );
+   return _mm_add_epi32(
+      _mm_madd_epi16(
+         _mm_and_si128( _mm_srli_epi32( c, 8 ), _mm_set1_epi32( 0x00FF00FF ) ),
+         _mm_set1_epi32( 77 | ( 29 << 16 ) ) ),
+      _mm_madd_epi16(
+         _mm_and_si128( _mm_srli_epi32( c, 16 ), _mm_set1_epi32( 0xFF ) ),
+         _mm_set1_epi32( 150 ) ) );
+}
+
+// the mono pixels of 4 colors, pixel j in bit j
+static int pixel_mono_ssse3( const color * in ){
+   return _mm_movemask_ps( _mm_castsi128_ps( _mm_cmpgt_epi32(
+      pixel_brightness_ssse3( in ), _mm_set1_epi32( 128 * 256 - 1 ) ) ) );
+}
+
+static size_t pixel_convert_mono_ssse3(
+   const color * in, size_t n, uint8_t * out
+){
+   size_t i = 0;
+   for( ; i + 8 <= n; i += 8 ){
+      out[ i / 8 ] = static_cast< uint8_t >(
+           ( pixel_mono_reverse[ pixel_mono_ssse3( in + i ) ] << 4 )
+         | pixel_mono_reverse[ pixel_mono_ssse3( in + i + 4 ) ] );
+   }
+   return i;
+}
+
+#endif // defined( __SSSE3__ ) || defined( __AVX2__ )
+
+#if defined( __AVX2__ )
+
+static size_t pixel_convert_rgb565_avx2(
+   const color * in, size_t n, uint8_t * out
+){
+   const auto shuffle = _mm256_setr_epi8(
+      1, 0, 5, 4, 9, 8, 13, 12, -1, -1, -1, -1, -1, -1, -1, -1,
+      1, 0, 5, 4, 9, 8, 13, 12, -1, -1, -1, -1, -1, -1, -1, -1 );
+   size_t i = 0;
+   for( ; i + 8 <= n; i += 8 ){
+      const auto c = _mm256_loadu_si256(
+         reinterpret_cast< const __m256i * >( in + i ) );
+      const auto v = _mm256_or_si256(
+         _mm256_or_si256(
+            _mm256_and_si256( c, _mm256_set1_epi32( 0xF800 ) ),
+            _mm256_and_si256(
+               _mm256_srli_epi32( c, 13 ), _mm256_set1_epi32( 0x07E0 ) ) ),
+         _mm256_srli_epi32( c, 27 ) );
+
+      // the 8 result bytes of each 128-bit lane to the low 16 bytes
+      const auto r = _mm256_permute4x64_epi64(
+         _mm256_shuffle_epi8( v, shuffle ), 0x08 );
+      _mm_storeu_si128(
+         reinterpret_cast< __m128i * >( out + 2 * i ),
+         _mm256_castsi256_si128( r ) );
+   }
+   return i;
+}
+
+static size_t pixel_convert_rgb666_avx2(
+   const color * in, size_t n, uint8_t * out
+){
+   const auto shuffle = _mm256_setr_epi8(
+      1, 2, 3, 5, 6, 7, 9, 10, 11, 13, 14, 15, -1, -1, -1, -1,
+      1, 2, 3, 5, 6, 7, 9, 10, 11, 13, 14, 15, -1, -1, -1, -1 );
+   const auto mask = _mm256_set1_epi8( static_cast< char >( 0xFC ) );
+   size_t i = 0;
+
+   // each 16 byte store writes 4 bytes beyond its 12 result bytes,
+   // which must still be inside the output
+   for( ; i + 10 <= n; i += 8 ){
+      const auto c = _mm256_loadu_si256(
+         reinterpret_cast< const __m256i * >( in + i ) );
+      const auto r = _mm256_and_si256( _mm256_shuffle_epi8( c, shuffle ), mask );
+      _mm_storeu_si128(
+         reinterpret_cast< __m128i * >( out + 3 * i ),
+         _mm256_castsi256_si128( r ) );
+      _mm_storeu_si128(
+         reinterpret_cast< __m128i * >( out + 3 * i + 12 ),
+         _mm256_extracti128_si256( r, 1 ) );
+   }
+   return i;
+}
+
+static size_t pixel_convert_rgb332_avx2(
+   const color * in, size_t n, uint8_t * out
+){
+   const auto shuffle = _mm256_setr_epi8(
+      0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 );
+   size_t i = 0;
+   for( ; i + 8 <= n; i += 8 ){
+      const auto c = _mm256_loadu_si256(
+         reinterpret_cast< const __m256i * >( in + i ) );
+      const auto v = _mm256_or_si256(
+         _mm256_or_si256(
+            _mm256_and_si256(
+               _mm256_srli_epi32( c, 8 ), _mm256_set1_epi32( 0xE0 ) ),
+            _mm256_and_si256(
+               _mm256_srli_epi32( c, 19 ), _mm256_set1_epi32( 0x1C ) ) ),
+         _mm256_srli_epi32( c, 30 ) );
+
+      // the 4 result bytes of each 128-bit lane to the low 8 bytes
+      const auto r = _mm256_permutevar8x32_epi32(
+         _mm256_shuffle_epi8( v, shuffle ),
+         _mm256_setr_epi32( 0, 4, 0, 0, 0, 0, 0, 0 ) );
+      _mm_storel_epi64(
+         reinterpret_cast< __m128i * >( out + i ),
+         _mm256_castsi256_si128( r ) );
+   }
+   return i;
+}
+
+static size_t pixel_convert_mono_avx2(
+   const color * in, size_t n, uint8_t * out
+){
+   const auto rb_weights = _mm256_set1_epi32( 77 | ( 29 << 16 ) );
+   const auto g_weights = _mm256_set1_epi32( 150 );
+   const auto threshold = _mm256_set1_epi32( 128 * 256 - 1 );
+   size_t i = 0;
+   for( ; i + 8 <= n; i += 8 ){
+      const auto c = _mm256_loadu_si256(
+         reinterpret_cast< const __m256i * >( in + i ) );
+      const auto brightness = _mm256_add_epi32(
+         _mm256_madd_epi16(
+            _mm256_and_si256(
+               _mm256_srli_epi32( c, 8 ), _mm256_set1_epi32( 0x00FF00FF ) ),
+            rb_weights ),
+         _mm256_madd_epi16(
+            _mm256_and_si256(
+               _mm256_srli_epi32( c, 16 ), _mm256_set1_epi32( 0xFF ) ),
+            g_weights ) );
+      const auto set = _mm256_movemask_ps( _mm256_castsi256_ps(
+         _mm256_cmpgt_epi32( brightness, threshold ) ) );
+      out[ i / 8 ] = static_cast< uint8_t >(
+           ( pixel_mono_reverse[ set & 0x0F ] << 4 )
+         | pixel_mono_reverse[ set >> 4 ] );
+   }
+   return i;
+}
+
+#endif // defined( __AVX2__ )
+
+#if defined( __ARM_NEON )
+
+// The NEON kernels load 8 colors, de-interleaved into
+// special, red, green and blue vectors.
+
+static size_t pixel_convert_rgb565_neon(
+   const color * in, size_t n, uint8_t * out
+){
+   size_t i = 0;
+   for( ; i + 8 <= n; i += 8 ){
+      const auto c = vld4_u8( reinterpret_cast< const uint8_t * >( in + i ) );
+      uint8x8x2_t r;
+      r.val[ 0 ] = vorr_u8(
+         vand_u8( c.val[ 1 ], vdup_n_u8( 0xF8 ) ),
+         vshr_n_u8( c.val[ 2 ], 5 ) );
+      r.val[ 1 ] = vorr_u8(
+         vshl_n_u8( vand_u8( c.val[ 2 ], vdup_n_u8( 0x1C ) ), 3 ),
+         vshr_n_u8( c.val[ 3 ], 3 ) );
+      vst2_u8( out + 2 * i, r );
+   }
+   return i;
+}
+
+static size_t pixel_convert_rgb666_neon(
+   const color * in, size_t n, uint8_t * out
+){
+   const auto mask = vdup_n_u8( 0xFC );
+   size_t i = 0;
+   for( ; i + 8 <= n; i += 8 ){
+      const auto c = vld4_u8( reinterpret_cast< const uint8_t * >( in + i ) );
+      uint8x8x3_t r;
+      r.val[ 0 ] = vand_u8( c.val[ 1 ], mask );
+      r.val[ 1 ] = vand_u8( c.val[ 2 ], mask );
+      r.val[ 2 ] = vand_u8( c.val[ 3 ], mask );
+      vst3_u8( out + 3 * i, r );
+   }
+   return i;
+}
+
+static size_t pixel_convert_rgb332_neon(
+   const color * in, size_t n, uint8_t * out
+){
+   const auto mask = vdup_n_u8( 0xE0 );
+   size_t i = 0;
+   for( ; i + 8 <= n; i += 8 ){
+      const auto c = vld4_u8( reinterpret_cast< const uint8_t * >( in + i ) );
+      vst1_u8( out + i, vorr_u8(
+         vorr_u8(
+            vand_u8( c.val[ 1 ], mask ),
+            vshr_n_u8( vand_u8( c.val[ 2 ], mask ), 3 ) ),
+         vshr_n_u8( c.val[ 3 ], 6 ) ) );
+   }
+   return i;
+}
+
+static size_t pixel_convert_mono_neon(
+   const color * in, size_t n, uint8_t * out
+){
+   static const uint8_t weights[ 8 ] = 
+      { 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01 };
+   const auto bits = vld1_u8( weights );
+   size_t i = 0;
+   for( ; i + 8 <= n; i += 8 ){
+      const auto c = vld4_u8( reinterpret_cast< const uint8_t * >( in + i ) );
+      auto brightness = vmull_u8( c.val[ 1 ], vdup_n_u8( 77 ) );
+      brightness = vmlal_u8( brightness, c.val[ 2 ], vdup_n_u8( 150 ) );
+      brightness = vmlal_u8( brightness, c.val[ 3 ], vdup_n_u8( 29 ) );
+
+      // 0xFF for a pixel that is set, masked to its bit, added up
+      auto b = vand_u8( 
+         vmovn_u16( vcgeq_u16( brightness, vdupq_n_u16( 128 * 256 ) ) ),
+         bits );
+      b = vpadd_u8( b, b );
+      b = vpadd_u8( b, b );
+      b = vpadd_u8( b, b );
+      out[ i / 8 ] = vget_lane_u8( b, 0 );
+   }
+   return i;
+}
+
+#endif // defined( __ARM_NEON )
+
+void pixel_convert(
+   pixel_format format,
+   const color * in,
+   size_t n,
+   uint8_t * out,
+   pixel_kernel kernel
+){
+   // the vector kernel converts a multiple of its vector length
+   // (for mono: of 8 pixels), the scalar kernel converts the 
+   // remaining pixels
+   size_t done = 0;
+   switch( kernel ){
+
+      #if defined( __SSSE3__ ) || defined( __AVX2__ )
+         case pixel_kernel::ssse3:
+            done =
+                 ( format == pixel_format::rgb565 )
+                  ? pixel_convert_rgb565_ssse3( in, n, out )
+               : ( format == pixel_format::rgb666 )
+                  ? pixel_convert_rgb666_ssse3( in, n, out )
+               : ( format == pixel_format::rgb332 )
+                  ? pixel_convert_rgb332_ssse3( in, n, out )
+               : pixel_convert_mono_ssse3( in, n, out );
+            break;
+      #endif
+
+      #if defined( __AVX2__ )
+         case pixel_kernel::avx2:
+            done =
+                 ( format == pixel_format::rgb565 )
+                  ? pixel_convert_rgb565_avx2( in, n, out )
+               : ( format == pixel_format::rgb666 )
+                  ? pixel_convert_rgb666_avx2( in, n, out )
+               : ( format == pixel_format::rgb332 )
+                  ? pixel_convert_rgb332_avx2( in, n, out )
+               : pixel_convert_mono_avx2( in, n, out );
+            break;
+      #endif
+
+      #if defined( __ARM_NEON )
+         case pixel_kernel::neon:
+            done =
+                 ( format == pixel_format::rgb565 )
+                  ? pixel_convert_rgb565_neon( in, n, out )
+               : ( format == pixel_format::rgb666 )
+                  ? pixel_convert_rgb666_neon( in, n, out )
+               : ( format == pixel_format::rgb332 )
+                  ? pixel_convert_rgb332_neon( in, n, out )
+               : pixel_convert_mono_neon( in, n, out );
+            break;
+      #endif
+
+      default:
+         break;
+   }
+
+   switch( format ){
+      case pixel_format::rgb565:
+         pixel_convert_rgb565_scalar( in, done, n, out );
+         break;
+      case pixel_format::rgb666:
+         pixel_convert_rgb666_scalar( in, done, n, out );
+         break;
+      case pixel_format::rgb332:
+         pixel_convert_rgb332_scalar( in, done, n, out );
+         break;
+      default:
+         pixel_convert_mono_scalar( in, done, n, out );
+         break;
+   }
+}
+
+// a value of bits bits, with its bits replicated into 8 bits
+static uint8_t pixel_expand( uint_fast8_t value, int bits ){
+   uint_fast16_t result = 0;
+   for( int shift = 8 - bits; shift > - bits; shift -= bits ){
+      result |= ( shift >= 0 ) ? ( value << shift ) : ( value >> - shift );
+   }
+   return static_cast< uint8_t >( result );
+}
+
+void pixel_unconvert(
+   pixel_format format,
+   const uint8_t * in,
+   size_t n,
+   color * out
+){
+   for( size_t i = 0; i < n; ++i ){
+      switch( format ){
+         case pixel_format::rgb565: {
+            const uint_fast16_t v = ( in[ 2 * i ] << 8 ) | in[ 2 * i + 1 ];
+            out[ i ] = color(
+               pixel_expand( ( v >> 11 ) & 0x1F, 5 ),
+               pixel_expand( ( v >>  5 ) & 0x3F, 6 ),
+               pixel_expand( ( v >>  0 ) & 0x1F, 5 ) );
+            break;
+         }
+         case pixel_format::rgb666:
+            out[ i ] = color(
+               pixel_expand( in[ 3 * i     ] >> 2, 6 ),
+               pixel_expand( in[ 3 * i + 1 ] >> 2, 6 ),
+               pixel_expand( in[ 3 * i + 2 ] >> 2, 6 ) );
+            break;
+         case pixel_format::rgb332:
+            out[ i ] = color(
+               pixel_expand( ( in[ i ] >> 5 ) & 0x07, 3 ),
+               pixel_expand( ( in[ i ] >> 2 ) & 0x07, 3 ),
+               pixel_expand( ( in[ i ] >> 0 ) & 0x03, 2 ) );
+            break;
+         case pixel_format::mono:
+            out[ i ] = ( in[ i / 8 ] & ( 0x80 >> ( i % 8 ) ) ) ? white : black;
+            break;
+      }
+   }
+}
+
+#endif // _HWLIB_ONCE
+
+}; // namespace hwlib
@@ -30,6 +30,14 @@ private:
       w.write( start + pos, col );
    }      
 
+   void write_span_implementation(
+      xy pos,
+      int_fast16_t n,
+      color col
+   ) override {
+      w.write_span( start + pos, n, col );
+   }
+
 public:      
 
    /// create a window_part from a larger window, its origin and its size
@@ -68,6 +76,14 @@ private:
       w.write( pos, - col );
    }      
 
+   void write_span_implementation(
+      xy pos,
+      int_fast16_t n,
+      color col
+   ) override {
+      w.write_span( pos, n, - col );
+   }
+
    void flush() override {
       w.flush();
    }      
@@ -89,6 +105,61 @@ public:
 }; // class class window_invert
 
 
+// ==========================================================================
+
+/// window_clip (restrict writes to a part of a window)
+///
+/// A window_clip has the same size and coordinates as its larger window,
+/// but it ignores writes to pixels outside its clip area.
+class window_clip_t : public window {
+private:
+
+   window & w;
+   box area;
+
+   void write_implementation(
+      xy pos,
+      color col
+   ) override {
+      if( area.contains( pos ) ){
+         w.write( pos, col );
+      }
+   }
+
+   void write_span_implementation(
+      xy pos,
+      int_fast16_t n,
+      color col
+   ) override {
+      if( ( pos.y < area.start.y ) || ( pos.y >= area.end.y ) ){
+         return;
+      }
+      const auto first = pos.x > area.start.x ? pos.x : area.start.x;
+      const auto last  = pos.x + n < area.end.x ? pos.x + n : area.end.x;
+      w.write_span( xy( first, pos.y ), last - first, col );
+   }
+
+public:
+
+   /// create a window_clip from a window and a clip area
+   ///
+   /// This call constructs a window_clip from a window and
+   /// the area that can be written.
+   /// The foreground and background color are copied from the larger
+   /// window.
+   window_clip_t( window & w, box area ):
+      window( w.size, w.foreground, w.background ),
+      w( w ),
+      area( area )
+   {}
+
+   void flush() override {
+      w.flush();
+   }
+
+}; // class window_clip_t
+
+
 // ===========================================================================
 //
 // constructor functions
@@ -101,6 +172,9 @@ window_part_t part( window & w, xy start, xy size );
 /// return the inverse of a window
 window_invert_t invert( window & w );
 
+/// return a window that writes only to an area of a window
+window_clip_t clip( window & w, box area );
+
 
 // ===========================================================================
 //
@@ -116,7 +190,11 @@ window_part_t part( window & w, xy start, xy size ){
 
 window_invert_t invert( window & w ){
    return window_invert_t( w );
-}   
+}
+
+window_clip_t clip( window & w, box area ){
+   return window_clip_t( w, area );
+}
 
 #endif // _HWLIB_ONCE
 
@@ -0,0 +1,355 @@
+// ==========================================================================
+//
+// File      : hwlib-graphics-window-dither.hpp
+// Part of   : C++ hwlib library for close-to-the-hardware OO programming
+// Copyright : wouter@voti.nl 2017-2019
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// included only via hwlib.hpp, hence no multiple-include guard is needed
+
+// this file contains Doxygen lines
+/// @file
+
+namespace hwlib {
+
+
+// ==========================================================================
+//
+// dithering
+//
+// ==========================================================================
+
+/// \cond INTERNAL
+
+// the ordered dither thresholds ( 0 .. 15 ) for a 4 x 4 pixel area
+constexpr uint8_t dither_bayer[ 4 ][ 4 ] = {
+   {  0,  8,  2, 10 },
+   { 12,  4, 14,  6 },
+   {  3, 11,  1,  9 },
+   { 15,  7, 13,  5 }
+};
+
+// the brightness ( 0 .. 255 ) of a color
+constexpr int_fast16_t dither_gray( color c ){
+   return ( c.red * 77 + c.green * 150 + c.blue * 29 ) >> 8;
+}
+
+// the channel value ( 0 .. 255 ) of a level ( 0 .. top )
+constexpr uint8_t dither_value( int_fast16_t level, int_fast16_t top ){
+   return ( level * 255 ) / top;
+}
+
+// the value ( 0 .. 255 ) of one of top + 1 levels, chosen by
+// comparing the channel value v ( 0 .. 255 ) to threshold t ( 0 .. 15 )
+constexpr uint8_t dither_threshold( int_fast16_t v, int_fast16_t top, int t ){
+   return dither_value(
+      ( static_cast< int_fast32_t >( v ) * top * 32 + ( 2 * t + 1 ) * 255 )
+         / ( 255 * 32 ),
+      top );
+}
+
+/// \endcond
+
+
+// ==========================================================================
+//
+// window_dither_ordered_t
+//
+// ==========================================================================
+
+/// window_dither_ordered (ordered dithering of writes to a window)
+///
+/// A window_dither_ordered writes to its larger window
+/// only the colors that the display can show, using a 4 x 4 Bayer
+/// pattern to approximate the other colors.
+///
+/// With bits == 0 the display is monochrome:
+/// the brightness of each pixel is dithered to black or white.
+/// Otherwise each color channel is dithered to 2 ^ bits levels.
+/// For instance, use bits == 2 for a display that
+/// uses the 2 most significant bits of each channel.
+///
+/// Ordered dithering needs no memory, and the result for a pixel
+/// doesn't depend on the order in which the pixels are written.
+class window_dither_ordered_t : public window {
+private:
+
+   window & w;
+   int_fast16_t top;
+
+   color dither( xy pos, color col ) const {
+      const auto t = dither_bayer[ pos.y & 0x03 ][ pos.x & 0x03 ];
+      if( top == 0 ){
+         return dither_threshold( dither_gray( col ), 1, t ) ? white : black;
+      }
+      return color(
+         dither_threshold( col.red,   top, t ),
+         dither_threshold( col.green, top, t ),
+         dither_threshold( col.blue,  top, t ) );
+   }
+
+   void write_implementation( xy pos, color col ) override {
+      w.write( pos, dither( pos, col ) );
+   }
+
+   void write_span_implementation(
+      xy pos,
+      int_fast16_t n,
+      color col
+   ) override {
+
+      // write the runs of equal dithered pixels
+      int_fast16_t first = 0;
+      auto run = dither( pos, col );
+      for( int_fast16_t i = 1; i < n; ++i ){
+         const auto next = dither( pos + xy( i, 0 ), col );
+         if( next != run ){
+            w.write_span( pos + xy( first, 0 ), i - first, run );
+            first = i;
+            run = next;
+         }
+      }
+      w.write_span( pos + xy( first, 0 ), n - first, run );
+   }
+
+public:
+
+   /// create a window_dither_ordered from a window and its color depth
+   ///
+   /// This call constructs a window_dither_ordered for a window that
+   /// shows bits bits per color channel, or is monochrome (bits == 0).
+   /// The foreground and background color are copied from the larger
+   /// window.
+   window_dither_ordered_t( window & w, uint_fast8_t bits = 0 ):
+      window( w.size, w.foreground, w.background ),
+      w( w ),
+      top( ( bits == 0 ) ? 0 : ( 1 << bits ) - 1 )
+   {}
+
+   void flush() override {
+      w.flush();
+   }
+
+}; // class window_dither_ordered_t
+
+
+// ==========================================================================
+//
+// window_dither_diffusion_base
+//
+// ==========================================================================
+
+/// error diffusion (Floyd-Steinberg) dithering of writes to a window
+///
+/// A window_dither_diffusion writes to its larger window
+/// only the colors that the display can show.
+/// The difference (error) between the color of a pixel and the color
+/// that is written is spread over the neighboring pixels to the right
+/// and on the next row, which gives a better approximation of
+/// gray levels and gradients than ordered dithering.
+///
+/// The errors are kept for only two rows, in fixed point.
+/// Hence the best result is achieved when the pixels
+/// are written from left to right and from top to bottom,
+/// like window::write( image ), clear() and most drawables do.
+/// A write to a row that is not the current or the next row
+/// discards the errors.
+///
+/// Use window_dither_diffusion< max_width, bits > to declare one,
+/// and window_dither_diffusion_base for references.
+class window_dither_diffusion_base : public window {
+private:
+
+   window & w;
+   int16_t * errors;
+   int_fast16_t stride;
+   int_fast16_t channels;
+   int_fast16_t top;
+
+   // the row for which errors[ current ] is valid
+   int_fast16_t row;
+   int_fast16_t current;
+
+   // only window_dither_diffusion< N, B > is allowed to construct
+   template< int, int > friend class window_dither_diffusion;
+
+   window_dither_diffusion_base(
+      window & w,
+      int16_t * errors,
+      int_fast16_t stride,
+      uint_fast8_t bits
+   ):
+      window(
+         xy( w.size.x < stride ? w.size.x : stride, w.size.y ),
+         w.foreground,
+         w.background ),
+      w( w ),
+      errors( errors ),
+      stride( stride ),
+      channels( ( bits == 0 ) ? 1 : 3 ),
+      top( ( bits == 0 ) ? 1 : ( 1 << bits ) - 1 ),
+      row( -2 ),
+      current( 0 )
+   {
+      clear_errors( 0 );
+      clear_errors( 1 );
+   }
+
+   int16_t & error( int_fast16_t r, int_fast16_t c, int_fast16_t x ){
+      return errors[ ( ( r * channels ) + c ) * stride + x ];
+   }
+
+   void clear_errors( int_fast16_t r ){
+      for( int_fast16_t i = 0; i < channels * stride; ++i ){
+         errors[ r * channels * stride + i ] = 0;
+      }
+   }
+
+   // make the errors for row y available
+   void select_row( int_fast16_t y ){
+      if( y == row + 1 ){
+         clear_errors( current );
+         current ^= 1;
+      } else if( y != row ){
+         clear_errors( 0 );
+         clear_errors( 1 );
+      }
+      row = y;
+   }
+
+   // dither one channel value of pixel x of the selected row
+   uint8_t diffuse( int_fast16_t c, int_fast16_t x, int_fast16_t value ){
+      auto & here = error( current, c, x );
+      auto v = value + here;
+      here = 0;
+      v = ( v < 0 ) ? 0 : ( ( v > 255 ) ? 255 : v );
+
+      const auto result = dither_value( ( v * top + 127 ) / 255, top );
+      const auto e = v - result;
+
+      const auto next = current ^ 1;
+      if( x + 1 < size.x ){
+         error( current, c, x + 1 ) += ( e * 7 ) / 16;
+         error( next,    c, x + 1 ) += ( e * 1 ) / 16;
+      }
+      if( x > 0 ){
+         error( next,    c, x - 1 ) += ( e * 3 ) / 16;
+      }
+      error( next, c, x ) += ( e * 5 ) / 16;
+      return result;
+   }
+
+   color dither( xy pos, color col ){
+      if( channels == 1 ){
+         return diffuse( 0, pos.x, dither_gray( col ) ) ? white : black;
+      }
+      return color(
+         diffuse( 0, pos.x, col.red ),
+         diffuse( 1, pos.x, col.green ),
+         diffuse( 2, pos.x, col.blue ) );
+   }
+
+   void write_implementation( xy pos, color col ) override {
+      select_row( pos.y );
+      w.write( pos, dither( pos, col ) );
+   }
+
+   void write_span_implementation(
+      xy pos,
+      int_fast16_t n,
+      color col
+   ) override {
+      select_row( pos.y );
+
+      // write the runs of equal dithered pixels
+      int_fast16_t first = 0;
+      auto run = dither( pos, col );
+      for( int_fast16_t i = 1; i < n; ++i ){
+         const auto next = dither( pos + xy( i, 0 ), col );
+         if( next != run ){
+            w.write_span( pos + xy( first, 0 ), i - first, run );
+            first = i;
+            run = next;
+         }
+      }
+      w.write_span( pos + xy( first, 0 ), n - first, run );
+   }
+
+public:
+
+   void flush() override {
+      w.flush();
+   }
+
+}; // class window_dither_diffusion_base
+
+
+// ==========================================================================
+//
+// window_dither_diffusion< max_width, bits >
+//
+// ==========================================================================
+
+/// concrete error diffusion dithering window
+///
+/// This is the concrete error diffusion window class template.
+/// The max_width is the width of the largest window it can
+/// be used for: a wider window is used only up to that width.
+/// With bits == 0 the window is monochrome:
+/// the brightness of each pixel is dithered to black or white.
+/// Otherwise each color channel is dithered to 2 ^ bits levels.
+///
+/// The memory use is 2 * max_width 16-bit error values for
+/// monochrome, and 3 times as much for color.
+template< int max_width, int bits = 0 >
+class window_dither_diffusion : public window_dither_diffusion_base {
+private:
+
+   static_assert( ( bits >= 0 ) && ( bits <= 8 ), "bits must be 0 .. 8" );
+
+   // the errors for two rows
+   int16_t content[ 2 * ( ( bits == 0 ) ? 1 : 3 ) * max_width ];
+
+public:
+
+   /// create an error diffusion dithering window for a window
+   ///
+   /// The foreground and background color are copied from the larger
+   /// window.
+   window_dither_diffusion( window & w ):
+      window_dither_diffusion_base( w, content, max_width, bits )
+   {}
+
+}; // class window_dither_diffusion
+
+
+// ===========================================================================
+//
+// constructor functions
+//
+// ===========================================================================
+
+/// return a window that writes ordered dithered colors to a window
+window_dither_ordered_t dither_ordered( window & w, uint_fast8_t bits = 0 );
+
+
+// ===========================================================================
+//
+// implementations
+//
+// ===========================================================================
+
+#ifdef _HWLIB_ONCE
+
+window_dither_ordered_t dither_ordered( window & w, uint_fast8_t bits ){
+   return window_dither_ordered_t( w, bits );
+}
+
+#endif // _HWLIB_ONCE
+
+}; // namespace hwlib
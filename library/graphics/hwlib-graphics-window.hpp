@@ -58,6 +58,26 @@ private:
       }          
    }   
    
+   /// write a horizontal span of pixels - implementation
+   ///
+   /// This NVI function writes the color col to n pixels, 
+   /// starting at location pos and going to the right.
+   /// The span is guaranteed to be within the window, n is
+   /// guaranteed to be > 0, and the color is guaranteed 
+   /// to be not transparent or unspecified.
+   ///
+   /// The default implementation writes each pixel.
+   /// A concrete window can provide a faster implementation.
+   virtual void write_span_implementation(
+      xy pos,
+      int_fast16_t n,
+      color col
+   ){
+      for( int_fast16_t i = 0; i < n; ++i ){
+         write_implementation( xy( pos.x + i, pos.y ), col );
+      }
+   }
+   
 public:
 
    /// the size of the window
@@ -107,6 +127,33 @@ public:
       }   
    }
 
+   /// write a horizontal span of pixels
+   ///
+   /// This function writes the color col to n pixels, starting
+   /// at location pos and going to the right.
+   /// The part of the span that is outside the window is ignored.
+   /// If the color is transparent the call has no effect.
+   /// When no color is specified, the window's foreground color is used.
+   void write_span(
+      xy pos,
+      int_fast16_t n,
+      color col = unspecified
+   ){
+      if( col.is_transparent() || ( pos.y < 0 ) || ( pos.y >= size.y ) ){
+         return;
+      }
+      if( pos.x < 0 ){
+         n += pos.x;
+         pos.x = 0;
+      }
+      if( n > size.x - pos.x ){
+         n = size.x - pos.x;
+      }
+      if( n > 0 ){
+         write_span_implementation( pos, n, col.specify( foreground ) );
+      }
+   }
+
    /// write a rectangle of pixels
    /// 
    /// This function writes a rectangle of pixels, as specified by img,
@@ -115,9 +162,7 @@ public:
       xy pos, 
       const image & img
    ){                 
-      for( const auto p : all( img.size ) ){
-         write( pos + p, img[ p ] );
-      }
+      img.write_to( *this, pos );
    }
    
    /// clear the window
@@ -143,4 +188,21 @@ public:
    
 }; // class window
 
+
+// ===========================================================================
+//
+// implementations
+//
+// ===========================================================================
+
+#ifdef _HWLIB_ONCE
+
+void image::write_to( window & w, xy pos ) const {
+   for( const auto p : all( size ) ){
+      w.write( pos + p, read( p ) );
+   }
+}
+
+#endif // _HWLIB_ONCE
+
 }; // namespace hwlib
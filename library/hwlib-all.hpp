@@ -32,6 +32,13 @@
 #include <numeric>
 #include <cmath>
 
+#if defined( __SSSE3__ ) || defined( __AVX2__ )
+   #include <immintrin.h>
+#endif
+#if defined( __ARM_NEON )
+   #include <arm_neon.h>
+#endif
+
 #include HWLIB_INCLUDE( core/hwlib-defines.hpp )
 #include HWLIB_INCLUDE( core/hwlib-targets.hpp )
 #include HWLIB_INCLUDE( core/hwlib-panic.hpp )
@@ -39,6 +46,7 @@
 #include HWLIB_INCLUDE( core/hwlib-common.hpp )
 #include HWLIB_INCLUDE( core/hwlib-ratio.hpp )
 #include HWLIB_INCLUDE( core/hwlib-background.hpp )
+#include HWLIB_INCLUDE( core/hwlib-ring-buffer.hpp )
 #include HWLIB_INCLUDE( core/hwlib-xy.hpp )
 #include HWLIB_INCLUDE( core/hwlib-color.hpp )
 #include HWLIB_INCLUDE( core/hwlib-random.hpp )
@@ -62,14 +70,21 @@
 #include HWLIB_INCLUDE( ports/hwlib-port-demos.hpp )
 
 #include HWLIB_INCLUDE( char-io/hwlib-ostream.hpp )
+#include HWLIB_INCLUDE( char-io/hwlib-ostream-buffered.hpp )
 #include HWLIB_INCLUDE( char-io/hwlib-istream.hpp )
 #include HWLIB_INCLUDE( char-io/hwlib-bb-uart.hpp )
+#include HWLIB_INCLUDE( char-io/hwlib-uart-buffered.hpp )
+#include HWLIB_INCLUDE( char-io/hwlib-stream-mux.hpp )
 #include HWLIB_INCLUDE( char-io/hwlib-console.hpp )
 #include HWLIB_INCLUDE( char-io/hwlib-terminal.hpp )
+#include HWLIB_INCLUDE( char-io/hwlib-terminal-buffered.hpp )
 #include HWLIB_INCLUDE( char-io/hwlib-terminal-demos.hpp )
 
 #include HWLIB_INCLUDE( core/hwlib-test.hpp )
 #include HWLIB_INCLUDE( core/hwlib-string.hpp )
+#include HWLIB_INCLUDE( char-io/hwlib-format.hpp )
+#include HWLIB_INCLUDE( char-io/hwlib-istream-lines.hpp )
+#include HWLIB_INCLUDE( char-io/hwlib-log.hpp )
 
 #include HWLIB_INCLUDE( core/hwlib-adc.hpp )
 #include HWLIB_INCLUDE( core/hwlib-dac.hpp )
@@ -78,17 +93,23 @@
 #include HWLIB_INCLUDE( core/hwlib-i2c.hpp )
 #include HWLIB_INCLUDE( core/hwlib-spi.hpp )
 
+#include HWLIB_INCLUDE( graphics/hwlib-graphics-pixel-format.hpp )
 #include HWLIB_INCLUDE( graphics/hwlib-graphics-image.hpp )
-#include HWLIB_INCLUDE( graphics/hwlib-graphics-image-decorators.hpp )
 #include HWLIB_INCLUDE( graphics/hwlib-graphics-font.hpp )
 #include HWLIB_INCLUDE( graphics/hwlib-graphics-window.hpp )
+#include HWLIB_INCLUDE( graphics/hwlib-graphics-image-decorators.hpp )
+#include HWLIB_INCLUDE( graphics/hwlib-graphics-image-rle.hpp )
 #include HWLIB_INCLUDE( graphics/hwlib-graphics-canvas.hpp )
 #include HWLIB_INCLUDE( graphics/hwlib-graphics-drawables.hpp )
 #include HWLIB_INCLUDE( graphics/hwlib-graphics-window-decorators.hpp )
+#include HWLIB_INCLUDE( graphics/hwlib-graphics-window-dither.hpp )
+#include HWLIB_INCLUDE( graphics/hwlib-graphics-display-list.hpp )
+#include HWLIB_INCLUDE( graphics/hwlib-graphics-compositor.hpp )
 #include HWLIB_INCLUDE( graphics/hwlib-graphics-window-demos.hpp )
 #include HWLIB_INCLUDE( graphics/hwlib-graphics-window-terminal.hpp )
 #include HWLIB_INCLUDE( graphics/hwlib-graphics-font-8x8.hpp )
 #include HWLIB_INCLUDE( graphics/hwlib-graphics-font-16x16.hpp )
+#include HWLIB_INCLUDE( graphics/hwlib-graphics-font-proportional.hpp )
 
 #include HWLIB_INCLUDE( peripherals/hwlib-pcf8574.hpp )
 #include HWLIB_INCLUDE( peripherals/hwlib-pcf8591.hpp )
@@ -108,9 +108,14 @@
 #endif
 
 /// - HWLIB_TARGET_native : Linux native 
+///   (headless, without SFML, when HWLIB_HEADLESS is defined)
 #ifdef HWLIB_TARGET_Linux
    #define HWLIB_TARGET
-   #include HWLIB_INCLUDE( targets/hwlib-native-sfml.hpp )
+   #ifdef HWLIB_HEADLESS
+      #include HWLIB_INCLUDE( targets/hwlib-native-linux.hpp )
+   #else
+      #include HWLIB_INCLUDE( targets/hwlib-native-sfml.hpp )
+   #endif
 #endif
 
 #ifdef HWLIB_TARGET_pyd
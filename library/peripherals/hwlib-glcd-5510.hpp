@@ -17,75 +17,79 @@
 
 namespace hwlib {
    
-/// Nokia 5510 B/W graphics LCD
+/// Nokia 5510 B/W graphics LCD on a SPI bus
 /// 
 /// This class implements an interface to the type of LCD 
-/// that was used in older Nokia telephones.
+/// that was used in older Nokia telephones (PCD8544 controller),
+/// connected to a SPI bus.
 /// It is a 84 columns x 48 lines black-and-white LCD.
 ///
-/// This type of LCD is cheap and available from lots of sources,
-/// but the quality is often abominable.
-///
-/// \image html lcd5510-empty.jpg
-///
-class glcd_5510 : public window {
+/// The pixels are kept in a buffer.
+/// A write only changes the buffer, flush() writes the banks 
+/// (rows of 8 pixels) that have changed to the LCD.
+/// The whole flush() is a single SPI transaction:
+/// the dc pin is switched between the addressing commands 
+/// and the pixel data, the sce pin stays low.
+/// 
+/// The LCD accepts a SPI clock of up to 4 MHz.
+class glcd_5510_spi_sce_res_dc : public window {
 private:
+
+   spi_bus & bus;
    pin_out & sce;
-   pin_out & res;
    pin_out & dc;
-   pin_out & sdin;
-   pin_out & sclk;
    
-   void send_byte( unsigned char d ){
-      for( uint_fast8_t i = 0; i < 8; i++ ){
-         sdin.write( d & 0x80 );
-         sclk.write( 1 );
-         d = d << 1;
-         sclk.write( 0 );
-      }
-   }    
+   // the banks (rows of 8 pixels) that must be written to the LCD,
+   // bit 0 for the top bank 
+   uint_fast8_t dirty;
    
-   void command( unsigned char d ){
-      dc.write( 0 );
-      sce.write( 0 );
-      send_byte( d );
-      sce.write( 1 );
-   }    
-
-   void data( unsigned char d ){
-      dc.write( 1 );
-      sce.write( 0 );
-      send_byte( d );
-      sce.write( 1 );
-   }    
+   uint8_t pixel_buffer[ 504 ];
    
-   void pixels( 
-      unsigned char x, 
-      unsigned char y, 
-      unsigned char d 
-   ){
-      command( 0x80 | x );   
-      command( 0x40 | y );  
-      data( d );
+   void write_implementation( 
+      xy pos, 
+      color col
+   ) override {
+      const uint_fast16_t a = pos.x + ( pos.y / 8 ) * 84;
+      const uint8_t m = 1 << ( pos.y % 8 );
+      const uint8_t d = ( col == black ) 
+         ? ( pixel_buffer[ a ] | m ) 
+         : ( pixel_buffer[ a ] & ~m );
+      if( d != pixel_buffer[ a ] ){
+         pixel_buffer[ a ] = d;
+         dirty |= 1 << ( pos.y / 8 );
+      }
    }
-
+   
+   void clear_implementation( color c ) override {
+      const uint8_t d = ( c == white ) ? 0 : 0xFF;
+      for( uint_fast16_t i = 0; i < 504; i++ ){
+         pixel_buffer[ i ] = d;
+      }         
+      dirty = 0x3F;
+   }
+   
 public:
+
+   /// send a command
+   void command( uint8_t d ){
+      dc.write( 0 );
+      auto t = bus.transaction( sce );
+      t.write( d );
+   }
    
-   /// create a 5510 LCD
+   /// create a 5510 LCD on a SPI bus
    /// 
-   /// This constructor creates a 5510 LCD from its interface pins.
-   glcd_5510( 
+   /// This constructor creates a 5510 LCD from the SPI bus 
+   /// and its sce, res and dc pins.
+   glcd_5510_spi_sce_res_dc( 
+      spi_bus & bus,
       pin_out & sce,
       pin_out & res,
-      pin_out & dc,
-      pin_out & sdin,
-      pin_out & sclk   
-   )
-      : window{ xy{ 84, 48 }, black, white },
-      sce( sce ), res( res ), dc( dc ), sdin( sdin ), sclk( sclk )
+      pin_out & dc
+   ):
+      window{ xy{ 84, 48 }, black, white },
+      bus( bus ), sce( sce ), dc( dc ), dirty( 0x3F ), pixel_buffer{}
    {
-   
-      sclk.write( 0 );
       wait_ms( 1 );
       sce.write( 1 );
       wait_ms( 1 );
@@ -96,50 +100,129 @@ public:
      
          // initialization according to
          // https://www.sparkfun.com/products/10168 - nee, andere
-      command( 0x21 );  // select exteded instructions
-      command( 0xC8 );  // Vop = 110000b
-      command( 0x06 );  // TCx = 00b
-      command( 0x13 );  // BSx = 100b
-      command( 0x20 );  // select basic instructions, horizontal addressing
-      command( 0x0C );  // normal mode   
+      static constexpr const uint8_t initialization[] = {
+         0x21,  // select exteded instructions
+         0xC8,  // Vop = 110000b
+         0x06,  // TCx = 00b
+         0x13,  // BSx = 100b
+         0x20,  // select basic instructions, horizontal addressing
+         0x0C   // normal mode   
+      };
+      dc.write( 0 );
+      auto t = bus.transaction( sce );
+      t.write( sizeof( initialization ), initialization );
    }   
    
-private:   
+   /// write the changed banks to the LCD
+   ///
+   /// The LCD uses horizontal addressing, so each run of adjacent 
+   /// changed banks is written as one block of pixel data,
+   /// after setting the address to the start of the run.
+   void flush() override {
+      if( dirty == 0 ){
+         return;
+      }
+      auto t = bus.transaction( sce );
+      for( uint_fast8_t bank = 0; bank < 6; ){
+         if( ( dirty & ( 1 << bank ) ) == 0 ){
+            ++bank;
+            continue;
+         }
+         uint_fast8_t end = bank + 1;
+         while( ( end < 6 ) && ( ( dirty & ( 1 << end ) ) != 0 ) ){
+            ++end;
+         }
+         dc.write( 0 );
+         t.write( (uint8_t) ( 0x80 | 0 ) );
+         t.write( (uint8_t) ( 0x40 | bank ) );
+         dc.write( 1 );
+         t.write( 84 * ( end - bank ), & pixel_buffer[ 84 * bank ] );
+         bank = end;
+      }
+      dirty = 0;
+   }
+   
+}; // class glcd_5510_spi_sce_res_dc
 
-   unsigned char pixel_buffer[ 504 ];
 
-   void write_implementation( 
-      xy pos, 
-      color col
+/// \cond INTERNAL
+
+// write-only bit-banged SPI bus for the 5510 LCD,
+// the same timing (no delays) as the old pin-based glcd_5510
+class glcd_5510_bit_banged_bus : public spi_bus {
+private:
+
+   pin_out & sdin;
+   pin_out & sclk;
+
+   void write_and_read( 
+      const size_t n, 
+      const uint8_t data_out[], 
+      uint8_t data_in[] 
    ) override {
-      uint_fast8_t a = pos.x + ( pos.y / 8 ) * 84;
-      uint_fast8_t m = 1 << ( pos.y % 8 );
-   
-      if( col == black ){
-         pixel_buffer[ a ] |= m;
-      } else {     
-         pixel_buffer[ a ] &= ~m;   
+      for( size_t i = 0; i < n; ++i ){
+         uint_fast8_t d = ( data_out == nullptr ) ? 0 : data_out[ i ];
+         for( uint_fast8_t j = 0; j < 8; j++ ){
+            sdin.write( d & 0x80 );
+            sclk.write( 1 );
+            d = d << 1;
+            sclk.write( 0 );
+         }
+         if( data_in != nullptr ){
+            data_in[ i ] = 0;
+         }
       }
    }
    
-public:   
-   
-   void clear_implementation( color c ) override {
-      unsigned char d = (( c == white ) ? 0 : 0xFF );
-      command( 0x80 | 0 );   
-      command( 0x40 | 0 );  
-      for( uint_fast16_t i = 0; i < 504; i++ ){
-         pixel_buffer[ i ] = d;
-      }         
+protected:
+
+   glcd_5510_bit_banged_bus( pin_out & sdin, pin_out & sclk ):
+      sdin( sdin ), sclk( sclk )
+   {
+      sclk.write( 0 );
    }
+
+}; // class glcd_5510_bit_banged_bus
+
+/// \endcond 
+
+
+/// Nokia 5510 B/W graphics LCD
+/// 
+/// This class implements an interface to the type of LCD 
+/// that was used in older Nokia telephones.
+/// It is a 84 columns x 48 lines black-and-white LCD.
+///
+/// This type of LCD is cheap and available from lots of sources,
+/// but the quality is often abominable.
+///
+/// This class is a glcd_5510_spi_sce_res_dc on a bit-banged SPI bus,
+/// created from the sdin and sclk pins.
+/// When the LCD is connected to the pins of a hardware SPI bus,
+/// use glcd_5510_spi_sce_res_dc with that bus instead.
+///
+/// \image html lcd5510-empty.jpg
+///
+class glcd_5510 : 
+   private glcd_5510_bit_banged_bus, 
+   public glcd_5510_spi_sce_res_dc 
+{
+public:
    
-   void flush() override {
-      command( 0x80 | 0 );   
-      command( 0x40 | 0 );  
-      for( uint_fast16_t i = 0; i < 504; i++ ){
-         data( pixel_buffer[ i ] );
-      }         
-   }
+   /// create a 5510 LCD
+   /// 
+   /// This constructor creates a 5510 LCD from its interface pins.
+   glcd_5510( 
+      pin_out & sce,
+      pin_out & res,
+      pin_out & dc,
+      pin_out & sdin,
+      pin_out & sclk   
+   ):
+      glcd_5510_bit_banged_bus( sdin, sclk ),
+      glcd_5510_spi_sce_res_dc( 
+         *static_cast< glcd_5510_bit_banged_bus * >( this ), sce, res, dc )
+   {}   
    
 }; // class glcd_5510
    
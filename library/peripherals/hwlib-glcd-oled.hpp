@@ -27,8 +27,10 @@ namespace hwlib {
 /// The interface is I2C.
 /// The driver chip is an SSD1306.
 ///
-/// The interface is buffered: all writes
-/// are buffered in memory until flush() is called.
+/// The buffered windows keep all writes in memory until flush()
+/// is called. The direct windows send each write to the display
+/// soon after it is done, but they too collect a few bytes, so
+/// flush() must be called to show the last writes.
 ///
 /// When the PCB has regulator (3-legged component) the power can be 3 - 5V. 
 /// If it hasn't, you can use only 3.3V.
@@ -81,9 +83,79 @@ enum class ssd1306_commands : uint8_t {
 /// value to send over i2c before a command
 constexpr uint8_t ssd1306_cmd_prefix  = 0x80;
 
+/// value to send over i2c before a stream of commands (Co = 0)
+constexpr uint8_t ssd1306_cmd_stream_prefix = 0x00;
+
 /// value to send over i2c before a command
 constexpr uint8_t ssd1306_data_prefix = 0x40;
 
+
+// ==========================================================================
+//
+// ssd1306 command sequence
+//
+// ==========================================================================
+
+/// a compile-time sequence of SSD1306 commands and delays
+///
+/// A sequence is built (at compile time) by appending commands, with
+/// their parameter bytes, and delays to an empty sequence:
+///
+/// \code
+/// constexpr auto s = hwlib::ssd1306_sequence< 0 >()
+///    .command( hwlib::ssd1306_commands::display_off )
+///    .command( hwlib::ssd1306_commands::set_contrast, 0xcf )
+///    .delay_ms( 10 )
+///    .command( hwlib::ssd1306_commands::display_on );
+/// \endcode
+///
+/// The commands() function of a driver sends the commands up to a
+/// delay (or the end) as a single I2C write (a command stream) or
+/// in a single SPI transaction, instead of one transfer per command.
+///
+/// The encoded sequence is a series of chunks: the number of bytes
+/// of a command followed by those bytes, or 0 followed by
+/// the (16 bit, high byte first) number of milliseconds of a delay.
+template< size_t N >
+class ssd1306_sequence {
+public:
+
+   /// the encoded sequence
+   std::array< uint8_t, N > data;
+
+   /// append a command and its parameter bytes
+   template< typename... T >
+   constexpr ssd1306_sequence< N + 2 + sizeof...( T ) > command(
+      ssd1306_commands c,
+      T... parameters
+   ) const {
+      ssd1306_sequence< N + 2 + sizeof...( T ) > result = {};
+      for( size_t i = 0; i < N; ++i ){
+         result.data[ i ] = data[ i ];
+      }
+      result.data[ N ] = 1 + sizeof...( T );
+      result.data[ N + 1 ] = static_cast< uint8_t >( c );
+      const uint8_t bytes[] = { static_cast< uint8_t >( parameters )..., 0 };
+      for( size_t i = 0; i < sizeof...( T ); ++i ){
+         result.data[ N + 2 + i ] = bytes[ i ];
+      }
+      return result;
+   }
+
+   /// append a delay
+   constexpr ssd1306_sequence< N + 3 > delay_ms( uint16_t ms ) const {
+      ssd1306_sequence< N + 3 > result = {};
+      for( size_t i = 0; i < N; ++i ){
+         result.data[ i ] = data[ i ];
+      }
+      result.data[ N ] = 0;
+      result.data[ N + 1 ] = ms >> 8;
+      result.data[ N + 2 ] = ms & 0xFF;
+      return result;
+   }
+
+}; // class ssd1306_sequence
+
 /// SSD1306 chip initialization
 constexpr const uint8_t ssd1306_initialization[] = {
    ssd1306_cmd_prefix, (uint8_t) ssd1306_commands::display_off,                  
@@ -104,6 +176,25 @@ constexpr const uint8_t ssd1306_initialization[] = {
    ssd1306_cmd_prefix, (uint8_t) ssd1306_commands::display_on                     
 };
 
+/// SSD1306 chip initialization, as a command sequence
+constexpr auto ssd1306_initialization_sequence = ssd1306_sequence< 0 >()
+   .command( ssd1306_commands::display_off )
+   .command( ssd1306_commands::set_display_clock_div, 0x80 )
+   .command( ssd1306_commands::set_multiplex,         0x3f )
+   .command( ssd1306_commands::set_display_offset,    0x00 )
+   .command( (ssd1306_commands) ( (uint8_t) ssd1306_commands::set_start_line | 0x00 ) )
+   .command( ssd1306_commands::charge_pump,           0x14 )
+   .command( ssd1306_commands::memory_mode,           0x00 )
+   .command( (ssd1306_commands) ( (uint8_t) ssd1306_commands::seg_remap | 0x01 ) )
+   .command( ssd1306_commands::com_scan_dec )
+   .command( ssd1306_commands::set_compins,           0x12 )
+   .command( ssd1306_commands::set_contrast,          0xcf )
+   .command( ssd1306_commands::set_precharge,         0xf1 )
+   .command( ssd1306_commands::set_vcom_detect,       0x40 )
+   .command( ssd1306_commands::display_all_on_resume )
+   .command( ssd1306_commands::normal_display )
+   .command( ssd1306_commands::display_on );
+
 
 // ==========================================================================
 //
@@ -120,6 +211,26 @@ protected:
    
    /// current cursor location in the controller
    xy cursor;
+
+   /// the pixel bytes that are not yet written:
+   /// pending_length bytes, starting at pending_start
+   xy pending_start;
+   uint8_t pending[ 16 ];
+   uint_fast8_t pending_length;
+
+   /// set the cursor location in the controller, with a single write
+   void set_cursor( xy location ){
+      const uint8_t data[] = {
+         ssd1306_cmd_stream_prefix,
+         (uint8_t) ssd1306_commands::column_addr, (uint8_t) location.x, 127,
+         (uint8_t) ssd1306_commands::page_addr,   (uint8_t) location.y,   7
+      };
+      bus.write( address ).write(
+         data,
+         sizeof( data ) / sizeof( uint8_t )
+      );
+      cursor = location;
+   }
 	   
 public:	
     
@@ -127,7 +238,8 @@ public:
    ssd1306_i2c( i2c_bus & bus, uint_fast8_t address = 0x3C ):
       bus( bus ),
       address( address ),
-	   cursor( 255, 255 )
+	   cursor( 255, 255 ),
+      pending_length( 0 )
    {
       // wait for the controller to be ready for the initialization       
      wait_ms( 20 );
@@ -169,25 +281,72 @@ public:
       );     
    } 	
   
+   /// send a command sequence
+   ///
+   /// The commands up to a delay (or the end) are sent
+   /// as a single write (a command stream).
+   void commands( const uint8_t sequence[], size_t n ){
+      size_t i = 0;
+      while( i < n ){
+         if( sequence[ i ] == 0 ){
+            wait_ms( ( sequence[ i + 1 ] << 8 ) | sequence[ i + 2 ] );
+            i += 3;
+            continue;
+         }
+         auto t = bus.write( address );
+         t.write( ssd1306_cmd_stream_prefix );
+         while( ( i < n ) && ( sequence[ i ] != 0 ) ){
+            t.write( sequence + i + 1, sequence[ i ] );
+            i += 1 + sequence[ i ];
+         }
+      }
+   }
+
+   /// send a command sequence
+   template< size_t N >
+   void commands( const ssd1306_sequence< N > & sequence ){
+      commands( sequence.data.data(), N );
+   }
+  
    /// write the pixel byte d at column x page y
+   ///
+   /// Consecutive bytes in a page are collected, and written
+   /// by a single write when a byte is not the next one,
+   /// or by pixels_flush().
    void pixels_byte_write( 
       xy location,
       uint8_t d 
    ){
+      if( ( pending_length > 0 ) && ( location.y == pending_start.y ) ){
+         const auto i = location.x - pending_start.x;
+         if( ( i >= 0 ) && ( i < pending_length ) ){
+            pending[ i ] = d;
+            return;
+         }
+         if( ( i == pending_length ) && ( i < (int) sizeof( pending ) ) ){
+            pending[ pending_length++ ] = d;
+            return;
+         }
+      }
+      pixels_flush();
+      pending_start = location;
+      pending[ 0 ] = d;
+      pending_length = 1;
+   }
 
-      if( location != cursor ){
-         command( ssd1306_commands::column_addr,  location.x,  127 );
-         command( ssd1306_commands::page_addr,    location.y,    7 );
-         cursor = location;
-      }   
-
-      uint8_t data[] = { ssd1306_data_prefix, d };
-      bus.write( address ).write( 
-         data, 
-         sizeof( data ) / sizeof( uint8_t ) 
-      ); 
-      cursor.x++;  
-    
+   /// write the collected pixel bytes
+   void pixels_flush(){
+      if( pending_length == 0 ){
+         return;
+      }
+      if( pending_start != cursor ){
+         set_cursor( pending_start );
+      }
+      auto t = bus.write( address );
+      t.write( ssd1306_data_prefix );
+      t.write( pending, pending_length );
+      cursor.x += pending_length;
+      pending_length = 0;
    }
       
 }; // class ssd1306_i2c
@@ -210,6 +369,24 @@ protected:
    
    // current cursor location in the controller
    xy cursor;
+
+   // the pixel bytes that are not yet written:
+   // pending_length bytes, starting at pending_start
+   xy pending_start;
+   uint8_t pending[ 16 ];
+   uint_fast8_t pending_length;
+
+   // set the cursor location in the controller, in a single transaction
+   void set_cursor( xy location ){
+      const uint8_t data[] = {
+         (uint8_t) ssd1306_commands::column_addr, (uint8_t) location.x, 127,
+         (uint8_t) ssd1306_commands::page_addr,   (uint8_t) location.y,   7
+      };
+      dc.write( 0 );
+      auto t = bus.transaction( cs );
+      t.write( sizeof( data ), data );
+      cursor = location;
+   }
 	   
 public:	
     
@@ -219,7 +396,8 @@ public:
       res( res ),
       dc( dc ),
       cs( cs ),
-	   cursor( 255, 255 )
+	   cursor( 255, 255 ),
+      pending_length( 0 )
    {
       res.write( 0 );
       wait_ms( 1 );      
@@ -253,23 +431,70 @@ public:
       t.write( d1 );      
    } 	
    
+   /// send a command sequence
+   ///
+   /// The whole sequence is sent in a single transaction,
+   /// the delays are done while the controller is selected.
+   void commands( const uint8_t sequence[], size_t n ){
+      dc.write( 0 );
+      auto t = bus.transaction( cs );
+      size_t i = 0;
+      while( i < n ){
+         if( sequence[ i ] == 0 ){
+            wait_ms( ( sequence[ i + 1 ] << 8 ) | sequence[ i + 2 ] );
+            i += 3;
+         } else {
+            t.write( sequence[ i ], sequence + i + 1 );
+            i += 1 + sequence[ i ];
+         }
+      }
+   }
+
+   /// send a command sequence
+   template< size_t N >
+   void commands( const ssd1306_sequence< N > & sequence ){
+      commands( sequence.data.data(), N );
+   }
+   
    /// write the pixel byte d at column x page y
+   ///
+   /// Consecutive bytes in a page are collected, and written
+   /// in a single transaction when a byte is not the next one,
+   /// or by pixels_flush().
    void pixels_byte_write( 
       xy location,
       uint8_t d 
    ){
+      if( ( pending_length > 0 ) && ( location.y == pending_start.y ) ){
+         const auto i = location.x - pending_start.x;
+         if( ( i >= 0 ) && ( i < pending_length ) ){
+            pending[ i ] = d;
+            return;
+         }
+         if( ( i == pending_length ) && ( i < (int) sizeof( pending ) ) ){
+            pending[ pending_length++ ] = d;
+            return;
+         }
+      }
+      pixels_flush();
+      pending_start = location;
+      pending[ 0 ] = d;
+      pending_length = 1;
+   }
 
-      if( location != cursor ){
-         command( ssd1306_commands::column_addr,  location.x,  127 );
-         command( ssd1306_commands::page_addr,    location.y,    7 );
-         cursor = location;
-      }   
-
+   /// write the collected pixel bytes
+   void pixels_flush(){
+      if( pending_length == 0 ){
+         return;
+      }
+      if( pending_start != cursor ){
+         set_cursor( pending_start );
+      }
       dc.write( 1 );
       auto t = bus.transaction( cs );
-      t.write( d );
-      cursor.x++;  
-    
+      t.write( pending_length, pending );
+      cursor.x += pending_length;
+      pending_length = 0;
    }
       
 }; // class ssd1306_spi
@@ -281,7 +506,14 @@ public:
 //
 // ==========================================================================
 
-/// buffered oled window
+/// direct oled window, i2c interface
+///
+/// A write updates the pixel in the local copy of the display,
+/// and sends the byte that holds the pixel to the display.
+/// Consecutive bytes in a page (up to 16) are collected and sent
+/// in one i2c write, which happens when a write is not to the next
+/// byte, or when flush() is called.
+/// Hence flush() must be called to show the last writes.
 class glcd_oled_i2c_128x64_direct : public ssd1306_i2c, public window {
 private:
 
@@ -308,8 +540,8 @@ private:
    
    void clear_implementation( color c ) override {
       const uint8_t d = ( c == white ) ? 0xFF : 0x00;
-      command( ssd1306_commands::column_addr,  0,  127 );
-      command( ssd1306_commands::page_addr,    0,    7 );  
+      pending_length = 0;
+      set_cursor( xy( 0, 0 ) );
       auto t = bus.write( address );
       t.write( ssd1306_data_prefix );
       for( uint_fast16_t x = 0; x < sizeof( buffer ); ++x ){                
@@ -326,14 +558,13 @@ public:
       ssd1306_i2c( bus, address ),
       window( wsize, white, black )
    {
-      bus.write( address ).write( 
-         ssd1306_initialization, 
-         sizeof( ssd1306_initialization ) / sizeof( uint8_t ) 
-      );     
+      commands( ssd1306_initialization_sequence );
       clear();      
    }
    
-   void flush() override {}  
+   void flush() override {
+      pixels_flush();
+   }  
 
 }; // class glcd_oled_i2c_128x64_direct
 
@@ -344,7 +575,14 @@ public:
 //
 // ==========================================================================
 
-/// buffered oled window
+/// direct oled window, spi interface
+///
+/// A write updates the pixel in the local copy of the display,
+/// and sends the byte that holds the pixel to the display.
+/// Consecutive bytes in a page (up to 16) are collected and sent
+/// in one spi transaction, which happens when a write is not to the
+/// next byte, or when flush() is called.
+/// Hence flush() must be called to show the last writes.
 class glcd_oled_spi_128x64_direct_res_dc_cs : 
    public ssd1306_spi_res_dc_cs, 
    public window 
@@ -374,36 +612,21 @@ private:
      
 public:
    
-   /// construct by providing the i2c channel
+   /// construct by providing the spi bus and the res, dc and cs pins
    glcd_oled_spi_128x64_direct_res_dc_cs( spi_bus & bus, pin_out & res, pin_out & dc, pin_out & cs ):
       ssd1306_spi_res_dc_cs( bus, res, dc, cs ),
       window( wsize, white, black )
    {
-      command( ssd1306_commands::display_off );
-      command( ssd1306_commands::set_display_clock_div, 0x80 );
-      command( ssd1306_commands::set_multiplex,         0x3f ); 
-      command( ssd1306_commands::set_display_offset,    0x00 ); 
-      command( (ssd1306_commands) (((int) ssd1306_commands::set_start_line )      | 0x00 ));
-      command( ssd1306_commands::charge_pump,           0x14 );   
-      command( ssd1306_commands::memory_mode,           0x00 );   
-      command( (ssd1306_commands) (((int)  ssd1306_commands::seg_remap  )          | 0x01 ));
-      command( ssd1306_commands::com_scan_dec );
-      command( ssd1306_commands::set_compins,           0x12 );
-      command( ssd1306_commands::set_contrast,          0xcf ); 
-      command( ssd1306_commands::set_precharge,         0xf1 );
-      command( ssd1306_commands::set_vcom_detect,       0x40 );
-      command( ssd1306_commands::display_all_on_resume );  
-      command( ssd1306_commands::normal_display );
-      command( ssd1306_commands::display_on );
+      commands( ssd1306_initialization_sequence );
       clear();      
    }
    
    void clear_implementation(  color c ) override {
       const uint8_t d = ( c == white ) ? 0xFF : 0x00;
-      command( ssd1306_commands::column_addr,  0,  127 );
-      command( ssd1306_commands::page_addr,    0,    7 );  
+      pending_length = 0;
+      set_cursor( xy( 0, 0 ) );
+      dc.write( 1 );
       auto t = bus.transaction( cs );
-      t.write( ssd1306_data_prefix );
       for( uint_fast16_t x = 0; x < sizeof( buffer ); ++x ){                
 	      buffer[ x ] = d;
 		   t.write( d );
@@ -411,10 +634,12 @@ public:
 	  cursor = xy( 255, 255 );
    }
    
-   void flush() override {}  
+   void flush() override {
+      pixels_flush();
+   }  
 
 
-}; // class glcd_oled_i2c_128x64_direct
+}; // class glcd_oled_spi_128x64_direct_res_dc_cs
 
 
 // ==========================================================================
@@ -451,16 +676,12 @@ public:
       ssd1306_i2c( bus, address ),
       window( wsize, white, black )
    {
-      bus.write( address ).write( 
-         ssd1306_initialization, 
-         sizeof( ssd1306_initialization ) / sizeof( uint8_t ) 
-      );  
+      commands( ssd1306_initialization_sequence );  
       clear();      
    }
    
    void flush() override {
-      command( ssd1306_commands::column_addr,  0,  127 );
-      command( ssd1306_commands::page_addr,    0,    7 );   
+      set_cursor( xy( 0, 0 ) );
       if(0) for( int y = 0; y < 64 / 8; y++ ){
          for( int x = 0; x < 128; x++ ){
             uint8_t d = buffer[ x + 128 * y ];
@@ -525,10 +746,7 @@ public:
       ssd1306_i2c( bus, address ),
       window( wsize, white, black )
    {
-      bus.write( address ).write( 
-         ssd1306_initialization, 
-         sizeof( ssd1306_initialization ) / sizeof( uint8_t ) 
-      );     
+      commands( ssd1306_initialization_sequence );     
       clear();
    }
    
@@ -567,8 +785,7 @@ public:
             }               
          }            
          
-         command( ssd1306_commands::column_addr,  start % wsize.x,  127 );
-         command( ssd1306_commands::page_addr,    start / wsize.x,    7 );   
+         set_cursor( xy( start % wsize.x, start / wsize.x ) );
          auto t = bus.write( address );
          t.write( ssd1306_data_prefix );
          t.write( & buffer[ start ], 1 + ( tail - start ) );
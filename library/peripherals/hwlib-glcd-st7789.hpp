@@ -19,27 +19,18 @@ namespace hwlib {
    
 
 /// \brief
-/// Oled B/W graphics LCD
+/// ST7789 240 x 240 color TFT LCD
 /// \details
-/// This class implements an interface to an 128 x 64 pixel
-/// monochrome (on/off) OLED display. These displays are available
-/// in various colcors (green, red, white, etc.).
-/// The interface is I2C.
-/// The driver chip is an SSD1306.
+/// The ST7789 is the driver chip of small (1.3 inch) 240 x 240 pixel
+/// color TFT displays. The interface is SPI, with a data/command (dc),
+/// chip select (cs) and reset (rst) pin.
 ///
-/// The interface is buffered: all writes
-/// are buffered in memory until flush() is called.
-///
-/// When the PCB has regulator (3-legged component) the power can be 3 - 5V. 
-/// If it hasn't, you can use only 3.3V.
-///
-/// There are variations of this display with more pins, which 
-/// have more interface options (SPI as alternative interface).
-///
-/// This type of display is reasonably priced 
-/// and available from lots of sources.
-///
-/// \image html oled.jpg
+/// Two windows are available:
+///    - st7789_spi_dc_cs_rst buffers the whole display
+///      (57.6 KB), and sends only the changed areas on flush().
+///    - st7789_spi_dc_cs_rst_strips< strip_height > buffers only a strip
+///      of rows, and renders the whole display by calling a draw
+///      function for each strip.
 ///
 
 class st7789 {
@@ -79,31 +70,90 @@ public:
    };   
 };
 
-class st7789_spi_dc_cs_rst : public st7789, public window {
-private:
+// ==========================================================================
+//
+// st7789, accessed by spi
+//
+// ==========================================================================
 
-   static auto constexpr wsize = xy( 240, 240 );
+class st7789_spi : public st7789 {
+protected:
 
-   // AVR8 bug
-   static auto constexpr bufsize = (( int32_t ) wsize.x ) * (( int32_t ) wsize.y );
-   
-   uint8_t buffer[ bufsize ];
-        
-   void write_implementation( 
-      xy pos, 
-      color col
-   ) override {
-      buffer[ pos.x + wsize.x * pos.y ] = 
-           ( ( col.red   & 0xC0 ) >> 2 )
-         + ( ( col.green & 0xC0 ) >> 4 )
-         + ( ( col.blue  & 0xC0 ) >> 6 );
-   }      
+   static auto constexpr wsize = xy( 240, 240 );
 
+   // the spi bus & pins
    spi_bus & bus;
    pin_out & dc;
    pin_out & cs;
    pin_out & rst;
-   
+
+   st7789_spi(
+      spi_bus & bus,
+      pin_out & dc,
+      pin_out & cs,
+      pin_out & rst
+   ):
+      bus( bus ),
+      dc( dc ),
+      cs( cs ),
+      rst( rst )
+   {}
+
+   // reset and initialize the controller,
+   // colmod selects the pixel format
+   void initialize( uint8_t colmod ){
+      rst.write( 0 );rst.flush();
+      wait_ms( 200 );
+      rst.write( 1 );rst.flush();
+      wait_ms( 200 );
+
+      command( commands::SWRESET );
+      wait_ms( 150 );
+
+      command( commands::SLPOUT );
+      wait_ms( 10 );
+
+      command( commands::COLMOD, colmod );
+      wait_ms( 10 );
+
+      command( commands::MADCTL, 0x10 );
+      set_area( box( xy( 0, 0 ), wsize ) );
+
+      command( commands::INVON );
+      wait_ms( 10 );
+      command( commands::NORON );
+      wait_ms( 100 );
+      command( commands::DISPON );
+      wait_ms( 100 );
+   }
+
+   // set the area of the controller ram that the next RAMWR writes
+   void set_area( const box & area ){
+      const auto last = area.end - xy( 1, 1 );
+      command( commands::CASET,
+         area.start.x >> 8, area.start.x & 0xFF, last.x >> 8, last.x & 0xFF );
+      command( commands::RASET,
+         area.start.y >> 8, area.start.y & 0xFF, last.y >> 8, last.y & 0xFF );
+   }
+
+   // write pixel data to the area set by set_area():
+   // fill is called with the RAMWR transaction to write the data
+   template< typename F >
+   void write_ram( F fill ){
+      dc.write( 0 ); dc.flush();
+      auto transaction = bus.transaction( cs );
+      transaction.write( static_cast< uint8_t >( commands::RAMWR ) );
+      dc.write( 1 ); dc.flush();
+      fill( transaction );
+   }
+
+   // write n bytes of pixel data to the area set by set_area()
+   void write_ram( size_t n, const uint8_t * data ){
+      write_ram( [ & ]( spi_bus::spi_transaction & transaction ){
+         transaction.write( n, data );
+      } );
+   }
+
 public:
 
    void command( 
@@ -142,59 +192,275 @@ public:
       transaction.write( d2 );    
       transaction.write( d3 );    
    } 	
+
+}; // class st7789_spi
+
+
+// ==========================================================================
+//
+// buffered
+//
+// ==========================================================================
+
+/// buffered st7789 window
+///
+/// This window buffers all pixels (1 byte per pixel, 2 bits per color)
+/// until flush() is called.
+///
+/// The window keeps track of the areas that have been written since
+/// the last flush(). The flush() sends only those areas, each with its
+/// own CASET/RASET, as a small number of rectangles.
+/// Hence a small change, like a clock digit, costs only the bytes
+/// of its own area instead of a whole frame.
+///
+/// The pixels are sent to the display in either the 16-bit RGB565
+/// format (2 bytes per pixel, the default) or the 18-bit RGB666
+/// format (3 bytes per pixel). Both show the 2 bits per color
+/// of the buffer exactly.
+class st7789_spi_dc_cs_rst : public st7789_spi, public window {
+private:
+
+   // AVR8 bug
+   static auto constexpr bufsize = (( int32_t ) wsize.x ) * (( int32_t ) wsize.y );
    
+   uint8_t buffer[ bufsize ];
+
+   // the format in which flush() sends the pixels,
+   // and the kernel that converts them
+   const pixel_format format;
+   const pixel_kernel kernel;
+
+   // one row of pixels, as colors and in the format of the display
+   color colors[ wsize.x ];
+   uint8_t row[ pixel_format_bytes( pixel_format::rgb666, wsize.x ) ];
+
+   // the areas that were written since the last flush()
+   damage_set damage;
+
+   static uint8_t pixel( color col ){
+      return
+           ( ( col.red   & 0xC0 ) >> 2 )
+         + ( ( col.green & 0xC0 ) >> 4 )
+         + ( ( col.blue  & 0xC0 ) >> 6 );
+   }
+        
+   void write_implementation( 
+      xy pos, 
+      color col
+   ) override {
+      buffer[ pos.x + wsize.x * pos.y ] = pixel( col );
+      damage.add( box( pos, pos + xy( 1, 1 ) ) );
+   }      
+
+   void write_span_implementation(
+      xy pos,
+      int_fast16_t n,
+      color col
+   ) override {
+      const auto p = pixel( col );
+      auto b = buffer + pos.x + wsize.x * pos.y;
+      for( int_fast16_t i = 0; i < n; ++i ){
+         b[ i ] = p;
+      }
+      damage.add( box( pos, pos + xy( n, 1 ) ) );
+   }
+
+   void clear_implementation( color col ) override {
+      const auto p = pixel( col );
+      for( int32_t i = 0; i < bufsize; ++i ){
+         buffer[ i ] = p;
+      }
+      damage.add( box( xy( 0, 0 ), wsize ) );
+   }
+
+   // send an area of the buffer to the display
+   void flush( const box & area ){
+      set_area( area );
+
+      // convert and write a whole row at a time
+      write_ram( [ & ]( spi_bus::spi_transaction & transaction ){
+         const auto n = area.size().x;
+         for( int_fast16_t y = area.start.y; y < area.end.y; ++y ){
+            const uint8_t * p = buffer + area.start.x + wsize.x * y;
+            for( int_fast16_t x = 0; x < n; ++x ){
+               colors[ x ] = color(
+                  ( p[ x ] << 2 ) & 0xC0,
+                  ( p[ x ] << 4 ) & 0xC0,
+                  ( p[ x ] << 6 ) & 0xC0 );
+            }
+            pixel_convert( format, colors, n, row, kernel );
+            transaction.write( pixel_format_bytes( format, n ), row );
+         }
+      } );
+   }
+
+public:
+
+   /// create a buffered st7789 window
+   ///
+   /// The format must be pixel_format::rgb565 or pixel_format::rgb666.
+   /// The kernel converts each row of pixels for flush(),
+   /// the default is the fastest one that is available.
    st7789_spi_dc_cs_rst( 
       spi_bus & bus, 
       pin_out & dc, 
       pin_out & cs, 
-      pin_out & rst
+      pin_out & rst,
+      pixel_format format = pixel_format::rgb565,
+      pixel_kernel kernel = pixel_kernel_best
    ):
-      window( wsize, white, black ),   
-      bus( bus ), 
-      dc( dc ), 
-      cs( cs ), 
-      rst( rst )
+      st7789_spi( bus, dc, cs, rst ),
+      window( wsize, white, black ),
+      format(
+         ( format == pixel_format::rgb666 )
+            ? pixel_format::rgb666
+            : pixel_format::rgb565 ),
+      kernel( kernel )
    {       
-      rst.write( 0 );rst.flush();
-      wait_ms( 200 );
-      rst.write( 1 );rst.flush();
-      wait_ms( 200 );
-      
-      command( commands::SWRESET );
-      wait_ms( 150 );
-      
-      command( commands::SLPOUT );
-      wait_ms( 10 );
-      
-      command( commands::COLMOD, 0x66 );
-      wait_ms( 10 );
-      
-      command( commands::MADCTL, 0x10 );                      
-      command( commands::CASET, 0, 0, wsize.x >> 8, wsize.x & 0xFF );
-      command( commands::RASET, 0, 0, wsize.y >> 8, wsize.y & 0xFF );
-      
-      command( commands::INVON );
-      wait_ms( 10 );
-      command( commands::NORON );
-      wait_ms( 100 );
-      command( commands::DISPON );
-      wait_ms( 100 );
-      
+      initialize( ( this->format == pixel_format::rgb666 ) ? 0x66 : 0x55 );
       clear();      
    }     
 
+   /// send the areas that were written since the last flush()
    void flush() override {
-      dc.write( 0 ); dc.flush();
-      auto transaction = bus.transaction( cs );
-      transaction.write( static_cast< uint8_t >( commands::RAMWR ) );     
-      dc.write( 1 ); dc.flush();
-      for( int32_t i = 0; i < bufsize; ++i ){
-         transaction.write( ( buffer[ i ] << 2 ) & 0xC0 );
-         transaction.write( ( buffer[ i ] << 4 ) & 0xC0 );
-         transaction.write( ( buffer[ i ] << 6 ) & 0xC0 );
-      }   
+      for( size_t i = 0; i < damage.length; ++i ){
+         flush( damage.boxes[ i ] );
+      }
+      damage.clear();
    }     
         
 }; // class st7789_spi_dc_cs_rst
 
-}; // namespace hwlib
\ No newline at end of file
+
+// ==========================================================================
+//
+// strips
+//
+// ==========================================================================
+
+/// st7789 window that renders in horizontal strips
+///
+/// This window needs memory for only a strip of strip_height rows
+/// (2 bytes per pixel, in the 16-bit RGB565 format),
+/// instead of for the whole 240 x 240 display.
+///
+/// It can't buffer arbitrary writes: instead, render()
+/// calls a draw function or lambda (or the draw() of a drawable,
+/// which can be a display list) once for each strip. Each time the writes to the rows
+/// of the current strip are stored, the other writes are ignored.
+/// After each call, the strip is sent to its rows of the display.
+/// Hence the drawing must produce the same result for each call.
+///
+/// Outside render(), writes have no effect, and flush() does nothing.
+/// A strip_height that divides 240 avoids a partial last strip.
+///
+/// A write converts its single color to RGB565 when it is stored,
+/// so there is no batch of pixels to convert, and no 
+/// pixel_convert() kernel to choose.
+template< int strip_height = 16 >
+class st7789_spi_dc_cs_rst_strips : public st7789_spi, public window {
+private:
+
+   static_assert(
+      ( strip_height > 0 ) && ( strip_height <= 240 ),
+      "strip_height must be 1 .. 240" );
+
+   static constexpr auto format = pixel_format::rgb565;
+   static constexpr auto stride = pixel_format_bytes( format, wsize.x );
+
+   uint8_t strip[ strip_height * stride ];
+
+   // the first row of the current strip, and the number of rows
+   int_fast16_t first;
+   int_fast16_t rows;
+
+   void write_implementation( xy pos, color col ) override {
+      write_span_implementation( pos, 1, col );
+   }
+
+   void write_span_implementation(
+      xy pos,
+      int_fast16_t n,
+      color col
+   ) override {
+      if( ( pos.y < first ) || ( pos.y >= first + rows ) ){
+         return;
+      }
+      uint8_t pixel[ 2 ];
+      pixel_convert( format, & col, 1, pixel );
+      auto p = strip + ( pos.y - first ) * stride + 2 * pos.x;
+      for( int_fast16_t i = 0; i < n; ++i ){
+         *p++ = pixel[ 0 ];
+         *p++ = pixel[ 1 ];
+      }
+   }
+
+   void clear_implementation( color col ) override {
+      uint8_t pixel[ 2 ];
+      pixel_convert( format, & col, 1, pixel );
+      for( size_t i = 0; i < rows * stride; i += 2 ){
+         strip[ i ] = pixel[ 0 ];
+         strip[ i + 1 ] = pixel[ 1 ];
+      }
+   }
+
+   template< typename F >
+   void render_strips( F & draw ){
+      for( first = 0; first < wsize.y; first += strip_height ){
+         rows = ( wsize.y - first < strip_height ) ? wsize.y - first : strip_height;
+         window::clear();
+         draw( *this );
+         set_area( box( xy( 0, first ), xy( wsize.x, first + rows ) ) );
+         write_ram( rows * stride, strip );
+      }
+      rows = 0;
+   }
+
+public:
+
+   st7789_spi_dc_cs_rst_strips(
+      spi_bus & bus,
+      pin_out & dc,
+      pin_out & cs,
+      pin_out & rst
+   ):
+      st7789_spi( bus, dc, cs, rst ),
+      window( wsize, white, black ),
+      first( 0 ),
+      rows( 0 )
+   {
+      initialize( 0x55 );
+      render( []( window & ){} );
+   }
+
+   /// render the display by calling a draw function for each strip
+   ///
+   /// The draw function can be any callable that accepts a window &,
+   /// for instance a function or a lambda that captures the state
+   /// that decides what is drawn.
+   /// Each strip is cleared to the background color before the
+   /// function is called.
+   template<
+      typename F,
+      typename = typename std::enable_if< ! std::is_base_of<
+         drawable, typename std::remove_reference< F >::type >::value
+      >::type
+   >
+   void render( F && draw ){
+      render_strips( draw );
+   }
+
+   /// render the display by drawing a drawable for each strip
+   ///
+   /// Each strip is cleared to the background color before the
+   /// drawable is drawn.
+   void render( drawable & d ){
+      auto draw = [ & ]( window & w ){ d.draw( w ); };
+      render_strips( draw );
+   }
+
+   void flush() override {}
+
+}; // class st7789_spi_dc_cs_rst_strips
+
+}; // namespace hwlib
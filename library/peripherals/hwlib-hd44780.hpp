@@ -17,6 +17,124 @@
 
 namespace hwlib {
 
+/// hd44780 character LCD, independent of the interface
+///
+/// This class implements the terminal interface of an hd44780
+/// character LCD on top of the (private) functions that write 
+/// to the controller, which are provided by a concrete class: 
+/// hd44780 for the LCD pins, hd44780_pcf8574 for an LCD on 
+/// a PCF8574 I2C backpack.
+class hd44780_base : public terminal {
+private:
+
+   // write the high nibble of an instruction (rs == 0) in 8-bit mode,
+   // used only for the interface initialization
+   virtual void write_initialization( uint8_t n ) = 0;
+
+   // write an instruction or data byte, 
+   // including the wait for the execution of a clear or home
+   virtual void write8( bool is_data, uint8_t b ) = 0;
+
+protected:
+
+   /// create an hd44780 of the specified size
+   hd44780_base( xy size ):
+      terminal{ size }
+   {}
+
+   /// initialize the controller
+   ///
+   /// A concrete class must call this function from its constructor.
+   void initialize( bool eight_bit = false ){
+
+      // interface initialization: make sure the LCD is in 4 (or 8) bit mode
+      // (magical sequence, taken from the HD44780 data-sheet)
+      write_initialization( 0x03 );
+      wait_ms( 15 );
+      write_initialization( 0x03 );
+      wait_us( 100 );
+      write_initialization( 0x03 );
+      if( ! eight_bit ){
+         write_initialization( 0x02 );     // 4 bit mode
+      }
+
+      // functional initialization
+      command( eight_bit ? 0x38 : 0x28 ); // 4 or 8 bit mode, 2 lines, 5x8 font
+      command( 0x0C );            // display on, no cursor, no blink
+      clear();                    // clear display, 'cursor' home
+      cursor_set( xy( 0, 0 ) );   // 'cursor' home    
+   }    
+
+   /// the DDRAM address of a character position
+   uint8_t address( xy pos ) const {
+      if( size.y == 1 ){
+         if( pos.x < 8 ){
+            return pos.x;
+         } else {
+            return 0x40 + ( pos.x - 8 );
+         }
+      } else if( size.y == 2 ){
+         return 
+            (( pos.y > 0 ) 
+               ? 0x40 
+               : 0x00 )
+            + ( pos.x );
+      } else {
+         return 
+            (( pos.y & 0x01 )
+               ? 0x40 
+               : 0x00 )
+            + (( pos.y & 0x02 )
+               ? 0x14 
+               : 0x00 )
+            + ( pos.x );
+      }
+   }
+
+   void cursor_set_implementation( xy new_cursor ) override {
+      // the NVI goto_xy() has already set the x and y variables
+      command( 0x80 + address( new_cursor ) );
+   }   
+
+   void putc_implementation( char chr ) override {
+      // the NVI putc() handles the x and y variables
+      
+      // handle the gap for 1-line displays
+      if( ( size.y == 1 ) && ( cursor.x == 8 ) ){
+         cursor_set_implementation( cursor );
+      }   
+      
+      data( chr );
+   }  
+
+public:
+
+   /// write a command byte to the LCD
+   ///
+   /// Use this function only for features that are not 
+   /// provided by the console interface, like the definition
+   /// of the user-defined characters.
+   void command( unsigned char cmd ){
+      write8( 0, cmd );
+   }
+
+   /// write a data byte to the LCD
+   /// 
+   /// Use this function only for features that are not 
+   /// provided by the console interface, like the definition
+   /// of the user-defined characters.
+   void data( unsigned char chr ){
+      write8( 1, chr );
+   }
+
+   void clear() override {
+      command( 0x01 );
+      cursor_set( xy( 0, 0 ) );
+   }   
+   
+}; // class hd44780_base
+
+
 /// hd44780 character LCD interface 
 /// 
 /// This class implements an interface to an hd44780 character LCD.  
@@ -39,17 +157,23 @@ namespace hwlib {
 /// configured to use only 4. This adds some complexity to the driver 
 /// software and slows it down a little, but the saving of 4 micro-controller
 /// more than compensates for this, hence nearly all software 
-/// (including this driver) for is for the 4-bit interface.
+/// is for the 4-bit interface.
 /// Note for the 4-bit interface the 4 highest data pins (D4..D7) are used.
 /// The lower 4 can be left unconnected.
+/// This driver uses the 8-bit interface when the data port has 8 pins.
 ///
 /// The chip has some locations that can be writen and also read back, 
-/// but this offers little advantage, so most software (including this driver)
+/// but this offers little advantage, so most software 
 /// only writes to the chip, thus saving another pin.
 /// Hence 6 pins (+ ground and 5V) 
 /// are needed to interface to an hd44780 display:
 /// 4 data lines, the R/S line (selects between command and data), 
 /// and the E line (a strobe for the command).
+/// Without reading, each write must wait long enough for the
+/// slowest instruction.
+/// When the R/W pin is connected, and the data port can be read,
+/// this driver reads the busy flag before each write instead,
+/// which makes writing a few times faster.
 ///
 /// \image html hd44780-connection.png
 ///
@@ -83,27 +207,120 @@ namespace hwlib {
 ///    - <A HREF="https://www.sparkfun.com/datasheets/LCD/HD44780.pdf">
 ///       HD44780U data sheet</A> (pdf)
 /// 
-class hd44780 : public terminal {
+class hd44780 : public hd44780_base {
 private:
    pin_direct_from_out_t   pin_e;
    pin_direct_from_out_t   pin_rs;
-   port_direct_from_out_t  port_data;
+   pin_direct_from_out_t   pin_rw;
+   
+   // the data port, only one of these is used
+   port_out *              port_data;
+   port_in_out *           port_busy;
+   
+   bool eight_bit;
+   
+   void write_port( uint8_t n ){
+      if( port_busy != nullptr ){
+         port_busy->write( n );
+         port_busy->flush();
+      } else {
+         port_data->write( n );
+         port_data->flush();
+      }
+   }
    
    void write4( unsigned char n ){
+      if( port_busy != nullptr ){
+         
+         // the busy flag is polled before the next write 
+         write_port( n );
+         wait_us( 1 );
+         pin_e.write( 1 );
+         wait_us( 1 );
+         pin_e.write( 0 );
+         return;
+      }
       wait_us( 10 );
-      port_data.write( n );
+      write_port( n );
       wait_us( 20 );
       pin_e.write( 1 );
       wait_us( 20 );
       pin_e.write( 0 );
       wait_us( 100 );  // enough for most instructions
    }
+   
+   // wait until the controller is no longer busy
+   //
+   // When the busy flag doesn't clear (for instance because the 
+   // R/W pin is not connected), this gives up after some time.
+   void wait_busy(){
+      const uint8_t busy = eight_bit ? 0x80 : 0x08;
+      pin_rs.write( 0 );
+      pin_rw.write( 1 );
+      port_busy->direction_set_input();
+      for( uint_fast16_t i = 0; i < 2'000; ++i ){
+         pin_e.write( 1 );
+         wait_us( 1 );
+         port_busy->refresh();
+         const auto status = port_busy->read();
+         pin_e.write( 0 );
+         wait_us( 1 );
+         if( ! eight_bit ){
+            
+            // the low nibble (address) is read but ignored
+            pin_e.write( 1 );
+            wait_us( 1 );
+            pin_e.write( 0 );
+            wait_us( 1 );
+         }
+         if( ( status & busy ) == 0 ){
+            break;
+         }
+      }
+      port_busy->direction_set_output();
+      pin_rw.write( 0 );
+   }
+
+   void write_initialization( uint8_t n ) override {
+      pin_rs.write( 0 );
+      write4( eight_bit ? ( n << 4 ) : n );
+      if( port_busy != nullptr ){
+         
+         // the busy flag can't be checked yet
+         wait_us( 100 );
+      }
+   }
 
-   void write8( bool is_data, unsigned char b ){
+   void write8( bool is_data, uint8_t b ) override {
+      if( port_busy != nullptr ){
+         wait_busy();
+      }
       pin_rs.write( is_data );
-      write4( b >> 4 );
-      write4( b );
+      if( eight_bit ){
+         write4( b );
+      } else {
+         write4( b >> 4 );
+         write4( b );
+      }
+      
+      // clear and home take much longer than the other instructions
+      if( ( ! is_data ) && ( b < 0x04 ) && ( port_busy == nullptr ) ){
+         wait_ms( 5 );
+      }
    }      
+   
+   void start(){
+      // give LCD time to wake up
+      pin_e.write( 0 );
+      pin_rs.write( 0 );
+      pin_rw.write( 0 );
+      if( port_busy != nullptr ){
+         port_busy->direction_set_output();
+      }
+      wait_ms( 100  );
+
+      initialize( eight_bit );
+   }
            
 public:
 
@@ -111,110 +328,234 @@ public:
    /// 
    /// This constructor creates an interface to 
    /// an hd44780 LCD controller from the RS and E pins, and the 4-bit port
-   /// to the D4..D8 pins, and the number of lines and characters per line,
+   /// to the D4..D8 pins (or an 8-bit port to the D0..D7 pins),
+   /// and the number of lines and characters per line,
    /// and initializes the controller.
+   ///
+   /// As the R/W pin is not used (it must be connected to ground),
+   /// each write waits long enough for (nearly) all instructions.
    hd44780( 
       pin_out & rs, 
       pin_out & e, 
       port_out & data, 
       xy size
     ):
-      terminal{ size },
+      hd44780_base{ size },
       pin_e( e ), 
       pin_rs( rs ), 
-      port_data( data )
+      pin_rw( pin_out_dummy ),
+      port_data( & data ),
+      port_busy( nullptr ),
+      eight_bit( data.number_of_pins() == 8 )
    {
-      // give LCD time to wake up
-      pin_e.write( 0 );
-      pin_rs.write( 0 );
-      wait_ms( 100  );
-
-      // interface initialization: make sure the LCD is in 4 bit mode
-      // (magical sequence, taken from the HD44780 data-sheet)
-      write4( 0x03 );
-      wait_ms( 15 );
-      write4( 0x03 );
-      wait_us( 100 );
-      write4( 0x03 );
-      write4( 0x02 );     // 4 bit mode
-
-      // functional initialization
-      command( 0x28 );            // 4 bit mode, 2 lines, 5x8 font
-      command( 0x0C );            // display on, no cursor, no blink
-      clear();                    // clear display, 'cursor' home
-      cursor_set( xy( 0, 0 ) );   // 'cursor' home    
+      start();
    }    
    
-   /// write a command byte to the LCD
+   /// construct an interface to an hd44780 chip, with busy polling
+   /// 
+   /// This constructor creates an interface to 
+   /// an hd44780 LCD controller from the RS, R/W and E pins, 
+   /// and the 4-bit port to the D4..D8 pins 
+   /// (or an 8-bit port to the D0..D7 pins),
+   /// and the number of lines and characters per line,
+   /// and initializes the controller.
    ///
-   /// Use this function only for features that are not 
-   /// provided by the console interface, like the definition
-   /// of the user-defined characters.
-   void command( unsigned char cmd ){
-      write8( 0, cmd );
+   /// Each write first reads the busy flag of the controller, 
+   /// and waits only until the controller is ready,
+   /// which is much faster than the fixed waits.
+   /// Note that the controller drives the data pins at its
+   /// power voltage (often 5V) while they are read.
+   hd44780( 
+      pin_out & rs, 
+      pin_out & rw, 
+      pin_out & e, 
+      port_in_out & data, 
+      xy size
+    ):
+      hd44780_base{ size },
+      pin_e( e ), 
+      pin_rs( rs ), 
+      pin_rw( rw ),
+      port_data( nullptr ),
+      port_busy( & data ),
+      eight_bit( data.number_of_pins() == 8 )
+   {
+      start();
+   }    
+   
+}; // class hd44780
+
+
+// ==========================================================================
+//
+// hd44780_pcf8574
+//
+// ==========================================================================
+
+/// hd44780 character LCD on a PCF8574 I2C backpack
+///
+/// This class implements an interface to an hd44780 character LCD 
+/// that is connected to the I2C bus by a PCF8574 (or PCF8574A) I/O
+/// extender, as on the common 'I2C LCD backpack' modules.
+/// The PCF8574 pins are used as
+///    - P0 : RS
+///    - P1 : R/W (kept low)
+///    - P2 : E
+///    - P3 : backlight
+///    - P4 .. P7 : D4 .. D7
+///
+/// An hd44780 on pcf8574 port pins needs separate I2C writes 
+/// for each nibble and for each E change. 
+/// This class instead puts the complete E strobe sequence 
+/// for both nibbles of a byte (4 PCF8574 writes) in a single I2C 
+/// transaction, and a run of characters (up to 8) in a 
+/// single I2C transaction.
+/// The PCF8574 runs at (at most) 100 kHz, so the I2C transfer
+/// of a byte takes longer than the controller needs to execute it.
+///
+/// The class keeps a copy (shadow) of the characters on the display.
+/// A character that is already shown is not written again,
+/// and the cursor is moved only when a character must be written 
+/// to a position that is not the next one.
+///
+/// The characters are written to the LCD when the buffer is full
+/// and by flush(), so call flush() when the display must show
+/// what was written.
+class hd44780_pcf8574 : public hd44780_base {
+private:
+
+   i2c_bus & bus;
+   uint_fast8_t address;
+   uint8_t backlight_bit;
+
+   // the PCF8574 writes that are not yet sent
+   uint8_t buffer[ 32 ];
+   uint_fast8_t buffer_length;
+
+   // the characters on the display, ' ' after a clear
+   char shadow[ 80 ];
+
+   // whether the controller address is at the cursor
+   bool address_valid;
+
+   static constexpr uint8_t rs_bit = 0x01;
+   static constexpr uint8_t e_bit  = 0x04;
+
+   void send(){
+      if( buffer_length > 0 ){
+         bus.write( address ).write( buffer, buffer_length );
+         buffer_length = 0;
+      }
    }
 
-   /// write a data byte to the LCD
-   /// 
-   /// Use this function only for features that are not 
-   /// provided by the console interface, like the definition
-   /// of the user-defined characters.
-   void data( unsigned char chr ){
-      write8( 1, chr );
+   void add_nibble( uint8_t n ){
+      buffer[ buffer_length++ ] = n | e_bit;
+      buffer[ buffer_length++ ] = n;
    }
 
-   void clear() override {
-      command( 0x01 );
-      wait_ms( 5 );
-      cursor_set( xy( 0, 0 ) );
-   }   
-   
-private:
+   void write_initialization( uint8_t n ) override {
+      add_nibble( ( n << 4 ) | backlight_bit );
+      send();
+      wait_us( 100 );
+   }
 
-   void cursor_set_implementation( xy new_cursor ) override {
-      // the NVI goto_xy() has already set the x and y variables
-      
-      if( size.y == 1 ){
-         if( new_cursor.x < 8 ){
-            command( 0x80 + new_cursor.x );
-         } else {
-            command( 0x80 + 0x40 + ( new_cursor.x - 8 ));
-         }
-      } else {
-         if( size.y == 2 ){
-            command( 
-               0x80
-               + (( new_cursor.y > 0 ) 
-                  ? 0x40 
-                  : 0x00 )
-               + ( new_cursor.x )
-            );
-         } else {
-            command( 
-                0x80
-                 + (( new_cursor.y & 0x01 )
-                    ? 0x40 
-                    : 0x00 )
-                 + (( new_cursor.y & 0x02 )
-                    ? 0x14 
-                    : 0x00 )
-                 + ( new_cursor.x )
-             );              
-         }
+   void write8( bool is_data, uint8_t b ) override {
+      if( buffer_length + 4u > sizeof( buffer ) ){
+         send();
       }
-   }   
+      const uint8_t low = backlight_bit | ( is_data ? rs_bit : 0 );
+      add_nibble( ( b & 0xF0 ) | low );
+      add_nibble( ( ( b << 4 ) & 0xF0 ) | low );
+
+      // clear and home take much longer than the other instructions
+      if( ( ! is_data ) && ( b < 0x04 ) ){
+         send();
+         wait_ms( 2 );
+      }
+   }
+
+   void cursor_set_implementation( xy ) override {
+      address_valid = false;
+   }
 
    void putc_implementation( char chr ) override {
-      // the NVI putc() handles the x and y variables
-      
-      // handle the gap for 1-line displays
-      if( ( size.x == 1 ) && ( cursor.x == 8 ) ){
-         cursor_set( cursor );
-      }   
-      
+      auto & shown = shadow[ cursor.x + size.x * cursor.y ];
+      if( shown == chr ){
+         address_valid = false;
+         return;
+      }
+      if( ( ! address_valid ) || ( ( size.y == 1 ) && ( cursor.x == 8 ) ) ){
+         hd44780_base::cursor_set_implementation( cursor );
+         address_valid = true;
+      }
       data( chr );
-   }  
-   
-}; // class hd44780
+      shown = chr;
+   }
+
+public:
+
+   /// construct an interface to an hd44780 on a PCF8574 backpack
+   /// 
+   /// This constructor creates an interface to an hd44780 LCD 
+   /// controller from the I2C bus, the address of the PCF8574 
+   /// (0x27 for a PCF8574, 0x3F for a PCF8574A with all address
+   /// pins high) and the number of lines and characters per line, 
+   /// and initializes the controller.
+   /// The size must be at most 80 characters,
+   /// a larger size is a panic.
+   hd44780_pcf8574( 
+      i2c_bus & bus, 
+      uint_fast8_t address, 
+      xy size
+   ):
+      hd44780_base{ size },
+      bus( bus ),
+      address( address ),
+      backlight_bit( 0x08 ),
+      buffer_length( 0 ),
+      address_valid( false )
+   {
+      // the shadow has room for 80 characters
+      if( size.x * size.y > static_cast< int_fast16_t >( sizeof( shadow ) ) ){
+         HWLIB_PANIC_WITH_LOCATION;
+      }
+
+      // give LCD time to wake up
+      bus.write( address ).write( backlight_bit );
+      wait_ms( 100  );
+
+      initialize();
+   }
+
+   /// switch the backlight on or off
+   void backlight( bool on ){
+      send();
+      backlight_bit = on ? 0x08 : 0x00;
+      bus.write( address ).write( backlight_bit );
+   }
+
+   void clear() override {
+      for( auto & c : shadow ){
+         c = ' ';
+      }
+      hd44780_base::clear();
+   }
+
+   /// write the characters that are not yet written to the LCD
+   ///
+   /// This also puts the address (which is shown when 
+   /// the cursor is switched on) at the cursor.
+   void flush() override {
+      if( ( ! address_valid ) 
+         && ( cursor.x >= 0 ) && ( cursor.x < size.x )
+         && ( cursor.y >= 0 ) && ( cursor.y < size.y )
+      ){
+         hd44780_base::cursor_set_implementation( cursor );
+         address_valid = true;
+      }
+      send();
+   }
+
+}; // class hd44780_pcf8574
    
 }; // namespace hwlib
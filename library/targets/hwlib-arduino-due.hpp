@@ -16,6 +16,9 @@
 #ifndef HWLIB_ARDUINO_DUE_H
 #define HWLIB_ARDUINO_DUE_H
 
+#ifdef HWLIB_UART_BUFFERED
+   #define _HWLIB_TARGET_UART_WRITE
+#endif
 #include HWLIB_INCLUDE( ../hwlib-all.hpp )
 
 #define register
@@ -980,6 +983,63 @@ void uart_putc( char c ){
 
 #endif
 
+#ifdef HWLIB_UART_BUFFERED
+
+/// interrupt-driven buffered UART
+///
+/// When HWLIB_UART_BUFFERED is defined, the console (cout and cin)
+/// uses this UART, which is served by the UART interrupt.
+/// The transmit interrupt is enabled when there are characters
+/// to send, and disabled when the transmit buffer is empty.
+class uart_interrupt : public hwlib::uart_buffered<> {
+private:
+
+   void tx_start() override {
+      UART->UART_IER = UART_IER_TXRDY;
+   }
+
+public:
+
+   /// initialize the UART, and enable its receive interrupt
+   uart_interrupt(){
+      uart_init();
+      UART->UART_IER = UART_IER_RXRDY;
+      NVIC_EnableIRQ( UART_IRQn );
+   }
+   
+   /// the interrupt service routine
+   void interrupt(){
+      const auto status = UART->UART_SR & UART->UART_IMR;
+      if( ( status & UART_SR_RXRDY ) != 0 ){
+         rx_put( UART->UART_RHR );
+      }
+      if( ( status & UART_SR_TXRDY ) != 0 ){
+         char c;
+         if( tx_get( c ) ){
+            UART->UART_THR = c;
+         } else {
+            UART->UART_IDR = UART_IDR_TXRDY;
+         }
+      }
+   }
+   
+}; // class uart_interrupt
+
+/// the buffered UART used for the console
+extern uart_interrupt console_uart;
+
+#ifdef _HWLIB_ONCE
+
+uart_interrupt console_uart;
+
+extern "C" void UART_Handler(){
+   console_uart.interrupt();
+}
+
+#endif
+
+#endif
+
 }; // namespace due
 
 namespace hwlib {
@@ -993,7 +1053,25 @@ void wait_us( int_fast32_t n );
 void wait_ms( int_fast32_t n ); 
 
 #define HWLIB_USE_HW_UART 
-#ifdef HWLIB_USE_HW_UART
+#if defined( HWLIB_UART_BUFFERED )
+
+void HWLIB_WEAK uart_putc( char c ){
+   due::console_uart.putc( c );
+}
+
+void HWLIB_WEAK uart_write( const char * s, size_t n ){
+   due::console_uart.write( s, n );
+}
+
+bool HWLIB_WEAK uart_char_available(){
+   return due::console_uart.char_available();
+}
+
+char HWLIB_WEAK uart_getc( ){
+   return due::console_uart.getc();
+}
+
+#elif defined( HWLIB_USE_HW_UART )
 
 void HWLIB_WEAK uart_putc( char c ){
    due::uart_putc( c );
@@ -0,0 +1,1363 @@
+// ==========================================================================
+//
+// File      : hwlib-native-emulators.hpp
+// Part of   : C++ hwlib library for close-to-the-hardware OO programming
+// Copyright : wouter@voti.nl 2017-2019
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// included only via hwlib-native-linux.hpp,
+// hence no multiple-include guard is needed
+
+// this file contains Doxygen lines
+/// @file
+
+namespace hwlib {
+
+
+// ==========================================================================
+//
+// emulator_pin
+//
+// ==========================================================================
+
+/// output pin of an emulated display controller
+///
+/// An emulator_pin remembers the value that was written to it.
+/// When the value changes, the function on_change is called
+/// (when it is set), which is how an emulator sees a clock edge.
+class emulator_pin : public pin_out {
+public:
+
+   /// the last value written to the pin
+   bool value;
+
+   /// called with the new value when the value changes
+   std::function< void( bool ) > on_change;
+
+   /// create an emulator pin with an initial value
+   emulator_pin( bool value = true ):
+      value( value )
+   {}
+
+   void write( bool v ) override {
+      if( v != value ){
+         value = v;
+         if( on_change ){
+            on_change( v );
+         }
+      }
+   }
+
+   void flush() override {}
+
+}; // class emulator_pin
+
+
+// ==========================================================================
+//
+// emulator_counters
+//
+// ==========================================================================
+
+/// bus traffic counters of an emulated display controller
+///
+/// A transaction is an I2C transaction or a selection of the chip
+/// (chip select low) for SPI.
+/// The bytes of I2C include the address bytes.
+class emulator_counters {
+public:
+
+   /// the number of bytes transferred to the controller
+   uint_fast64_t bytes = 0;
+
+   /// the number of transactions
+   uint_fast64_t transactions = 0;
+
+   /// set the counters to 0
+   void reset_counters(){
+      bytes = 0;
+      transactions = 0;
+   }
+
+}; // class emulator_counters
+
+
+// ==========================================================================
+//
+// ssd1306_emulator
+//
+// ==========================================================================
+
+/// emulated SSD1306 128 x 64 OLED controller
+///
+/// This class decodes the I2C or SPI traffic to an SSD1306 controller,
+/// and keeps the resulting display RAM and settings.
+/// Pass its i2c member (I2C) or its spi, res, dc and cs members (SPI)
+/// to an unchanged hwlib SSD1306 driver, and check the result with
+/// read(), or render() it to a window, for instance a headless
+/// target::window that can write it to a file.
+///
+/// The command set is emulated: the horizontal, vertical and page
+/// addressing modes, the column, page and start line pointers,
+/// the display offset, segment remap and COM scan direction,
+/// inverse and entire display on, display on/off and the continuous
+/// horizontal scrolling (one step per scroll_step() call).
+/// The contrast and the timing related settings are accepted
+/// but have no effect.
+///
+/// The image is shown as on a typical module, which is upright when
+/// the segment remap is on and the COM scan is reversed
+/// (which is what the hwlib initialization does).
+class ssd1306_emulator : public emulator_counters {
+private:
+
+   class i2c_interface : public i2c_primitives {
+   private:
+
+      ssd1306_emulator & chip;
+
+      enum class states { address, control, single, stream, ignore };
+      states state = states::ignore;
+      bool is_data = false;
+
+   public:
+
+      i2c_interface( ssd1306_emulator & chip ):
+         chip( chip )
+      {}
+
+      void write_bit( bool ) override {}
+
+      bool read_bit() override {
+         return 0;
+      }
+
+      void write_start() override {
+         ++chip.transactions;
+         state = states::address;
+      }
+
+      void write_stop() override {
+         state = states::ignore;
+      }
+
+      void write( uint8_t x ) override;
+
+      using i2c_primitives::write;
+
+   }; // class i2c_interface
+
+   class spi_interface : public spi_bus {
+   private:
+
+      ssd1306_emulator & chip;
+
+      void write_and_read(
+         const size_t n,
+         const uint8_t data_out[],
+         uint8_t data_in[]
+      ) override;
+
+   public:
+
+      spi_interface( ssd1306_emulator & chip ):
+         chip( chip )
+      {}
+
+   }; // class spi_interface
+
+   i2c_interface i2c_side;
+
+   uint8_t address;
+
+   // the display ram: 8 pages of 128 columns
+   uint8_t ram[ 8 ][ 128 ];
+
+   // the command that is being received, and its parameters
+   uint8_t command_bytes[ 8 ];
+   uint_fast8_t command_length;
+   uint_fast8_t command_needed;
+
+   uint8_t mode;
+   uint_fast8_t column, column_start, column_end;
+   uint_fast8_t page, page_start, page_end;
+   uint_fast8_t start_line, display_offset;
+   bool display_on, inverse, entire_on, segment_remap, com_reverse;
+
+   bool scrolling;
+   bool scroll_left;
+   uint_fast8_t scroll_page_start, scroll_page_end;
+
+   // the number of parameter bytes of a command
+   static uint_fast8_t parameters( uint8_t c );
+
+   void execute();
+
+public:
+
+   /// the I2C bus to pass to an I2C driver
+   i2c_bus i2c;
+
+   /// the SPI bus to pass to a SPI driver
+   spi_interface spi;
+
+   /// the pins to pass to a SPI driver
+   emulator_pin res, dc, cs;
+
+   /// the size of the display
+   static constexpr xy size = xy( 128, 64 );
+
+   /// create an emulated SSD1306, which uses the I2C address
+   ssd1306_emulator( uint8_t address = 0x3C ):
+      i2c_side( *this ),
+      address( address ),
+      i2c( i2c_side ),
+      spi( *this )
+   {
+      reset();
+      cs.on_change = [ this ]( bool v ){
+         if( ! v ){
+            ++transactions;
+         }
+      };
+      res.on_change = [ this ]( bool v ){
+         if( ! v ){
+            reset();
+         }
+      };
+   }
+
+   /// reset the controller to its power-on state
+   ///
+   /// The display ram is not changed.
+   void reset();
+
+   /// handle a command byte
+   void command( uint8_t d );
+
+   /// handle a data byte
+   void data( uint8_t d );
+
+   /// do one step of the horizontal scrolling, when it is active
+   void scroll_step();
+
+   /// the color (black or white) that a pixel of the display shows
+   color read( xy pos ) const;
+
+   /// write the pixels of the display to a window
+   void render( window & w, xy origin = xy( 0, 0 ) ) const;
+
+}; // class ssd1306_emulator
+
+
+// ==========================================================================
+//
+// st7789_emulator
+//
+// ==========================================================================
+
+/// emulated ST7789 color LCD controller
+///
+/// This class decodes the SPI traffic to an ST7789 controller
+/// and keeps the resulting display RAM (240 x 320 pixels) and settings.
+/// Pass its spi, dc, cs and rst members to an unchanged hwlib
+/// ST7789 driver, and check the result with read(),
+/// or render() it to a window.
+///
+/// The command set is emulated: the column and row address windows,
+/// RAMWR and RAMWRC (12, 16 and 18 bit pixels), the memory data access
+/// control (row/column exchange and mirroring), the vertical scrolling
+/// definition and start address, inversion and display on/off.
+/// The other commands are accepted but have no effect.
+///
+/// A typical 240 x 240 module has an IPS panel that shows
+/// the inverse colors unless the inversion is on (INVON).
+/// Specify ips = false for a panel that doesn't.
+class st7789_emulator : public emulator_counters {
+private:
+
+   class spi_interface : public spi_bus {
+   private:
+
+      st7789_emulator & chip;
+
+      void write_and_read(
+         const size_t n,
+         const uint8_t data_out[],
+         uint8_t data_in[]
+      ) override;
+
+   public:
+
+      spi_interface( st7789_emulator & chip ):
+         chip( chip )
+      {}
+
+   }; // class spi_interface
+
+   static constexpr int_fast16_t ram_width  = 240;
+   static constexpr int_fast16_t ram_height = 320;
+
+   std::vector< color > ram;
+   bool ips;
+
+   uint8_t current;
+   uint8_t parameter_bytes[ 8 ];
+   uint_fast8_t parameter_length;
+
+   // the received bytes of the current pixel
+   uint8_t pixel[ 3 ];
+   uint_fast8_t pixel_length;
+
+   uint8_t colmod, madctl;
+   int_fast16_t column_start, column_end, row_start, row_end;
+   int_fast16_t column, row;
+   int_fast16_t top_fixed, scroll_area, scroll_start;
+   bool display_on, inverse, writing;
+
+   void write_pixel( color c );
+
+   void parameter( uint8_t d );
+
+public:
+
+   /// the SPI bus to pass to the driver
+   spi_interface spi;
+
+   /// the pins to pass to the driver
+   emulator_pin dc, cs, rst;
+
+   /// the size of the panel
+   const xy size;
+
+   /// create an emulated ST7789 for a panel of the specified size
+   st7789_emulator( xy size = xy( 240, 240 ), bool ips = true ):
+      ram( ram_width * ram_height, black ),
+      ips( ips ),
+      spi( *this ),
+      size( size )
+   {
+      reset();
+      cs.on_change = [ this ]( bool v ){
+         if( ! v ){
+            ++transactions;
+         }
+      };
+      rst.on_change = [ this ]( bool v ){
+         if( ! v ){
+            reset();
+         }
+      };
+   }
+
+   /// reset the controller to its power-on state
+   ///
+   /// The display ram is not changed.
+   void reset();
+
+   /// handle a command byte
+   void command( uint8_t d );
+
+   /// handle a data byte
+   void data( uint8_t d );
+
+   /// the color that a pixel of the panel shows
+   color read( xy pos ) const;
+
+   /// write the pixels of the panel to a window
+   void render( window & w, xy origin = xy( 0, 0 ) ) const;
+
+}; // class st7789_emulator
+
+
+// ==========================================================================
+//
+// pcd8544_emulator
+//
+// ==========================================================================
+
+/// emulated PCD8544 (Nokia 5510) 84 x 48 LCD controller
+///
+/// This class decodes the SPI traffic to a PCD8544 controller,
+/// and keeps the resulting display RAM and settings.
+/// Pass its spi, sce, res and dc members to glcd_5510_spi_sce_res_dc,
+/// or its sce, res, dc, sdin and sclk pins to the bit-banged glcd_5510.
+///
+/// The command set is emulated: the horizontal and vertical addressing,
+/// the X and Y address, the display modes (blank, normal, all on,
+/// inverse) and power down.
+/// The extended instructions (Vop, bias, temperature coefficient)
+/// are accepted but have no effect.
+class pcd8544_emulator : public emulator_counters {
+private:
+
+   class spi_interface : public spi_bus {
+   private:
+
+      pcd8544_emulator & chip;
+
+      void write_and_read(
+         const size_t n,
+         const uint8_t data_out[],
+         uint8_t data_in[]
+      ) override;
+
+   public:
+
+      spi_interface( pcd8544_emulator & chip ):
+         chip( chip )
+      {}
+
+   }; // class spi_interface
+
+   uint8_t ram[ 6 ][ 84 ];
+
+   uint_fast8_t x, y;
+   bool extended, vertical, power_down;
+
+   // D and E bits of the display control
+   uint8_t display_mode;
+
+   uint8_t shift;
+   uint_fast8_t bits;
+
+public:
+
+   /// the SPI bus to pass to glcd_5510_spi_sce_res_dc
+   spi_interface spi;
+
+   /// the pins to pass to the driver
+   emulator_pin sce, res, dc, sdin, sclk;
+
+   /// the size of the display
+   static constexpr xy size = xy( 84, 48 );
+
+   /// create an emulated PCD8544
+   pcd8544_emulator():
+      ram{},
+      spi( *this ),
+      sdin( false ),
+      sclk( false )
+   {
+      reset();
+      sce.on_change = [ this ]( bool v ){
+         if( ! v ){
+            ++transactions;
+            bits = 0;
+         }
+      };
+      res.on_change = [ this ]( bool v ){
+         if( ! v ){
+            reset();
+         }
+      };
+      sclk.on_change = [ this ]( bool v ){
+         if( v && ! sce.value ){
+            shift = ( shift << 1 ) | ( sdin.value ? 1 : 0 );
+            if( ++bits == 8 ){
+               bits = 0;
+               ++bytes;
+               byte( shift );
+            }
+         }
+      };
+   }
+
+   /// reset the controller to its power-on state
+   ///
+   /// The display ram is not changed.
+   void reset();
+
+   /// handle a byte, which is a command or data depending on dc
+   void byte( uint8_t d );
+
+   /// the color (black or white) that a pixel of the display shows
+   color read( xy pos ) const;
+
+   /// write the pixels of the display to a window
+   void render( window & w, xy origin = xy( 0, 0 ) ) const;
+
+}; // class pcd8544_emulator
+
+
+// ==========================================================================
+//
+// hd44780_emulator
+//
+// ==========================================================================
+
+/// emulated HD44780 character LCD controller
+///
+/// This class decodes the traffic on the rs, rw, e and (4-bit or
+/// 8-bit) data pins of a HD44780 controller, and keeps the resulting
+/// DDRAM, CGRAM and settings.
+/// Pass its rs, (rw,) e and data (or data8) members to an unchanged
+/// hwlib hd44780 driver, or its i2c member (a PCF8574 backpack) to
+/// hd44780_pcf8574, and check the result with at() or line(),
+/// or render() it to a window.
+/// The bytes counter counts the bytes written (each two nibbles in 
+/// 4-bit mode), the transactions counter the enable pulses.
+/// The backpack member counts the I2C bytes and transactions.
+///
+/// Reading is emulated too: the busy flag is set for the (typical)
+/// execution time of an instruction after it is written.
+///
+/// The instruction set is emulated: the 8-bit and 4-bit modes,
+/// the 1 and 2 line DDRAM layout, the entry mode (increment or
+/// decrement, with or without display shift), the cursor and display
+/// shift, display on/off, the cursor and the user-defined characters.
+///
+/// The character generator ROM is not emulated: render() shows
+/// the characters 0x20 .. 0x7F with the default 8 x 8 font,
+/// and the user-defined characters from their CGRAM patterns.
+class hd44780_emulator : public emulator_counters {
+private:
+
+   class data_port : public port_out, public port_in_out {
+   private:
+
+      hd44780_emulator & chip;
+      uint_fast8_t pins;
+
+   public:
+
+      data_port( hd44780_emulator & chip, uint_fast8_t pins ):
+         chip( chip ),
+         pins( pins )
+      {}
+
+      uint_fast8_t number_of_pins() override {
+         return pins;
+      }
+
+      // a 4-bit port is connected to D4 .. D7
+      void write( uint_fast16_t x ) override {
+         chip.bus_value = ( pins == 4 ) ? ( x & 0x0F ) << 4 : x & 0xFF;
+      }
+
+      uint_fast16_t read() override {
+         return ( pins == 4 ) ? chip.read_value >> 4 : chip.read_value;
+      }
+
+      void direction_set_input() override {}
+
+      void direction_set_output() override {}
+
+      void direction_flush() override {}
+
+      void refresh() override {}
+
+      void flush() override {}
+
+   }; // class data_port
+
+   class pcf8574_interface :
+      public i2c_primitives,
+      public emulator_counters
+   {
+   private:
+
+      hd44780_emulator & chip;
+      uint8_t address;
+      bool selected = false, first = false;
+
+   public:
+
+      pcf8574_interface( hd44780_emulator & chip, uint8_t address ):
+         chip( chip ),
+         address( address )
+      {}
+
+      void write_bit( bool ) override {}
+
+      bool read_bit() override {
+         return 0;
+      }
+
+      void write_start() override {
+         ++transactions;
+         selected = first = true;
+      }
+
+      void write_stop() override {
+         selected = false;
+      }
+
+      // P0 = RS, P2 = E, P4 .. P7 = D4 .. D7
+      void write( uint8_t x ) override {
+         if( ! selected ){
+            return;
+         }
+         ++bytes;
+         if( first ){
+            first = false;
+            selected = ( x >> 1 ) == address;
+            return;
+         }
+         chip.bus_value = x & 0xF0;
+         chip.rs.write( ( x & 0x01 ) != 0 );
+         chip.e.write( ( x & 0x04 ) != 0 );
+      }
+
+      using i2c_primitives::write;
+
+   }; // class pcf8574_interface
+
+   uint8_t ddram[ 0x80 ];
+   uint8_t cgram[ 64 ];
+
+   // the value on D7 .. D0, written by the driver or by the controller
+   uint8_t bus_value;
+   uint8_t read_value;
+
+   uint8_t high_nibble;
+   bool eight_bit, second_nibble, second_read, two_lines;
+   bool increment, shift_display, display_on, cursor_on, blink_on;
+   bool address_in_cgram;
+   uint8_t address;
+   int_fast8_t display_shift;
+   uint_fast64_t busy_until;
+
+   // the DDRAM address of a position on the display
+   uint8_t position_address( xy pos ) const;
+
+   void step_address( bool forward );
+
+   void byte( bool is_data, uint8_t d );
+
+   void enable( bool v );
+
+public:
+
+   /// the pins to pass to the driver
+   emulator_pin rs, rw, e;
+
+   /// the 4-bit data port to pass to the driver,
+   /// bit 0 is the D4 pin of the controller
+   data_port data;
+
+   /// the 8-bit data port to pass to the driver,
+   /// bit 0 is the D0 pin of the controller
+   data_port data8;
+
+   /// the PCF8574 backpack, with the I2C bus traffic counters
+   pcf8574_interface backpack;
+
+   /// the I2C bus to pass to hd44780_pcf8574
+   i2c_bus i2c;
+
+   /// the size of the display in characters
+   const xy size;
+
+   /// create an emulated HD44780 for a display of the specified size,
+   /// the backpack uses the I2C address
+   hd44780_emulator( xy size = xy( 16, 2 ), uint8_t address = 0x27 ):
+      cgram{},
+      rs( false ),
+      rw( false ),
+      e( false ),
+      data( *this, 4 ),
+      data8( *this, 8 ),
+      backpack( *this, address ),
+      i2c( backpack ),
+      size( size )
+   {
+      reset();
+      e.on_change = [ this ]( bool v ){
+         enable( v );
+      };
+   }
+
+   /// reset the controller to its power-on state
+   ///
+   /// Like the real controller, it starts in 8-bit mode.
+   void reset();
+
+   /// whether the controller is busy
+   bool busy() const {
+      return now_us() < busy_until;
+   }
+
+   /// the character that is shown at a position of the display
+   char at( xy pos ) const;
+
+   /// the characters that are shown on a line of the display
+   std::string line( int_fast16_t y ) const;
+
+   /// the cursor position, or xy( -1, -1 ) when it is not visible
+   xy cursor() const;
+
+   /// write the characters of the display to a window,
+   /// 8 x 8 pixels per character
+   void render( window & w, xy origin = xy( 0, 0 ) ) const;
+
+}; // class hd44780_emulator
+
+
+// ===========================================================================
+//
+// implementations
+//
+// ===========================================================================
+
+#ifdef _HWLIB_ONCE
+
+// ========== ssd1306
+
+void ssd1306_emulator::i2c_interface::write( uint8_t x ){
+   if( state == states::ignore ){
+      return;
+   }
+   ++chip.bytes;
+   switch( state ){
+      case states::address:
+         state = ( ( x >> 1 ) == chip.address ) && ( ( x & 0x01 ) == 0 )
+            ? states::control
+            : states::ignore;
+         break;
+      case states::control:
+         is_data = ( x & 0x40 ) != 0;
+         state = ( x & 0x80 ) ? states::single : states::stream;
+         break;
+      case states::single:
+      case states::stream:
+         if( is_data ){
+            chip.data( x );
+         } else {
+            chip.command( x );
+         }
+         if( state == states::single ){
+            state = states::control;
+         }
+         break;
+      case states::ignore:
+         break;
+   }
+}
+
+void ssd1306_emulator::spi_interface::write_and_read(
+   const size_t n,
+   const uint8_t data_out[],
+   uint8_t data_in[]
+){
+   for( size_t i = 0; i < n; ++i ){
+      if( ! chip.cs.value ){
+         ++chip.bytes;
+         const uint8_t d = ( data_out == nullptr ) ? 0 : data_out[ i ];
+         if( chip.dc.value ){
+            chip.data( d );
+         } else {
+            chip.command( d );
+         }
+      }
+      if( data_in != nullptr ){
+         data_in[ i ] = 0;
+      }
+   }
+}
+
+void ssd1306_emulator::reset(){
+   command_length = 0;
+   command_needed = 0;
+   mode = 2;
+   column = column_start = 0;
+   column_end = 127;
+   page = page_start = 0;
+   page_end = 7;
+   start_line = display_offset = 0;
+   display_on = inverse = entire_on = false;
+   segment_remap = com_reverse = false;
+   scrolling = scroll_left = false;
+   scroll_page_start = scroll_page_end = 0;
+}
+
+uint_fast8_t ssd1306_emulator::parameters( uint8_t c ){
+   switch( c ){
+      case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+      case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+         return 1;
+      case 0x21: case 0x22: case 0xA3:
+         return 2;
+      case 0x29: case 0x2A:
+         return 5;
+      case 0x26: case 0x27:
+         return 6;
+      default:
+         return 0;
+   }
+}
+
+void ssd1306_emulator::command( uint8_t d ){
+   if( command_length == 0 ){
+      command_needed = parameters( d );
+   }
+   command_bytes[ command_length++ ] = d;
+   if( command_length > command_needed ){
+      execute();
+      command_length = 0;
+   }
+}
+
+void ssd1306_emulator::execute(){
+   const auto c = command_bytes[ 0 ];
+   const auto p = command_bytes + 1;
+   if( c < 0x10 ){
+      column = ( column & 0xF0 ) | c;
+   } else if( c < 0x20 ){
+      column = ( column & 0x0F ) | ( ( c & 0x07 ) << 4 );
+   } else if( c == 0x20 ){
+      mode = p[ 0 ] & 0x03;
+   } else if( c == 0x21 ){
+      column = column_start = p[ 0 ] & 0x7F;
+      column_end = p[ 1 ] & 0x7F;
+   } else if( c == 0x22 ){
+      page = page_start = p[ 0 ] & 0x07;
+      page_end = p[ 1 ] & 0x07;
+   } else if( ( c == 0x26 ) || ( c == 0x27 ) ){
+      scroll_left = c == 0x27;
+      scroll_page_start = p[ 1 ] & 0x07;
+      scroll_page_end = p[ 3 ] & 0x07;
+   } else if( ( c == 0x29 ) || ( c == 0x2A ) ){
+      scroll_left = c == 0x2A;
+      scroll_page_start = p[ 1 ] & 0x07;
+      scroll_page_end = p[ 3 ] & 0x07;
+   } else if( c == 0x2E ){
+      scrolling = false;
+   } else if( c == 0x2F ){
+      scrolling = true;
+   } else if( ( c >= 0x40 ) && ( c < 0x80 ) ){
+      start_line = c & 0x3F;
+   } else if( ( c == 0xA0 ) || ( c == 0xA1 ) ){
+      segment_remap = c == 0xA1;
+   } else if( ( c == 0xA4 ) || ( c == 0xA5 ) ){
+      entire_on = c == 0xA5;
+   } else if( ( c == 0xA6 ) || ( c == 0xA7 ) ){
+      inverse = c == 0xA7;
+   } else if( ( c == 0xAE ) || ( c == 0xAF ) ){
+      display_on = c == 0xAF;
+   } else if( ( c >= 0xB0 ) && ( c < 0xB8 ) ){
+      page = c & 0x07;
+   } else if( ( c == 0xC0 ) || ( c == 0xC8 ) ){
+      com_reverse = c == 0xC8;
+   } else if( c == 0xD3 ){
+      display_offset = p[ 0 ] & 0x3F;
+   }
+}
+
+void ssd1306_emulator::data( uint8_t d ){
+   ram[ page ][ column ] = d;
+   if( mode == 0 ){
+      if( column++ == column_end ){
+         column = column_start;
+         page = ( page == page_end ) ? page_start : ( page + 1 ) & 0x07;
+      }
+   } else if( mode == 1 ){
+      if( page++ == page_end ){
+         page = page_start;
+         column = ( column == column_end ) ? column_start : ( column + 1 ) & 0x7F;
+      }
+   } else if( column < 127 ){
+      ++column;
+   }
+}
+
+void ssd1306_emulator::scroll_step(){
+   if( ! scrolling ){
+      return;
+   }
+   for( auto p = scroll_page_start; p <= scroll_page_end; ++p ){
+      auto & r = ram[ p ];
+      if( scroll_left ){
+         const auto first = r[ 0 ];
+         for( int i = 0; i < 127; ++i ){
+            r[ i ] = r[ i + 1 ];
+         }
+         r[ 127 ] = first;
+      } else {
+         const auto last = r[ 127 ];
+         for( int i = 127; i > 0; --i ){
+            r[ i ] = r[ i - 1 ];
+         }
+         r[ 0 ] = last;
+      }
+   }
+}
+
+color ssd1306_emulator::read( xy pos ) const {
+   if( ! display_on ){
+      return black;
+   }
+   const auto row = com_reverse ? pos.y : 63 - pos.y;
+   const auto line = ( row + start_line + display_offset ) % 64;
+   const auto col = segment_remap ? pos.x : 127 - pos.x;
+   const bool on = entire_on
+      || ( ( ( ram[ line / 8 ][ col ] >> ( line % 8 ) ) & 0x01 ) != 0 );
+   return ( on != inverse ) ? white : black;
+}
+
+void ssd1306_emulator::render( window & w, xy origin ) const {
+   for( int_fast16_t y = 0; y < size.y; ++y ){
+      for( int_fast16_t x = 0; x < size.x; ++x ){
+         w.write( origin + xy( x, y ), read( xy( x, y ) ) );
+      }
+   }
+}
+
+// ========== st7789
+
+void st7789_emulator::spi_interface::write_and_read(
+   const size_t n,
+   const uint8_t data_out[],
+   uint8_t data_in[]
+){
+   for( size_t i = 0; i < n; ++i ){
+      if( ! chip.cs.value ){
+         ++chip.bytes;
+         const uint8_t d = ( data_out == nullptr ) ? 0 : data_out[ i ];
+         if( chip.dc.value ){
+            chip.data( d );
+         } else {
+            chip.command( d );
+         }
+      }
+      if( data_in != nullptr ){
+         data_in[ i ] = 0;
+      }
+   }
+}
+
+void st7789_emulator::reset(){
+   current = 0;
+   parameter_length = 0;
+   pixel_length = 0;
+   colmod = 0x66;
+   madctl = 0;
+   column_start = row_start = 0;
+   column_end = ram_width - 1;
+   row_end = ram_height - 1;
+   column = row = 0;
+   top_fixed = 0;
+   scroll_area = ram_height;
+   scroll_start = 0;
+   display_on = inverse = writing = false;
+}
+
+void st7789_emulator::command( uint8_t d ){
+   current = d;
+   parameter_length = 0;
+   writing = false;
+   switch( d ){
+      case 0x01:
+         reset();
+         break;
+      case 0x20:
+      case 0x21:
+         inverse = d == 0x21;
+         break;
+      case 0x28:
+      case 0x29:
+         display_on = d == 0x29;
+         break;
+      case 0x2C:
+         column = column_start;
+         row = row_start;
+         pixel_length = 0;
+         writing = true;
+         break;
+      case 0x3C:
+         pixel_length = 0;
+         writing = true;
+         break;
+      default:
+         break;
+   }
+}
+
+void st7789_emulator::parameter( uint8_t d ){
+   if( parameter_length < sizeof( parameter_bytes ) ){
+      parameter_bytes[ parameter_length++ ] = d;
+   }
+   const auto p = parameter_bytes;
+   if( ( current == 0x2A ) && ( parameter_length == 4 ) ){
+      column_start = ( p[ 0 ] << 8 ) | p[ 1 ];
+      column_end   = ( p[ 2 ] << 8 ) | p[ 3 ];
+   } else if( ( current == 0x2B ) && ( parameter_length == 4 ) ){
+      row_start = ( p[ 0 ] << 8 ) | p[ 1 ];
+      row_end   = ( p[ 2 ] << 8 ) | p[ 3 ];
+   } else if( ( current == 0x33 ) && ( parameter_length == 6 ) ){
+      top_fixed   = ( p[ 0 ] << 8 ) | p[ 1 ];
+      scroll_area = ( p[ 2 ] << 8 ) | p[ 3 ];
+   } else if( ( current == 0x37 ) && ( parameter_length == 2 ) ){
+      scroll_start = ( p[ 0 ] << 8 ) | p[ 1 ];
+   } else if( current == 0x36 ){
+      madctl = d;
+   } else if( current == 0x3A ){
+      colmod = d;
+   }
+}
+
+void st7789_emulator::write_pixel( color c ){
+
+   // the memory data access control maps the address to the ram
+   auto x = column;
+   auto y = row;
+   if( madctl & 0x20 ){
+      std::swap( x, y );
+   }
+   if( madctl & 0x40 ){
+      x = ram_width - 1 - x;
+   }
+   if( madctl & 0x80 ){
+      y = ram_height - 1 - y;
+   }
+   if( ( x >= 0 ) && ( x < ram_width ) && ( y >= 0 ) && ( y < ram_height ) ){
+      ram[ x + ram_width * y ] = c;
+   }
+
+   if( column++ == column_end ){
+      column = column_start;
+      if( row++ == row_end ){
+         row = row_start;
+      }
+   }
+}
+
+void st7789_emulator::data( uint8_t d ){
+   if( ! writing ){
+      parameter( d );
+      return;
+   }
+   pixel[ pixel_length++ ] = d;
+   const auto format = colmod & 0x07;
+   if( format == 0x03 ){
+
+      // 12 bits per pixel: 3 bytes for 2 pixels
+      if( pixel_length == 3 ){
+         const auto expand = []( uint8_t v ){ return v * 0x11; };
+         write_pixel( color(
+            expand( pixel[ 0 ] >> 4 ),
+            expand( pixel[ 0 ] & 0x0F ),
+            expand( pixel[ 1 ] >> 4 ) ) );
+         write_pixel( color(
+            expand( pixel[ 1 ] & 0x0F ),
+            expand( pixel[ 2 ] >> 4 ),
+            expand( pixel[ 2 ] & 0x0F ) ) );
+         pixel_length = 0;
+      }
+   } else if( format == 0x05 ){
+      if( pixel_length == 2 ){
+         color c;
+         pixel_unconvert( pixel_format::rgb565, pixel, 1, & c );
+         write_pixel( c );
+         pixel_length = 0;
+      }
+   } else if( pixel_length == 3 ){
+      color c;
+      pixel_unconvert( pixel_format::rgb666, pixel, 1, & c );
+      write_pixel( c );
+      pixel_length = 0;
+   }
+}
+
+color st7789_emulator::read( xy pos ) const {
+   if( ! display_on ){
+      return black;
+   }
+
+   // the vertical scrolling area shows the rows from the start address
+   auto y = pos.y;
+   if( ( y >= top_fixed ) && ( y < top_fixed + scroll_area ) ){
+      y = top_fixed + ( y - top_fixed + scroll_start - top_fixed + scroll_area )
+         % scroll_area;
+   }
+   const auto c = ram[ pos.x + ram_width * y ];
+   return ( inverse == ips ) ? c : - c;
+}
+
+void st7789_emulator::render( window & w, xy origin ) const {
+   for( int_fast16_t y = 0; y < size.y; ++y ){
+      for( int_fast16_t x = 0; x < size.x; ++x ){
+         w.write( origin + xy( x, y ), read( xy( x, y ) ) );
+      }
+   }
+}
+
+// ========== pcd8544
+
+void pcd8544_emulator::spi_interface::write_and_read(
+   const size_t n,
+   const uint8_t data_out[],
+   uint8_t data_in[]
+){
+   for( size_t i = 0; i < n; ++i ){
+      if( ! chip.sce.value ){
+         ++chip.bytes;
+         chip.byte( ( data_out == nullptr ) ? 0 : data_out[ i ] );
+      }
+      if( data_in != nullptr ){
+         data_in[ i ] = 0;
+      }
+   }
+}
+
+void pcd8544_emulator::reset(){
+   x = y = 0;
+   extended = vertical = false;
+   power_down = true;
+   display_mode = 0;
+   shift = 0;
+   bits = 0;
+}
+
+void pcd8544_emulator::byte( uint8_t d ){
+   if( dc.value ){
+      ram[ y ][ x ] = d;
+      if( vertical ){
+         if( ++y == 6 ){
+            y = 0;
+            x = ( x + 1 ) % 84;
+         }
+      } else if( ++x == 84 ){
+         x = 0;
+         y = ( y + 1 ) % 6;
+      }
+   } else if( ( d & 0xF8 ) == 0x20 ){
+      power_down = ( d & 0x04 ) != 0;
+      vertical   = ( d & 0x02 ) != 0;
+      extended   = ( d & 0x01 ) != 0;
+   } else if( ! extended ){
+      if( d & 0x80 ){
+         x = ( d & 0x7F ) % 84;
+      } else if( ( d & 0xF8 ) == 0x40 ){
+         y = ( d & 0x07 ) % 6;
+      } else if( ( d & 0xF8 ) == 0x08 ){
+         display_mode = d & 0x05;
+      }
+   }
+}
+
+color pcd8544_emulator::read( xy pos ) const {
+   bool on = false;
+   if( ! power_down ){
+      const bool bit = ( ( ram[ pos.y / 8 ][ pos.x ] >> ( pos.y % 8 ) ) & 0x01 ) != 0;
+      switch( display_mode ){
+         case 0x01: on = true;  break;
+         case 0x04: on = bit;   break;
+         case 0x05: on = ! bit; break;
+         default:   on = false; break;
+      }
+   }
+   return on ? black : white;
+}
+
+void pcd8544_emulator::render( window & w, xy origin ) const {
+   for( int_fast16_t y = 0; y < size.y; ++y ){
+      for( int_fast16_t x = 0; x < size.x; ++x ){
+         w.write( origin + xy( x, y ), read( xy( x, y ) ) );
+      }
+   }
+}
+
+// ========== hd44780
+
+void hd44780_emulator::reset(){
+   for( auto & c : ddram ){
+      c = ' ';
+   }
+   bus_value = read_value = high_nibble = 0;
+   eight_bit = true;
+   second_nibble = second_read = false;
+   two_lines = false;
+   increment = true;
+   shift_display = false;
+   display_on = cursor_on = blink_on = false;
+   address_in_cgram = false;
+   address = 0;
+   display_shift = 0;
+   busy_until = 0;
+}
+
+void hd44780_emulator::enable( bool v ){
+   if( rw.value ){
+
+      // a read: the controller puts the value on the bus while e is high
+      if( v ){
+         const uint8_t value = rs.value
+            ? ( address_in_cgram ? cgram[ address ] : ddram[ address ] )
+            : ( ( busy() ? 0x80 : 0x00 ) | ( address & 0x7F ) );
+         read_value = ( second_read && ! eight_bit ) ? value << 4 : value;
+      } else {
+         ++transactions;
+         if( ( ! eight_bit ) && ( ! second_read ) ){
+            second_read = true;
+         } else {
+            second_read = false;
+            if( rs.value ){
+               step_address( increment );
+            }
+         }
+      }
+      return;
+   }
+
+   // a write: the controller takes the value from the bus when e goes low
+   if( v ){
+      return;
+   }
+   ++transactions;
+   second_read = false;
+   if( eight_bit ){
+      byte( rs.value, bus_value );
+   } else if( ! second_nibble ){
+      high_nibble = bus_value >> 4;
+      second_nibble = true;
+   } else {
+      second_nibble = false;
+      byte( rs.value, ( high_nibble << 4 ) | ( bus_value >> 4 ) );
+   }
+}
+
+void hd44780_emulator::step_address( bool forward ){
+   if( address_in_cgram ){
+      address = ( address + ( forward ? 1 : 63 ) ) & 0x3F;
+   } else if( ! two_lines ){
+      address = ( address + ( forward ? 1 : 79 ) ) % 80;
+   } else {
+
+      // the two lines are 0x00 .. 0x27 and 0x40 .. 0x67
+      auto a = ( address & 0x3F ) + ( ( address & 0x40 ) ? 40 : 0 );
+      a = ( a + ( forward ? 1 : 79 ) ) % 80;
+      address = ( a < 40 ) ? a : 0x40 + ( a - 40 );
+   }
+}
+
+void hd44780_emulator::byte( bool is_data, uint8_t d ){
+   ++bytes;
+   busy_until = now_us() + ( ( ( ! is_data ) && ( d < 0x04 ) ) ? 1'520 : 37 );
+   if( is_data ){
+      if( address_in_cgram ){
+         cgram[ address ] = d;
+      } else {
+         ddram[ address ] = d;
+         if( shift_display ){
+            display_shift += increment ? 1 : -1;
+         }
+      }
+      step_address( increment );
+   } else if( d & 0x80 ){
+      address = d & 0x7F;
+      address_in_cgram = false;
+   } else if( d & 0x40 ){
+      address = d & 0x3F;
+      address_in_cgram = true;
+   } else if( d & 0x20 ){
+      eight_bit = ( d & 0x10 ) != 0;
+      two_lines = ( d & 0x08 ) != 0;
+      second_nibble = false;
+   } else if( d & 0x10 ){
+      const bool right = ( d & 0x04 ) != 0;
+      if( d & 0x08 ){
+         display_shift += right ? -1 : 1;
+      } else {
+         address_in_cgram = false;
+         step_address( right );
+      }
+   } else if( d & 0x08 ){
+      display_on = ( d & 0x04 ) != 0;
+      cursor_on  = ( d & 0x02 ) != 0;
+      blink_on   = ( d & 0x01 ) != 0;
+   } else if( d & 0x04 ){
+      increment     = ( d & 0x02 ) != 0;
+      shift_display = ( d & 0x01 ) != 0;
+   } else if( d & 0x02 ){
+      address = 0;
+      address_in_cgram = false;
+      display_shift = 0;
+   } else if( d & 0x01 ){
+      for( auto & c : ddram ){
+         c = ' ';
+      }
+      address = 0;
+      address_in_cgram = false;
+      increment = true;
+      display_shift = 0;
+   }
+}
+
+uint8_t hd44780_emulator::position_address( xy pos ) const {
+   if( ! two_lines ){
+      return ( pos.x + 80 + display_shift % 80 ) % 80;
+   }
+
+   // a 1-line display of 16 characters uses the two lines,
+   // a 4-line display continues lines 0 and 1 in lines 2 and 3
+   auto line = pos.y & 0x01;
+   auto x = pos.x + ( ( pos.y & 0x02 ) ? size.x : 0 );
+   if( ( size.y == 1 ) && ( pos.x >= 8 ) ){
+      line = 1;
+      x = pos.x - 8;
+   }
+   return ( line ? 0x40 : 0x00 ) + ( x + 40 + display_shift % 40 ) % 40;
+}
+
+char hd44780_emulator::at( xy pos ) const {
+   return display_on ? ddram[ position_address( pos ) ] : ' ';
+}
+
+std::string hd44780_emulator::line( int_fast16_t y ) const {
+   std::string result;
+   for( int_fast16_t x = 0; x < size.x; ++x ){
+      result += at( xy( x, y ) );
+   }
+   return result;
+}
+
+xy hd44780_emulator::cursor() const {
+   if( display_on && ( cursor_on || blink_on ) && ! address_in_cgram ){
+      for( int_fast16_t y = 0; y < size.y; ++y ){
+         for( int_fast16_t x = 0; x < size.x; ++x ){
+            if( position_address( xy( x, y ) ) == address ){
+               return xy( x, y );
+            }
+         }
+      }
+   }
+   return xy( -1, -1 );
+}
+
+void hd44780_emulator::render( window & w, xy origin ) const {
+   static const font_default_8x8 rom;
+   const auto c = cursor();
+   for( int_fast16_t y = 0; y < size.y; ++y ){
+      for( int_fast16_t x = 0; x < size.x; ++x ){
+         const auto p = origin + xy( 8 * x, 8 * y );
+         const auto code = static_cast< uint8_t >( at( xy( x, y ) ) );
+         for( int_fast16_t i = 0; i < 8; ++i ){
+            for( int_fast16_t j = 0; j < 8; ++j ){
+               bool on;
+               if( code < 0x10 ){
+                  on = ( j < 5 )
+                     && ( ( cgram[ 8 * ( code & 0x07 ) + i ] >> ( 4 - j ) ) & 0x01 );
+               } else if( ( code >= 0x20 ) && ( code < 0x80 ) ){
+                  on = rom[ code ][ xy( j, i ) ] == black;
+               } else {
+                  on = false;
+               }
+               if( ( c == xy( x, y ) ) && ( i == 7 ) && ( j < 5 ) ){
+                  on = true;
+               }
+               w.write( p + xy( j, i ), on ? w.foreground : w.background );
+            }
+         }
+      }
+   }
+}
+
+#endif // _HWLIB_ONCE
+
+}; // namespace hwlib
@@ -0,0 +1,514 @@
+// ==========================================================================
+//
+// File      : hwlib-native-linux.hpp
+// Part of   : C++ hwlib library for close-to-the-hardware OO programming
+// Copyright : wouter@voti.nl 2017-2019
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// this file contains Doxygen lines
+/// @file
+
+#ifndef HWLIB_NATIVE_H
+#define HWLIB_NATIVE_H
+
+#define _HWLIB_TARGET_WAIT_US_BUSY
+#define _HWLIB_TARGET_UART_WRITE
+#define _HWLIB_TARGET_LOG_CATALOG
+#include HWLIB_INCLUDE( ../hwlib-all.hpp )
+#include <iostream>
+#include <cstdio>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <atomic>
+
+namespace hwlib {
+
+namespace target {
+
+/// headless native window
+///
+/// This window keeps its pixels in memory, without showing them.
+/// It is meant for running graphics regression tests and
+/// rendering benchmarks on a (build) server that has no display.
+///
+/// The pixels can be read back, and written to a file
+/// in PPM (color) or PBM (black and white) format.
+/// A file can be compared to the pixels, which is meant for
+/// comparing the result of a test to a known-good (golden) image.
+/// PPM and PBM files are read in both the binary and the ASCII variant,
+/// so golden images can be kept in a readable text format.
+///
+/// Each flush() counts as a frame, which can be dumped to a file,
+/// and the frames per second since the first flush are available.
+class window : public hwlib::window {
+private:
+
+   // the pixels, 3 bytes ( red, green, blue ) per pixel, row after row
+   std::vector< uint8_t > pixels;
+
+   const char * dump_pattern = nullptr;
+   uint_fast32_t frame_count = 0;
+   uint_fast64_t first_flush = 0;
+   uint_fast64_t last_flush = 0;
+
+   uint8_t * at( xy pos ){
+      return & pixels[ 3 * ( pos.x + size.x * pos.y ) ];
+   }
+
+   const uint8_t * at( xy pos ) const {
+      return & pixels[ 3 * ( pos.x + size.x * pos.y ) ];
+   }
+
+   void write_implementation(
+      xy pos,
+      color col
+   ) override {
+      auto p = at( pos );
+      p[ 0 ] = col.red;
+      p[ 1 ] = col.green;
+      p[ 2 ] = col.blue;
+   }
+
+   void write_span_implementation(
+      xy pos,
+      int_fast16_t n,
+      color col
+   ) override {
+      auto p = at( pos );
+      for( int_fast16_t i = 0; i < n; ++i, p += 3 ){
+         p[ 0 ] = col.red;
+         p[ 1 ] = col.green;
+         p[ 2 ] = col.blue;
+      }
+   }
+
+   // read an image file ( P1, P3, P4 or P6 ), false when that fails
+   static bool read_file(
+      const char * file_name,
+      xy & file_size,
+      std::vector< uint8_t > & rgb
+   );
+
+public:
+
+   /// create a headless window
+   window(
+      xy size,
+      color foreground = black,
+      color background = white
+   ):
+      hwlib::window( size, foreground, background ),
+      pixels( 3 * size.x * size.y )
+   {
+      clear();
+   }
+
+   /// read a pixel
+   color read( xy pos ) const {
+      auto p = at( pos );
+      return color( p[ 0 ], p[ 1 ], p[ 2 ] );
+   }
+
+   /// write the pixels to a file in binary PPM (P6) format
+   ///
+   /// This function returns false when the file can't be written.
+   bool write_ppm( const char * file_name ) const;
+
+   /// write the pixels to a file in binary PBM (P4) format
+   ///
+   /// A pixel is black in the file when its brightness is less than
+   /// half of white.
+   /// This function returns false when the file can't be written.
+   bool write_pbm( const char * file_name ) const;
+
+   /// compare the pixels to an image file
+   ///
+   /// This function returns the number of pixels that differ by more
+   /// than tolerance in one or more color channels
+   /// from the corresponding pixel in the PPM or PBM file,
+   /// or -1 when the file can't be read or has a different size.
+   int_fast32_t compare(
+      const char * file_name,
+      uint8_t tolerance = 0
+   ) const;
+
+   /// check whether the pixels match a golden image file
+   ///
+   /// This function returns whether at most max_differences
+   /// pixels differ by more than tolerance from the file.
+   /// When it doesn't match, the actual pixels are written to
+   /// the file name with ".actual.ppm" appended,
+   /// so they can be inspected,
+   /// or copied over the golden file when the change is intended.
+   bool matches(
+      const char * file_name,
+      uint8_t tolerance = 0,
+      int_fast32_t max_differences = 0
+   ) const;
+
+   /// dump each frame to a file
+   ///
+   /// When a pattern is set, each flush() writes the pixels to a PPM
+   /// file. The file name is the pattern, with the frame number
+   /// inserted printf-style, for instance "frame-%04d.ppm".
+   /// A nullptr stops the dumping.
+   void dump_frames( const char * pattern ){
+      dump_pattern = pattern;
+   }
+
+   /// the number of flush() calls
+   uint_fast32_t frames() const {
+      return frame_count;
+   }
+
+   /// the frames per second between the first and the last flush()
+   ///
+   /// The first flush() starts the measurement,
+   /// hence it is not counted.
+   /// This function returns 0 when there are less than two frames.
+   double fps() const {
+      return ( frame_count < 2 ) || ( last_flush == first_flush )
+         ? 0.0
+         : ( frame_count - 1 ) * 1'000'000.0 / ( last_flush - first_flush );
+   }
+
+   /// restart the frame counting
+   void reset_frames(){
+      frame_count = 0;
+   }
+
+   void flush() override;
+
+}; // class window
+
+/// buffered UART served by a thread
+///
+/// This is a uart_buffered of which the hardware side is a thread,
+/// which stands in for the interrupt service routine of a target.
+/// It is meant for testing the correctness and the throughput
+/// of code that uses a uart_buffered.
+///
+/// The thread writes the transmitted characters (in blocks) to the sink.
+/// When a source is provided, the thread calls it to get 
+/// (up to n) received characters: it must not wait for them.
+/// The thread only asks for as many characters as the receive buffer
+/// can store, like a UART with hardware flow control.
+///
+/// The destructor stops the thread after the transmit buffer
+/// has been written to the sink.
+template< size_t tx_size = 1024, size_t rx_size = 256 >
+class uart_thread : public hwlib::uart_buffered< tx_size, rx_size > {
+private:
+
+   std::function< void( const char *, size_t ) > sink;
+   std::function< size_t( char *, size_t ) > source;
+   std::atomic< bool > stop;
+   std::thread thread;
+   
+   // write the transmit buffer to the sink, return whether it wasn't empty
+   bool transmit(){
+      char block[ 64 ];
+      const size_t n = this->tx_get( block, sizeof( block ) );
+      if( n > 0 ){
+         sink( block, n );
+      }
+      return n > 0;
+   }
+   
+   // get characters from the source, return whether there were any
+   bool receive(){
+      if( ! source ){
+         return false;
+      }
+      char block[ 64 ];
+      const size_t n = source( 
+         block, std::min( sizeof( block ), this->rx_room() ) );
+      for( size_t i = 0; i < n; ++i ){
+         this->rx_put( block[ i ] );
+      }
+      return n > 0;
+   }
+   
+   void run(){
+      while( ! stop.load() ){
+         const bool busy = transmit();
+         if( ! ( receive() || busy ) ){
+            std::this_thread::sleep_for( std::chrono::microseconds( 50 ) );
+         }
+      }
+      while( transmit() ){}
+   }
+   
+   // give the thread a chance, also on a single core
+   void idle() override {
+      hwlib::background::do_background_work();
+      std::this_thread::yield();
+   }
+
+public:
+
+   /// create a buffered UART that transmits to sink, 
+   /// and (optionally) receives from source 
+   uart_thread( 
+      std::function< void( const char *, size_t ) > sink,
+      std::function< size_t( char *, size_t ) > source = nullptr
+   ):
+      sink( sink ),
+      source( source ),
+      stop( false ),
+      thread( [ this ]{ run(); } )
+   {}
+   
+   /// write the transmit buffer to the sink, and stop the thread
+   ~uart_thread(){
+      stop.store( true );
+      thread.join();
+   }
+
+}; // class uart_thread
+
+};	// namespace target
+
+#ifdef _HWLIB_ONCE
+
+bool target::window::write_ppm( const char * file_name ) const {
+   auto f = std::fopen( file_name, "wb" );
+   if( f == nullptr ){
+      return false;
+   }
+   std::fprintf( f, "P6\n%d %d\n255\n", (int) size.x, (int) size.y );
+   const auto ok =
+      std::fwrite( pixels.data(), 1, pixels.size(), f ) == pixels.size();
+   return ( std::fclose( f ) == 0 ) && ok;
+}
+
+bool target::window::write_pbm( const char * file_name ) const {
+   auto f = std::fopen( file_name, "wb" );
+   if( f == nullptr ){
+      return false;
+   }
+   std::fprintf( f, "P4\n%d %d\n", (int) size.x, (int) size.y );
+
+   // in PBM, a set bit is black, and the padding bits are 0
+   std::vector< color > row( size.x );
+   std::vector< uint8_t > bits( pixel_format_bytes( pixel_format::mono, size.x ) );
+   const uint8_t last = ( size.x % 8 == 0 ) ? 0xFF : 0xFF << ( 8 - size.x % 8 );
+   bool ok = true;
+   for( int_fast16_t y = 0; y < size.y; ++y ){
+      for( int_fast16_t x = 0; x < size.x; ++x ){
+         row[ x ] = read( xy( x, y ) );
+      }
+      pixel_convert( pixel_format::mono, row.data(), size.x, bits.data() );
+      for( auto & b : bits ){
+         b = ~ b;
+      }
+      bits.back() &= last;
+      ok = ok && ( std::fwrite( bits.data(), 1, bits.size(), f ) == bits.size() );
+   }
+   return ( std::fclose( f ) == 0 ) && ok;
+}
+
+// read the next number of a PNM header, skipping white space and comments
+static bool pnm_number( std::FILE * f, int & n ){
+   int c = std::fgetc( f );
+   for(;;){
+      if( c == '#' ){
+         while( ( c != '\n' ) && ( c != EOF ) ){
+            c = std::fgetc( f );
+         }
+      } else if( ( c == ' ' ) || ( c == '\t' ) || ( c == '\r' ) || ( c == '\n' ) ){
+         c = std::fgetc( f );
+      } else {
+         break;
+      }
+   }
+   if( ( c < '0' ) || ( c > '9' ) ){
+      return false;
+   }
+   n = 0;
+   while( ( c >= '0' ) && ( c <= '9' ) ){
+      n = 10 * n + ( c - '0' );
+      c = std::fgetc( f );
+   }
+
+   // the single white space character after the header
+   return c != EOF;
+}
+
+bool target::window::read_file(
+   const char * file_name,
+   xy & file_size,
+   std::vector< uint8_t > & rgb
+){
+   auto f = std::fopen( file_name, "rb" );
+   if( f == nullptr ){
+      return false;
+   }
+
+   int x = 0, y = 0, max = 1;
+   const bool p = std::fgetc( f ) == 'P';
+   const int kind = std::fgetc( f );
+   bool ok = p
+      && ( ( kind == '1' ) || ( kind == '3' ) || ( kind == '4' ) || ( kind == '6' ) )
+      && pnm_number( f, x ) && pnm_number( f, y )
+      && ( ( kind == '1' ) || ( kind == '4' ) || pnm_number( f, max ) )
+      && ( max > 0 ) && ( max < 256 );
+
+   file_size = xy( x, y );
+   rgb.assign( 3 * x * y, 0 );
+   for( int row = 0; ok && ( row < y ); ++row ){
+      int byte = 0;
+      for( int i = 0; ok && ( i < x ); ++i ){
+         auto p = & rgb[ 3 * ( i + x * row ) ];
+         if( kind == '6' ){
+            for( int c = 0; c < 3; ++c ){
+               const int v = std::fgetc( f );
+               ok = ok && ( v != EOF );
+               p[ c ] = ( v * 255 ) / max;
+            }
+         } else if( kind == '3' ){
+            for( int c = 0; c < 3; ++c ){
+               int v = 0;
+               ok = ok && pnm_number( f, v );
+               p[ c ] = ( v * 255 ) / max;
+            }
+         } else {
+            int bit = 0;
+            if( kind == '4' ){
+
+               // each row starts with a new byte
+               if( i % 8 == 0 ){
+                  byte = std::fgetc( f );
+                  ok = ok && ( byte != EOF );
+               }
+               bit = ( byte >> ( 7 - i % 8 ) ) & 0x01;
+            } else {
+               int c = std::fgetc( f );
+               while( ( c == ' ' ) || ( c == '\t' ) || ( c == '\r' ) || ( c == '\n' ) ){
+                  c = std::fgetc( f );
+               }
+               ok = ok && ( ( c == '0' ) || ( c == '1' ) );
+               bit = c == '1';
+            }
+
+            // in PBM, a set bit is black
+            p[ 0 ] = p[ 1 ] = p[ 2 ] = bit ? 0 : 255;
+         }
+      }
+   }
+   std::fclose( f );
+   return ok;
+}
+
+int_fast32_t target::window::compare(
+   const char * file_name,
+   uint8_t tolerance
+) const {
+   xy file_size;
+   std::vector< uint8_t > rgb;
+   if( ( ! read_file( file_name, file_size, rgb ) ) || ( file_size != size ) ){
+      return -1;
+   }
+   int_fast32_t result = 0;
+   for( size_t i = 0; i < pixels.size(); i += 3 ){
+      for( size_t c = 0; c < 3; ++c ){
+         const int d = pixels[ i + c ] - rgb[ i + c ];
+         if( ( d > tolerance ) || ( - d > tolerance ) ){
+            ++result;
+            break;
+         }
+      }
+   }
+   return result;
+}
+
+bool target::window::matches(
+   const char * file_name,
+   uint8_t tolerance,
+   int_fast32_t max_differences
+) const {
+   const auto differences = compare( file_name, tolerance );
+   if( ( differences >= 0 ) && ( differences <= max_differences ) ){
+      return true;
+   }
+   std::string actual( file_name );
+   actual += ".actual.ppm";
+   write_ppm( actual.c_str() );
+   return false;
+}
+
+void target::window::flush(){
+   last_flush = now_us();
+   if( frame_count++ == 0 ){
+      first_flush = last_flush;
+   }
+   if( dump_pattern != nullptr ){
+      char file_name[ 256 ];
+      std::snprintf(
+         file_name, sizeof( file_name ), dump_pattern, (int) frame_count - 1 );
+      write_ppm( file_name );
+   }
+}
+
+uint64_t now_ticks(){
+   static const auto start = std::chrono::steady_clock::now();
+   return std::chrono::duration_cast< std::chrono::nanoseconds >(
+      std::chrono::steady_clock::now() - start ).count();
+}
+
+uint64_t ticks_per_us(){
+   return 1'000;
+}
+
+uint64_t now_us(){
+   return now_ticks() / ticks_per_us();
+}
+
+void wait_us_busy( int_fast32_t n ){
+   auto end = now_us() + n;
+   while( now_us() < end ){}
+}
+
+void wait_ns( int_fast32_t n ){
+   wait_us( n / 1'000 );
+}
+
+void wait_us( int_fast32_t n ){
+   wait_us_busy( n );
+}
+
+void wait_ms( int_fast32_t n ){
+   wait_us( n * 1'000 );
+}
+
+void uart_putc( char c ){
+   std::cout << c << std::flush;
+}
+
+void HWLIB_WEAK uart_write( const char * s, size_t n ){
+   std::cout.write( s, n ) << std::flush;
+}
+
+char uart_getc(){
+   return std::getchar();
+}
+
+bool HWLIB_WEAK uart_char_available(){
+   return 1;
+}
+
+#endif // #ifdef HBLIB_ONCE
+
+}; // namespace hwlib
+
+#include HWLIB_INCLUDE( hwlib-native-emulators.hpp )
+
+#endif // HWLIB_NATIVE_H
@@ -18,6 +18,7 @@
 #define HWLIB_NATIVE_H
 
 #define _HWLIB_TARGET_WAIT_US_BUSY
+#define _HWLIB_TARGET_LOG_CATALOG
 #include HWLIB_INCLUDE( ../hwlib-all.hpp )
 #include <iostream>
 #include <SFML/Graphics.hpp>
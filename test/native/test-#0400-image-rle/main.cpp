@@ -0,0 +1,83 @@
+// ==========================================================================
+//
+// hwlib test.
+//
+// (c) Wouter van Ooijen (wouter@voti.nl) 2017
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// test the run-length compressed image
+
+#include "hwlib.hpp"
+#include "../test-helpers.hpp"
+
+constexpr char mono_pixels[] =
+   "................................"
+   "..XXXX.........................."
+   "XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX"
+   ".X.X.X.X.X.X.X.X.X.X.X.X.X.X.X.X"
+   "................................";
+constexpr auto mono_size = hwlib::xy( 32, 5 );
+constexpr auto mono = hwlib::image_rle<
+   1, hwlib::rle_length( 1, mono_size, mono_pixels ) >(
+   mono_size, mono_pixels );
+
+constexpr char indexed_pixels[] =
+   "01234567"
+   "89abcdef"
+   "00000000"
+   "0000fff1";
+constexpr auto indexed_size = hwlib::xy( 8, 4 );
+constexpr auto indexed = hwlib::image_rle<
+   4, hwlib::rle_length( 4, indexed_size, indexed_pixels ) >(
+   indexed_size, indexed_pixels );
+
+void test_mono(){
+
+   // compressed is smaller than 1 bit per pixel
+   HWLIB_TEST_EQUAL( mono.data_length() < 32 * 5 / 8, true );
+
+   window_store< 32, 32 > w;
+   w.write( hwlib::xy( 0, 1 ), mono );
+
+   // the runs are written as spans
+   HWLIB_TEST_EQUAL( w.write_count < 32, true );
+
+   for( auto p : all( mono_size ) ){
+      const bool set = mono_pixels[ p.y * mono_size.x + p.x ] == 'X';
+      HWLIB_TEST_EQUAL( mono[ p ] == hwlib::white, set );
+      HWLIB_TEST_EQUAL( w.pixels[ p.x ][ p.y + 1 ] == hwlib::white, set );
+   }
+}
+
+void test_indexed(){
+   window_store< 32, 32 > w;
+   w.write( hwlib::xy( 2, 0 ), indexed );
+
+   for( auto p : all( indexed_size ) ){
+      const int level =
+         0xFF * hwlib::rle_index( 4, indexed_pixels[ p.y * 8 + p.x ] ) / 15;
+      HWLIB_TEST_EQUAL( indexed[ p ].red, level );
+      HWLIB_TEST_EQUAL( w.pixels[ p.x + 2 ][ p.y ].green, level );
+   }
+}
+
+void test_clipping(){
+   window_store< 32, 32 > w;
+   w.write( hwlib::xy( 20, 30 ), mono );
+
+   HWLIB_TEST_EQUAL( w.pixels[ 31 ][ 31 ] == hwlib::black, true );
+   HWLIB_TEST_EQUAL( w.pixels[ 22 ][ 31 ] == hwlib::white, true );
+}
+
+int main(){
+   test_mono();
+   test_indexed();
+   test_clipping();
+   hwlib::test_end();
+}
+
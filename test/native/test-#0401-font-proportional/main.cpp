@@ -0,0 +1,91 @@
+// ==========================================================================
+//
+// hwlib test.
+//
+// (c) Wouter van Ooijen (wouter@voti.nl) 2017
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// test the proportional font
+
+#include "hwlib.hpp"
+#include "../test-helpers.hpp"
+
+const hwlib::font_proportional_8x8 font;
+const hwlib::font_default_8x8 font_8x8;
+
+// each character is the 8x8 character without its blank columns
+void test_characters(){
+   for( int c = ' '; c <= '~'; ++c ){
+      window_store< 32, 16 > w;
+      const auto advance = font.write(
+         w, hwlib::xy( 1, 2 ), char( c ), hwlib::white, hwlib::black );
+      HWLIB_TEST_EQUAL( advance, font.width( c ) );
+
+      const int left = hwlib::font_8x8_left( c );
+      for( int y = 0; y < 8; ++y ){
+         for( int x = 0; x < advance; ++x ){
+            const bool ink =
+               ( x < advance - 1 ) && ( x + left < 8 )
+               && ( font_8x8[ c ][ hwlib::xy( x + left, y ) ] == hwlib::black );
+            HWLIB_TEST_EQUAL(
+               w.pixels[ x + 1 ][ y + 2 ] == hwlib::white, ink );
+         }
+      }
+
+      // nothing outside the character cell, and only spans
+      HWLIB_TEST_EQUAL( w.pixels[ advance + 1 ][ 2 ] == hwlib::blue, true );
+      HWLIB_TEST_EQUAL( w.pixels[ 1 ][ 10 ] == hwlib::blue, true );
+      HWLIB_TEST_EQUAL( w.write_count, 0 );
+   }
+}
+
+void test_measurement(){
+   HWLIB_TEST_EQUAL( font.height(), 8 );
+   HWLIB_TEST_EQUAL( font.width( 'i' ) < font.width( 'W' ), true );
+   HWLIB_TEST_EQUAL( font.width( '\x80' ), 0 );
+   HWLIB_TEST_EQUAL(
+      font.text_width( "Hi!" ),
+      font.width( 'H' ) + font.width( 'i' ) + font.width( '!' ) );
+
+   window_store< 32, 16 > w;
+   hwlib::text t( hwlib::xy( 3, 4 ), font, "abc", hwlib::white );
+   t.draw( w );
+   HWLIB_TEST_EQUAL(
+      t.bounding_box() == hwlib::box(
+         hwlib::xy( 3, 4 ), hwlib::xy( 3 + font.text_width( "abc" ), 12 ) ),
+      true );
+}
+
+// a font with a sparse code point table
+void test_sparse(){
+   static const hwlib::glyph glyphs[] = {
+      { 0, 2, 2, 0, 0, 3 },
+      { 1, 1, 1, 1, 1, 3 }
+   };
+   static const uint8_t bitmaps[] = { 0x90, 0x80 };
+   static const uint16_t code_points[] = { 'a', 0xB0 };
+   const hwlib::font_proportional sparse(
+      glyphs, 2, bitmaps, 3, 0, code_points );
+
+   HWLIB_TEST_EQUAL( sparse.width( 'a' ), 3 );
+   HWLIB_TEST_EQUAL( sparse.width( 'b' ), 0 );
+   HWLIB_TEST_EQUAL( sparse.find( 0xB0 ) == & glyphs[ 1 ], true );
+
+   window_store< 32, 16 > w;
+   HWLIB_TEST_EQUAL( sparse.write( w, hwlib::xy( 0, 0 ), "ab" ), 3 );
+   HWLIB_TEST_EQUAL( w.pixels[ 0 ][ 0 ] == hwlib::white, true );
+   HWLIB_TEST_EQUAL( w.pixels[ 1 ][ 0 ] == hwlib::blue, true );
+   HWLIB_TEST_EQUAL( w.pixels[ 1 ][ 1 ] == hwlib::white, true );
+}
+
+int main(){
+   test_characters();
+   test_measurement();
+   test_sparse();
+   hwlib::test_end();
+}
@@ -0,0 +1,96 @@
+// ==========================================================================
+//
+// hwlib test.
+//
+// (c) Wouter van Ooijen (wouter@voti.nl) 2017
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// test the fused image transformations
+
+#include "hwlib.hpp"
+#include "../test-helpers.hpp"
+
+// image that doesn't store its pixels as packed bits
+class image_gradient : public hwlib::image {
+private:
+
+   hwlib::color read_implementation( hwlib::xy pos ) const override {
+      return hwlib::color( pos.x * 30, pos.y * 30, 0 );
+   }
+
+public:
+
+   image_gradient(): image( hwlib::xy( 7, 5 ) ){}
+};
+
+const hwlib::image_8x8 triangle(
+   0x01, 0x03, 0x07, 0x0F, 0x1F, 0x3F, 0x7F, 0xFF );
+const image_gradient gradient;
+
+// the transformed image, read and written, must match f
+template< typename F >
+void check( const hwlib::image & t, F f ){
+   window_store< 32, 32 > w;
+   w.write( hwlib::xy( 1, 2 ), t );
+   HWLIB_TEST_EQUAL( w.write_count, 0 );
+   for( auto p : all( t.size ) ){
+      const hwlib::color expected = f( p );
+      HWLIB_TEST_EQUAL( t[ p ] == expected, true );
+      HWLIB_TEST_EQUAL(
+         w.pixels[ p.x + 1 ][ p.y + 2 ]
+            == ( expected.is_transparent() ? hwlib::blue : expected ),
+         true );
+   }
+}
+
+void test_sources( const hwlib::image & source ){
+   const auto s = source.size;
+
+   check( hwlib::transform( source ), [ & ]( hwlib::xy p ){
+      return source[ p ];
+   } );
+
+   check( hwlib::transpose( hwlib::mirror_x( hwlib::part(
+      source, hwlib::xy( 1, 2 ), hwlib::xy( 4, 3 ) ) ) ),
+      [ & ]( hwlib::xy p ){
+         return source[ hwlib::xy( 1 + 3 - p.y, 2 + p.x ) ];
+      } );
+
+   check( hwlib::transform( source ).mirror_y().scale( 3 ).invert(),
+      [ & ]( hwlib::xy p ){
+         return - source[ hwlib::xy( p.x / 3, s.y - 1 - p.y / 3 ) ];
+      } );
+
+   check( hwlib::scale( hwlib::transpose( source ), 2 ).part(
+      hwlib::xy( 3, 1 ), hwlib::xy( 5, 6 ) ),
+      [ & ]( hwlib::xy p ){
+         return source[ hwlib::xy( ( p.y + 1 ) / 2, ( p.x + 3 ) / 2 ) ];
+      } );
+}
+
+// a part that extends beyond its image shows transparent pixels,
+// also when a later part brings the source pixels back
+void test_clipping(){
+   const auto t = hwlib::transform( gradient )
+      .part( hwlib::xy( 2, 0 ), hwlib::xy( 3, 3 ) )
+      .scale( 2 )
+      .part( hwlib::xy( -1, 1 ), hwlib::xy( 8, 2 ) );
+   check( t, [ & ]( hwlib::xy p ){
+      const auto x = p.x - 1;
+      return ( ( x < 0 ) || ( x >= 6 ) )
+         ? hwlib::transparent
+         : gradient[ hwlib::xy( 2 + x / 2, ( p.y + 1 ) / 2 ) ];
+   } );
+}
+
+int main(){
+   test_sources( triangle );
+   test_sources( gradient );
+   test_clipping();
+   hwlib::test_end();
+}
@@ -0,0 +1,170 @@
+// ==========================================================================
+//
+// hwlib test.
+//
+// (c) Wouter van Ooijen (wouter@voti.nl) 2017
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// test the pixel format conversions, and report their speed
+
+#include "hwlib.hpp"
+#include <cstdio>
+
+const hwlib::pixel_format formats[] = {
+   hwlib::pixel_format::rgb565,
+   hwlib::pixel_format::rgb666,
+   hwlib::pixel_format::rgb332,
+   hwlib::pixel_format::mono
+};
+
+const hwlib::pixel_kernel kernels[] = {
+   hwlib::pixel_kernel::scalar,
+   hwlib::pixel_kernel::ssse3,
+   hwlib::pixel_kernel::avx2,
+   hwlib::pixel_kernel::neon
+};
+
+const char * kernel_names[] = { "scalar", "ssse3", "avx2", "neon" };
+const char * format_names[] = { "rgb565", "rgb666", "rgb332", "mono" };
+
+constexpr int max_n = 256;
+
+hwlib::color colors[ max_n ];
+
+void random_colors(){
+   for( auto & c : colors ){
+      c = hwlib::color(
+         hwlib::random_in( 0, 255 ),
+         hwlib::random_in( 0, 255 ),
+         hwlib::random_in( 0, 255 ) );
+   }
+}
+
+// known results of a single pixel
+void test_values(){
+   const hwlib::color c( 0x12, 0x34, 0x56 );
+   uint8_t out[ 3 ];
+
+   hwlib::pixel_convert( hwlib::pixel_format::rgb565, &c, 1, out );
+   HWLIB_TEST_EQUAL( out[ 0 ], 0x11 );
+   HWLIB_TEST_EQUAL( out[ 1 ], 0xAA );
+
+   hwlib::pixel_convert( hwlib::pixel_format::rgb666, &c, 1, out );
+   HWLIB_TEST_EQUAL( out[ 0 ], 0x10 );
+   HWLIB_TEST_EQUAL( out[ 1 ], 0x34 );
+   HWLIB_TEST_EQUAL( out[ 2 ], 0x54 );
+
+   hwlib::pixel_convert( hwlib::pixel_format::rgb332, &c, 1, out );
+   HWLIB_TEST_EQUAL( out[ 0 ], 0x05 );
+
+   const hwlib::color mono[] = {
+      hwlib::white, hwlib::black, hwlib::gray, hwlib::white,
+      hwlib::black, hwlib::black, hwlib::black, hwlib::black,
+      hwlib::white, hwlib::green
+   };
+   hwlib::pixel_convert( hwlib::pixel_format::mono, mono, 10, out );
+   HWLIB_TEST_EQUAL( out[ 0 ], 0xB0 );
+   HWLIB_TEST_EQUAL( out[ 1 ], 0xC0 );
+
+   HWLIB_TEST_EQUAL(
+      hwlib::pixel_format_bytes( hwlib::pixel_format::mono, 10 ), 2u );
+}
+
+// each kernel gives the scalar result for each length,
+// and writes nothing beyond it
+void test_kernels(){
+   random_colors();
+   for( int ki = 0; ki < 4; ++ki ){
+      if( ! hwlib::pixel_kernel_available( kernels[ ki ] ) ){
+         printf( "%s kernels not compiled in, not tested\n", 
+            kernel_names[ ki ] );
+      }
+   }
+   for( auto f : formats ){
+      for( auto k : kernels ){
+         if( ! hwlib::pixel_kernel_available( k ) ){
+            continue;
+         }
+         for( int n = 0; n < max_n; n += ( n < 40 ) ? 1 : 37 ){
+            uint8_t expected[ 3 * max_n + 1 ];
+            uint8_t out[ 3 * max_n + 1 ];
+            for( auto & b : out ){
+               b = 0x5A;
+            }
+            hwlib::pixel_convert(
+               f, colors, n, expected, hwlib::pixel_kernel::scalar );
+            hwlib::pixel_convert( f, colors, n, out, k );
+            const auto bytes = hwlib::pixel_format_bytes( f, n );
+            for( size_t i = 0; i < bytes; ++i ){
+               HWLIB_TEST_EQUAL( out[ i ], expected[ i ] );
+            }
+            HWLIB_TEST_EQUAL( out[ bytes ], 0x5A );
+         }
+      }
+   }
+}
+
+// converting back gives the most significant bits of each channel
+void test_unconvert(){
+   random_colors();
+   uint8_t bytes[ 3 * max_n ];
+   hwlib::color back[ max_n ];
+
+   hwlib::pixel_convert( hwlib::pixel_format::rgb565, colors, max_n, bytes );
+   hwlib::pixel_unconvert( hwlib::pixel_format::rgb565, bytes, max_n, back );
+   for( int i = 0; i < max_n; ++i ){
+      HWLIB_TEST_EQUAL( back[ i ].red   & 0xF8, colors[ i ].red   & 0xF8 );
+      HWLIB_TEST_EQUAL( back[ i ].green & 0xFC, colors[ i ].green & 0xFC );
+      HWLIB_TEST_EQUAL( back[ i ].blue  & 0xF8, colors[ i ].blue  & 0xF8 );
+   }
+
+   hwlib::pixel_convert( hwlib::pixel_format::rgb332, colors, max_n, bytes );
+   hwlib::pixel_unconvert( hwlib::pixel_format::rgb332, bytes, max_n, back );
+   for( int i = 0; i < max_n; ++i ){
+      HWLIB_TEST_EQUAL( back[ i ].red   & 0xE0, colors[ i ].red   & 0xE0 );
+      HWLIB_TEST_EQUAL( back[ i ].green & 0xE0, colors[ i ].green & 0xE0 );
+      HWLIB_TEST_EQUAL( back[ i ].blue  & 0xC0, colors[ i ].blue  & 0xC0 );
+   }
+
+   const hwlib::color white = hwlib::white;
+   hwlib::pixel_convert( hwlib::pixel_format::rgb565, &white, 1, bytes );
+   hwlib::pixel_unconvert( hwlib::pixel_format::rgb565, bytes, 1, back );
+   HWLIB_TEST_EQUAL( back[ 0 ] == hwlib::white, true );
+}
+
+// megapixels per second of each available kernel for each format,
+// converting 240 pixel rows (one row of a 240 x 240 display)
+void benchmark(){
+   constexpr int n = 240;
+   constexpr int rows = 20'000;
+   uint8_t out[ 3 * n ];
+   random_colors();
+   for( int fi = 0; fi < 4; ++fi ){
+      for( int ki = 0; ki < 4; ++ki ){
+         if( ! hwlib::pixel_kernel_available( kernels[ ki ] ) ){
+            continue;
+         }
+         const auto start = hwlib::now_us();
+         for( int i = 0; i < rows; ++i ){
+            hwlib::pixel_convert( formats[ fi ], colors, n, out, kernels[ ki ] );
+         }
+         const auto us = hwlib::now_us() - start;
+         printf( "%-6s %-6s : %8.1f MP/s\n",
+            format_names[ fi ], kernel_names[ ki ],
+            us == 0 ? 0.0 : ( double( n ) * rows ) / us );
+      }
+   }
+}
+
+int main(){
+   test_values();
+   test_kernels();
+   test_unconvert();
+   benchmark();
+   hwlib::test_end();
+}
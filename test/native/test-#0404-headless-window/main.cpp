@@ -0,0 +1,87 @@
+// ==========================================================================
+//
+// hwlib test.
+//
+// (c) Wouter van Ooijen (wouter@voti.nl) 2017
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// test the headless native window (build with HEADLESS=1)
+
+#include "hwlib.hpp"
+
+// the picture in golden.pbm
+void draw( hwlib::window & w ){
+   w.clear();
+   hwlib::rectangle( hwlib::xy( 0, 0 ), hwlib::xy( 31, 15 ) ).draw( w );
+   hwlib::circle( hwlib::xy( 7, 7 ), 5 ).draw( w );
+   hwlib::line( hwlib::xy( 14, 3 ), hwlib::xy( 29, 12 ) ).draw( w );
+}
+
+void test_golden(){
+   hwlib::target::window w( hwlib::xy( 32, 16 ) );
+   draw( w );
+   HWLIB_TEST_EQUAL( w.read( hwlib::xy( 0, 0 ) ) == hwlib::black, true );
+   HWLIB_TEST_EQUAL( w.read( hwlib::xy( 1, 1 ) ) == hwlib::white, true );
+   HWLIB_TEST_EQUAL( w.compare( "golden.pbm" ), 0 );
+   HWLIB_TEST_EQUAL( w.matches( "golden.pbm" ), true );
+
+   // a small change is within the tolerance
+   w.write( hwlib::xy( 1, 1 ), hwlib::color( 0xF0, 0xF0, 0xF0 ) );
+   HWLIB_TEST_EQUAL( w.compare( "golden.pbm" ), 1 );
+   HWLIB_TEST_EQUAL( w.compare( "golden.pbm", 0x10 ), 0 );
+   HWLIB_TEST_EQUAL( w.matches( "golden.pbm", 0, 1 ), true );
+
+   // a missing file or a different size doesn't match
+   HWLIB_TEST_EQUAL( w.compare( "missing.pbm" ), -1 );
+   hwlib::target::window small( hwlib::xy( 16, 16 ) );
+   HWLIB_TEST_EQUAL( small.compare( "golden.pbm" ), -1 );
+}
+
+// what is written can be read back
+void test_files(){
+   hwlib::target::window w( hwlib::xy( 13, 5 ) );
+   for( auto p : hwlib::all( w.size ) ){
+      w.write( p, hwlib::color( 20 * p.x, 50 * p.y, 3 * ( p.x + p.y ) ) );
+   }
+   HWLIB_TEST_EQUAL( w.write_ppm( "test.ppm" ), true );
+   HWLIB_TEST_EQUAL( w.compare( "test.ppm" ), 0 );
+
+   draw( w );
+   HWLIB_TEST_EQUAL( w.write_pbm( "test.pbm" ), true );
+   HWLIB_TEST_EQUAL( w.compare( "test.pbm" ), 0 );
+
+   std::remove( "test.ppm" );
+   std::remove( "test.pbm" );
+}
+
+void test_frames(){
+   hwlib::target::window w( hwlib::xy( 240, 240 ) );
+   HWLIB_TEST_EQUAL( w.frames(), 0u );
+   HWLIB_TEST_EQUAL( w.fps() == 0.0, true );
+
+   w.dump_frames( "frame-%d.ppm" );
+   w.flush();
+   w.dump_frames( nullptr );
+   HWLIB_TEST_EQUAL( w.compare( "frame-0.ppm" ), 0 );
+   std::remove( "frame-0.ppm" );
+
+   const auto start = hwlib::now_us();
+   while( hwlib::now_us() - start < 100'000 ){
+      w.clear( hwlib::color( w.frames() ) );
+      w.flush();
+   }
+   HWLIB_TEST_EQUAL( w.fps() > 0.0, true );
+   hwlib::cout << "frames per second : " << int( w.fps() ) << "\n";
+}
+
+int main(){
+   test_golden();
+   test_files();
+   test_frames();
+   hwlib::test_end();
+}
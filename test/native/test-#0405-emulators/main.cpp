@@ -0,0 +1,230 @@
+// ==========================================================================
+//
+// hwlib test.
+//
+// (c) Wouter van Ooijen (wouter@voti.nl) 2017
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// test the display controller emulators (build with HEADLESS=1)
+// by running the unchanged drivers on them
+
+#include "hwlib.hpp"
+
+// the picture that is drawn on each graphics display
+void draw( hwlib::window & w ){
+   w.clear();
+   hwlib::line( hwlib::xy( 0, 3 ), hwlib::xy( 40, 3 ) ).draw( w );
+   w.write( hwlib::xy( 20, 30 ) );
+   w.flush();
+}
+
+// check that the emulated display shows the picture,
+// a pixel is on when it is closer to the on color than to the off color
+template< typename E >
+void check_picture( const E & e, hwlib::color on, hwlib::color off ){
+   auto is_on = [ & ]( hwlib::xy pos ){
+      const auto c = e.read( pos );
+      return abs( c.red - on.red ) < abs( c.red - off.red );
+   };
+   HWLIB_TEST_EQUAL( is_on( hwlib::xy(  0,  3 ) ), true );
+   HWLIB_TEST_EQUAL( is_on( hwlib::xy( 39,  3 ) ), true );
+   HWLIB_TEST_EQUAL( is_on( hwlib::xy( 40,  3 ) ), false );
+   HWLIB_TEST_EQUAL( is_on( hwlib::xy(  0,  4 ) ), false );
+   HWLIB_TEST_EQUAL( is_on( hwlib::xy( 20, 30 ) ), true );
+   HWLIB_TEST_EQUAL( is_on( hwlib::xy( 21, 30 ) ), false );
+}
+
+void test_ssd1306(){
+   hwlib::ssd1306_emulator i2c;
+   hwlib::glcd_oled_i2c_128x64_buffered oled_i2c( i2c.i2c );
+   draw( oled_i2c );
+   check_picture( i2c, hwlib::white, hwlib::black );
+
+   hwlib::ssd1306_emulator spi;
+   hwlib::glcd_oled_spi_128x64_direct_res_dc_cs oled_spi(
+      spi.spi, spi.res, spi.dc, spi.cs );
+   draw( oled_spi );
+   check_picture( spi, hwlib::white, hwlib::black );
+
+   // the direct window writes the changed byte only,
+   // the cursor is already at the next column
+   spi.reset_counters();
+   oled_spi.write( hwlib::xy( 21, 30 ) );
+   oled_spi.flush();
+   HWLIB_TEST_EQUAL( spi.bytes, 1u );
+   HWLIB_TEST_EQUAL( spi.read( hwlib::xy( 21, 30 ) ) == hwlib::white, true );
+
+   // a scroll step moves the pixels one column to the right
+   spi.command( 0x26 );
+   for( auto d : { 0x00, 0x00, 0x00, 0x07, 0x00, 0xFF } ){
+      spi.command( d );
+   }
+   spi.command( 0x2F );
+   spi.scroll_step();
+   HWLIB_TEST_EQUAL( spi.read( hwlib::xy( 22, 30 ) ) == hwlib::white, true );
+   HWLIB_TEST_EQUAL( spi.read( hwlib::xy( 20, 30 ) ) == hwlib::black, true );
+}
+
+void test_st7789(){
+   hwlib::st7789_emulator e;
+   hwlib::st7789_spi_dc_cs_rst lcd( e.spi, e.dc, e.cs, e.rst );
+   draw( lcd );
+   check_picture( e, hwlib::white, hwlib::black );
+
+   // an unchanged frame costs nothing
+   e.reset_counters();
+   lcd.flush();
+   HWLIB_TEST_EQUAL( e.bytes, 0u );
+
+   // one changed pixel costs a CASET, a RASET and a RAMWR (11 bytes)
+   // and its own 2 RGB565 bytes, in 3 transactions
+   lcd.write( hwlib::xy( 21, 30 ) );
+   lcd.flush();
+   HWLIB_TEST_EQUAL( e.bytes, 11u + 2u );
+   HWLIB_TEST_EQUAL( e.transactions, 3u );
+   HWLIB_TEST_EQUAL( e.read( hwlib::xy( 21, 30 ) ).red > 0x80, true );
+   HWLIB_TEST_EQUAL( e.read( hwlib::xy( 22, 30 ) ).red < 0x80, true );
+}
+
+void test_st7789_strips(){
+   hwlib::st7789_emulator e;
+   hwlib::st7789_spi_dc_cs_rst_strips<> lcd( e.spi, e.dc, e.cs, e.rst );
+   lcd.render( draw );
+   check_picture( e, hwlib::white, hwlib::black );
+
+   // each of the 15 strips costs a CASET, a RASET and a RAMWR
+   // (11 bytes) and its 16 rows of 240 RGB565 pixels
+   e.reset_counters();
+   lcd.render( draw );
+   HWLIB_TEST_EQUAL( e.bytes, 15u * ( 11u + 16u * 240u * 2u ) );
+
+   // a lambda can capture what it draws; it is called once per strip
+   auto pos = hwlib::xy( 21, 30 );
+   unsigned int calls = 0;
+   lcd.render( [ & ]( hwlib::window & w ){
+      w.write( pos );
+      ++calls;
+   } );
+   HWLIB_TEST_EQUAL( calls, 15u );
+   HWLIB_TEST_EQUAL( e.read( pos ).red > 0x80, true );
+   HWLIB_TEST_EQUAL( e.read( hwlib::xy( 22, 30 ) ) == hwlib::black, true );
+   lcd.render( draw );
+
+   // outside render(), writes have no effect
+   lcd.write( hwlib::xy( 21, 30 ) );
+   lcd.flush();
+   HWLIB_TEST_EQUAL( e.read( hwlib::xy( 21, 30 ) ) == hwlib::black, true );
+
+   // a strip height that doesn't divide 240 gives a partial last strip
+   hwlib::st7789_emulator p;
+   hwlib::st7789_spi_dc_cs_rst_strips< 100 > partial( p.spi, p.dc, p.cs, p.rst );
+   p.reset_counters();
+   partial.render( draw );
+   check_picture( p, hwlib::white, hwlib::black );
+   HWLIB_TEST_EQUAL( p.bytes, 3u * 11u + 240u * 240u * 2u );
+}
+
+void test_pcd8544(){
+   hwlib::pcd8544_emulator e;
+   hwlib::glcd_5510_spi_sce_res_dc lcd( e.spi, e.sce, e.res, e.dc );
+   draw( lcd );
+   check_picture( e, hwlib::black, hwlib::white );
+
+   // the bit-banged driver gives the same picture
+   hwlib::pcd8544_emulator b;
+   hwlib::glcd_5510 old( b.sce, b.res, b.dc, b.sdin, b.sclk );
+   draw( old );
+   check_picture( b, hwlib::black, hwlib::white );
+   HWLIB_TEST_EQUAL( b.bytes, e.bytes );
+}
+
+void test_hd44780(){
+   hwlib::hd44780_emulator e( hwlib::xy( 16, 2 ) );
+   hwlib::hd44780 lcd( e.rs, e.e, e.data, hwlib::xy( 16, 2 ) );
+   lcd << "Hello\nworld" << hwlib::flush;
+   HWLIB_TEST_EQUAL( e.line( 0 ) == "Hello           ", true );
+   HWLIB_TEST_EQUAL( e.line( 1 ) == "world           ", true );
+
+   lcd << "\f" << "xy" << hwlib::flush;
+   HWLIB_TEST_EQUAL( e.line( 0 ) == "xy              ", true );
+   HWLIB_TEST_EQUAL( e.line( 1 ) == "                ", true );
+
+   hwlib::target::window w( hwlib::xy( 8 * 16, 8 * 2 ) );
+   e.render( w );
+   HWLIB_TEST_EQUAL( w.read( hwlib::xy( 0, 2 ) ) == hwlib::black, true );
+   HWLIB_TEST_EQUAL( w.read( hwlib::xy( 20, 1 ) ) == hwlib::white, true );
+}
+
+void test_hd44780_pcf8574(){
+   hwlib::hd44780_emulator e( hwlib::xy( 20, 4 ) );
+   hwlib::hd44780_pcf8574 lcd( e.i2c, 0x27, hwlib::xy( 20, 4 ) );
+   lcd << "\fHello\nworld" << hwlib::flush;
+   HWLIB_TEST_EQUAL( e.line( 0 ) == "Hello               ", true );
+   HWLIB_TEST_EQUAL( e.line( 1 ) == "world               ", true );
+
+   // only the changed character is written: one I2C transaction with
+   // the address, the cursor move and the character (4 bytes each)
+   e.backpack.reset_counters();
+   lcd << "\vHello\nworlD" << hwlib::flush;
+   HWLIB_TEST_EQUAL( e.line( 1 ) == "worlD               ", true );
+   HWLIB_TEST_EQUAL( e.backpack.transactions, 1u );
+   HWLIB_TEST_EQUAL( e.backpack.bytes, 9u );
+}
+
+void test_hd44780_busy(){
+
+   // 4-bit mode, polling the busy flag
+   hwlib::hd44780_emulator e( hwlib::xy( 16, 2 ) );
+   hwlib::hd44780 lcd( e.rs, e.rw, e.e, e.data, hwlib::xy( 16, 2 ) );
+   lcd << "\fHello\nworld" << hwlib::flush;
+   HWLIB_TEST_EQUAL( e.line( 0 ) == "Hello           ", true );
+   HWLIB_TEST_EQUAL( e.line( 1 ) == "world           ", true );
+
+   // 8-bit mode, polling the busy flag
+   hwlib::hd44780_emulator e8( hwlib::xy( 16, 2 ) );
+   hwlib::hd44780 lcd8( e8.rs, e8.rw, e8.e, e8.data8, hwlib::xy( 16, 2 ) );
+   lcd8 << "\fHello\nworld" << hwlib::flush;
+   HWLIB_TEST_EQUAL( e8.line( 0 ) == "Hello           ", true );
+   HWLIB_TEST_EQUAL( e8.line( 1 ) == "world           ", true );
+
+   // 8-bit mode, fixed waits: one enable pulse per byte
+   hwlib::hd44780_emulator f8( hwlib::xy( 16, 2 ) );
+   hwlib::hd44780 lcdf8( f8.rs, f8.e, f8.data8, hwlib::xy( 16, 2 ) );
+   f8.reset_counters();
+   lcdf8 << "\vab" << hwlib::flush;
+   HWLIB_TEST_EQUAL( f8.line( 0 ) == "ab              ", true );
+   HWLIB_TEST_EQUAL( f8.transactions, f8.bytes );
+}
+
+void test_terminal_buffered(){
+   hwlib::hd44780_emulator e( hwlib::xy( 16, 2 ) );
+   hwlib::hd44780 lcd( e.rs, e.e, e.data, hwlib::xy( 16, 2 ) );
+   hwlib::terminal_buffered<> buffered( lcd );
+   buffered << "\fTime 12:34\nTemp 21" << hwlib::flush;
+   HWLIB_TEST_EQUAL( e.line( 0 ) == "Time 12:34      ", true );
+   HWLIB_TEST_EQUAL( e.line( 1 ) == "Temp 21         ", true );
+
+   // a rewrite sends only the changed digits: 
+   // one cursor move and two characters, and the final cursor move
+   e.reset_counters();
+   buffered << "\fTime 12:45\nTemp 21" << hwlib::flush;
+   HWLIB_TEST_EQUAL( e.line( 0 ) == "Time 12:45      ", true );
+   HWLIB_TEST_EQUAL( e.bytes, 4u );
+}
+
+int main( void ){
+   test_ssd1306();
+   test_st7789();
+   test_st7789_strips();
+   test_pcd8544();
+   test_hd44780();
+   test_hd44780_pcf8574();
+   test_hd44780_busy();
+   test_terminal_buffered();
+   hwlib::test_end();
+}
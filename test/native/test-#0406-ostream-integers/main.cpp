@@ -0,0 +1,166 @@
+// ==========================================================================
+//
+// hwlib test.
+//
+// (c) Wouter van Ooijen (wouter@voti.nl) 2017
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// test the integer formatting of hwlib::ostream,
+// and compare its speed with the previous (division per digit) code
+
+#include "hwlib.hpp"
+#include "../test-helpers.hpp"
+#include <climits>
+
+template< typename T >
+std::string format( T x, const hwlib::_setbase & base = hwlib::dec ){
+   string_ostream out;
+   out << base << x;
+   return out.s;
+}
+
+// the previous implementation, for long long values
+const char * legacy( long long int x, int base, char ( & body )[ 70 ] ){
+   char * p = body + 69;
+   *p = '\0';
+   bool minus = ( x < 0 );
+   if( x < 0 ){ x = -x; }
+   if( x == 0 ){
+      *--p = '0';
+   }
+   while( x != 0 ){
+      const char d = x % base;
+      *--p = ( d > 9 ) ? 'A' + d - 10 : '0' + d;
+      x = x / base;
+   }
+   if( minus ){
+      *--p = '-';
+   }
+   return p;
+}
+
+void test_values(){
+   HWLIB_TEST_EQUAL( format( 0 ) == "0", true );
+   HWLIB_TEST_EQUAL( format( 7 ) == "7", true );
+   HWLIB_TEST_EQUAL( format( 42 ) == "42", true );
+   HWLIB_TEST_EQUAL( format( -123 ) == "-123", true );
+   HWLIB_TEST_EQUAL( format( INT_MIN ) == "-2147483648", true );
+   HWLIB_TEST_EQUAL( format( LLONG_MIN ) == "-9223372036854775808", true );
+   HWLIB_TEST_EQUAL( format( LLONG_MAX ) == "9223372036854775807", true );
+   HWLIB_TEST_EQUAL(
+      format( ULLONG_MAX ) == "18446744073709551615", true );
+   HWLIB_TEST_EQUAL( format( 10'000'000'000'000'000'000ull )
+      == "10000000000000000000", true );
+   HWLIB_TEST_EQUAL( format( 100'000'000ull ) == "100000000", true );
+   HWLIB_TEST_EQUAL( format( 4'000'000'000u ) == "4000000000", true );
+   HWLIB_TEST_EQUAL( format( 3'000'000'000l ) == "3000000000", true );
+   HWLIB_TEST_EQUAL(
+      format( ULLONG_MAX, hwlib::hex ) == "FFFFFFFFFFFFFFFF", true );
+   HWLIB_TEST_EQUAL( format( 0xBEEF, hwlib::hex ) == "BEEF", true );
+   HWLIB_TEST_EQUAL( format( -0xBEEF, hwlib::hex ) == "-BEEF", true );
+   HWLIB_TEST_EQUAL( format( 8, hwlib::oct ) == "10", true );
+   HWLIB_TEST_EQUAL( format( 5, hwlib::bin ) == "101", true );
+   HWLIB_TEST_EQUAL( format( 0, hwlib::bin ) == "0", true );
+   HWLIB_TEST_EQUAL( format( ULLONG_MAX, hwlib::bin )
+      == std::string( 64, '1' ), true );
+   HWLIB_TEST_EQUAL( format( 35, hwlib::_setbase( 36 ) ) == "Z", true );
+   HWLIB_TEST_EQUAL( format( 'A' ) == "A", true );
+   HWLIB_TEST_EQUAL( format( (unsigned char) 200 ) == "200", true );
+   HWLIB_TEST_EQUAL( format( (short) -300 ) == "-300", true );
+}
+
+void test_fields(){
+   string_ostream out;
+   out << hwlib::setw( 6 ) << 42 << '|'
+       << hwlib::left << hwlib::setw( 6 ) << -42 << '|'
+       << hwlib::right << hwlib::setfill( '0' ) << hwlib::setw( 4 ) << 7
+       << '|' << hwlib::setfill( ' ' ) << hwlib::setw( 2 ) << 12345 << '|'
+       << 9;
+   HWLIB_TEST_EQUAL( out.s == "    42|-42   |0007|12345|9", true );
+
+   out.s = "";
+   out << hwlib::showbase << hwlib::hex << 255 << ' '
+       << hwlib::bin << 2 << ' ' << hwlib::oct << -8 << ' '
+       << hwlib::dec << 10 << ' '
+       << hwlib::showpos << hwlib::hex << 1 << ' ' << hwlib::setw( 6 ) << 1;
+   HWLIB_TEST_EQUAL( out.s == "0xFF 0b10 -0o10 10 +0x1   +0x1", true );
+
+   out.s = "";
+   out << hwlib::setw( 5 ) << "ab" << hwlib::left << hwlib::setw( 3 )
+       << "c" << "d";
+   HWLIB_TEST_EQUAL( out.s == "   abc  d", true );
+}
+
+// compare with the previous code for pseudo-random values
+void test_legacy(){
+   int errors = 0;
+   char body[ 70 ];
+   const int bases[] = { 2, 8, 10, 16, 7 };
+   uint64_t r = 12345;
+   for( int i = 0; i < 20'000; ++i ){
+      r = r * 6364136223846793005ull + 1442695040888963407ull;
+      const auto x = static_cast< long long int >( r ) >> ( i % 60 );
+      if( x == LLONG_MIN ){
+         continue;
+      }
+      for( auto base : bases ){
+         if(
+            format( x, hwlib::_setbase( base ) ) != legacy( x, base, body )
+         ){
+            ++errors;
+         }
+      }
+   }
+   HWLIB_TEST_EQUAL( errors, 0 );
+}
+
+// nanoseconds per formatted value, for small and large values
+void benchmark(){
+   constexpr int n = 1'000'000;
+   const int bases[] = { 10, 16 };
+   for( auto base : bases ){
+      for( int shift : { 48, 0 } ){
+         null_ostream out;
+         out << hwlib::_setbase( base );
+         auto start = hwlib::now_us();
+         for( int i = 0; i < n; ++i ){
+            out << ( ( 0x0123'4567'89AB'CDEFll + i ) >> shift );
+         }
+         const auto now = hwlib::now_us() - start;
+
+         unsigned int sum = 0;
+         char body[ 70 ];
+         start = hwlib::now_us();
+         for( int i = 0; i < n; ++i ){
+            for( 
+               auto p = legacy( 
+                  ( 0x0123'4567'89AB'CDEFll + i ) >> shift, base, body );
+               *p != '\0'; 
+               ++p 
+            ){
+               sum += *p;
+            }
+         }
+         const auto before = hwlib::now_us() - start;
+
+         printf( "base %2d, %2d digits : %6.1f ns now, %6.1f ns before\n",
+            base, (int) format( 0x0123'4567'89AB'CDEFll >> shift,
+               hwlib::_setbase( base ) ).length(),
+            1000.0 * now / n, 1000.0 * before / n );
+         HWLIB_TEST_EQUAL( out.n, sum );
+      }
+   }
+}
+
+int main(){
+   test_values();
+   test_fields();
+   test_legacy();
+   benchmark();
+   hwlib::test_end();
+}
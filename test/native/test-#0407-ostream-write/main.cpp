@@ -0,0 +1,128 @@
+// ==========================================================================
+//
+// hwlib test.
+//
+// (c) Wouter van Ooijen (wouter@voti.nl) 2017
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// test the block write() of ostream, and ostream_buffered
+
+#include "hwlib.hpp"
+
+// an ostream that collects its output, and counts the calls
+class counting_ostream : public hwlib::ostream {
+public:
+   std::string s;
+   unsigned int putcs = 0, writes = 0, flushes = 0;
+
+   void putc( char c ) override {
+      s += c;
+      ++putcs;
+   }
+
+   void write( const char * p, size_t n ) override {
+      s.append( p, n );
+      ++writes;
+   }
+
+   void flush() override {
+      ++flushes;
+   }
+
+   void reset(){
+      s = "";
+      putcs = writes = flushes = 0;
+   }
+};
+
+void test_write(){
+   counting_ostream out;
+   out << "Hello";
+   HWLIB_TEST_EQUAL( out.s == "Hello", true );
+   HWLIB_TEST_EQUAL( out.writes, 1u );
+   HWLIB_TEST_EQUAL( out.putcs, 0u );
+
+   // the fill is written in blocks of (up to) 8 characters
+   out.reset();
+   out << hwlib::setw( 20 ) << "ab" << hwlib::setfill( '.' )
+       << hwlib::left << hwlib::setw( 4 ) << -1;
+   HWLIB_TEST_EQUAL( out.s == "                  ab-1..", true );
+   HWLIB_TEST_EQUAL( out.writes, 6u );
+   HWLIB_TEST_EQUAL( out.putcs, 0u );
+
+   // a string_base is written as a single block
+   out.reset();
+   hwlib::string< 16 > s( "some text" );
+   out << s;
+   HWLIB_TEST_EQUAL( out.s == "some text", true );
+   HWLIB_TEST_EQUAL( out.writes, 1u );
+}
+
+void test_buffered(){
+   counting_ostream out;
+   {
+      hwlib::ostream_buffered< 16 > b( out );
+
+      // written on the newline
+      b << "value " << 42;
+      HWLIB_TEST_EQUAL( out.writes, 0u );
+      HWLIB_TEST_EQUAL( b.buffered(), 8u );
+      b << '\n';
+      HWLIB_TEST_EQUAL( out.s == "value 42\n", true );
+      HWLIB_TEST_EQUAL( out.writes, 1u );
+      HWLIB_TEST_EQUAL( out.putcs, 0u );
+
+      // written when the buffer is full
+      out.reset();
+      b << "0123456789" << "abcdefghij";
+      HWLIB_TEST_EQUAL( out.s == "0123456789", true );
+      HWLIB_TEST_EQUAL( b.buffered(), 10u );
+
+      // written, and the decorated ostream flushed, on a flush
+      b << hwlib::flush;
+      HWLIB_TEST_EQUAL( out.s == "0123456789abcdefghij", true );
+      HWLIB_TEST_EQUAL( out.writes, 2u );
+      HWLIB_TEST_EQUAL( out.flushes, 1u );
+
+      // a large block is written directly, after the buffered characters
+      out.reset();
+      b << "x" << "a block that is larger than the buffer";
+      HWLIB_TEST_EQUAL(
+         out.s == "xa block that is larger than the buffer", true );
+      HWLIB_TEST_EQUAL( out.writes, 2u );
+
+      // written when it is destroyed
+      out.reset();
+      b << "end";
+   }
+   HWLIB_TEST_EQUAL( out.s == "end", true );
+
+   // without flush on newline
+   out.reset();
+   hwlib::ostream_buffered< 16 > b( out, false );
+   b << "a\nb\n";
+   HWLIB_TEST_EQUAL( out.writes, 0u );
+   b.flush();
+   HWLIB_TEST_EQUAL( out.s == "a\nb\n", true );
+}
+
+void test_terminal(){
+   hwlib::hd44780_emulator e( hwlib::xy( 16, 2 ) );
+   hwlib::hd44780 lcd( e.rs, e.e, e.data, hwlib::xy( 16, 2 ) );
+   hwlib::ostream_buffered<> b( lcd );
+   b << "\fHello\nworld " << 12 << hwlib::flush;
+   HWLIB_TEST_EQUAL( e.line( 0 ) == "Hello           ", true );
+   HWLIB_TEST_EQUAL( e.line( 1 ) == "world 12        ", true );
+}
+
+int main(){
+   test_write();
+   test_buffered();
+   test_terminal();
+   hwlib::test_end();
+}
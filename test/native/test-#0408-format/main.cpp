@@ -0,0 +1,139 @@
+// ==========================================================================
+//
+// hwlib test.
+//
+// (c) Wouter van Ooijen (wouter@voti.nl) 2017
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// test hwlib::format(), and compare its speed with a manipulator chain
+
+#include "hwlib.hpp"
+#include "../test-helpers.hpp"
+#include <climits>
+
+template< typename S, typename... Ts >
+std::string as_string( S f, const Ts & ... xs ){
+   string_ostream out;
+   out << hwlib::format( f, xs... );
+   return out.s;
+}
+
+void test_integers(){
+   HWLIB_TEST_EQUAL( as_string( HWLIB_FORMAT( "{}" ), 42 ) == "42", true );
+   HWLIB_TEST_EQUAL( as_string( HWLIB_FORMAT( "{:04x} {:>8}" ),
+      0xAB, -12 ) == "00ab      -12", true );
+   HWLIB_TEST_EQUAL( as_string( HWLIB_FORMAT( "{:X}|{:o}|{:b}" ),
+      255, 8, 5 ) == "FF|10|101", true );
+   HWLIB_TEST_EQUAL( as_string( HWLIB_FORMAT( "{:#x}|{:#b}|{:+d}" ),
+      255, 2, 7 ) == "0xff|0b10|+7", true );
+   HWLIB_TEST_EQUAL( as_string( HWLIB_FORMAT( "{:#X}" ), 255 )
+      == "0XFF", true );
+   HWLIB_TEST_EQUAL( as_string( HWLIB_FORMAT( "{:06}|{:+06}|{:#06x}" ),
+      -42, 42, 255 ) == "-00042|+00042|0x00ff", true );
+   HWLIB_TEST_EQUAL( as_string( HWLIB_FORMAT( "{:<6}|{:^6}|{:*>6}" ),
+      1, 2, 3 ) == "1     |  2   |*****3", true );
+   HWLIB_TEST_EQUAL( as_string( HWLIB_FORMAT( "{:2}" ), 12345 )
+      == "12345", true );
+   HWLIB_TEST_EQUAL( as_string( HWLIB_FORMAT( "{} {}" ),
+      LLONG_MIN, ULLONG_MAX )
+         == "-9223372036854775808 18446744073709551615", true );
+   HWLIB_TEST_EQUAL( as_string( HWLIB_FORMAT( "{} {}" ),
+      (short) -1, (unsigned char) 200 ) == "-1 200", true );
+}
+
+void test_other_items(){
+   HWLIB_TEST_EQUAL( as_string( HWLIB_FORMAT( "[{:5}][{:>5}][{:^5}]" ),
+      "ab", "cd", "ef" ) == "[ab   ][   cd][ ef  ]", true );
+   const char * p = "text";
+   HWLIB_TEST_EQUAL(
+      as_string( HWLIB_FORMAT( "{:s}" ), p ) == "text", true );
+   HWLIB_TEST_EQUAL( as_string( HWLIB_FORMAT( "{}{:3}{:d}{:x}" ),
+      'a', 'b', 'c', 'd' ) == "ab  9964", true );
+   HWLIB_TEST_EQUAL( as_string( HWLIB_FORMAT( "{} {:>6} {:d}" ),
+      true, false, true ) == "true  false 1", true );
+   hwlib::string< 16 > s( "str" );
+   HWLIB_TEST_EQUAL( as_string( HWLIB_FORMAT( "<{:>5}>" ), s )
+      == "<  str>", true );
+   HWLIB_TEST_EQUAL( as_string( HWLIB_FORMAT( "{}" ), hwlib::xy( 1, 2 ) )
+      == "[1:2]", true );
+}
+
+void test_literals(){
+   HWLIB_TEST_EQUAL( as_string( HWLIB_FORMAT( "" ) ) == "", true );
+   HWLIB_TEST_EQUAL(
+      as_string( HWLIB_FORMAT( "plain" ) ) == "plain", true );
+   HWLIB_TEST_EQUAL(
+      as_string( HWLIB_FORMAT( "{{{}}}" ), 1 ) == "{1}", true );
+   HWLIB_TEST_EQUAL(
+      as_string( HWLIB_FORMAT( "a}}b{{" ) ) == "a}b{", true );
+}
+
+// numbers and string literals are stored by value,
+// so a stored format() can be used later
+auto stored( int x ){
+   return hwlib::format( HWLIB_FORMAT( "{}" ), x + 1 );
+}
+
+void test_stored(){
+   int a = 1;
+   auto f = hwlib::format( HWLIB_FORMAT( "{} {:>4}" ), a + 1, "lit" );
+   a = 5;
+   string_ostream out;
+   out << f << ' ' << stored( a );
+   HWLIB_TEST_EQUAL( out.s == "2  lit 6", true );
+}
+
+void test_targets(){
+
+   // the ostream state is neither used nor changed
+   string_ostream out;
+   out << hwlib::hex << hwlib::setw( 5 )
+       << hwlib::format( HWLIB_FORMAT( "{}" ), 10 ) << 10;
+   HWLIB_TEST_EQUAL( out.s == "10    A", true );
+
+   // appending to a string
+   hwlib::string< 20 > s( "x=" );
+   s << hwlib::format( HWLIB_FORMAT( "{:03}, y={}" ), 7, -1 );
+   HWLIB_TEST_EQUAL( s == "x=007, y=-1", true );
+}
+
+// nanoseconds per line, for format() and the equivalent manipulators
+void benchmark(){
+   constexpr int n = 1'000'000;
+
+   null_ostream a;
+   auto start = hwlib::now_us();
+   for( int i = 0; i < n; ++i ){
+      a << hwlib::format(
+         HWLIB_FORMAT( "{:04X} {:>8}\n" ), i & 0xFFFF, i );
+   }
+   const auto format_us = hwlib::now_us() - start;
+
+   null_ostream b;
+   start = hwlib::now_us();
+   for( int i = 0; i < n; ++i ){
+      b << hwlib::setfill( '0' ) << hwlib::hex << hwlib::setw( 4 )
+        << ( i & 0xFFFF ) << hwlib::setfill( ' ' ) << hwlib::dec << ' '
+        << hwlib::setw( 8 ) << i << '\n';
+   }
+   const auto manipulators_us = hwlib::now_us() - start;
+
+   printf( "format : %6.1f ns, manipulators : %6.1f ns\n",
+      1000.0 * format_us / n, 1000.0 * manipulators_us / n );
+   HWLIB_TEST_EQUAL( a.n, b.n );
+}
+
+int main(){
+   test_integers();
+   test_other_items();
+   test_literals();
+   test_stored();
+   test_targets();
+   benchmark();
+   hwlib::test_end();
+}
@@ -0,0 +1,185 @@
+// ==========================================================================
+//
+// hwlib test.
+//
+// (c) Wouter van Ooijen (wouter@voti.nl) 2017
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// test the fixed-point and floating-point output of hwlib::ostream,
+// and compare it (values and speed) with snprintf
+
+#include "hwlib.hpp"
+#include "../test-helpers.hpp"
+
+template< typename T >
+std::string as_string( const T & x, int precision = 6 ){
+   string_ostream out;
+   out << hwlib::setprecision( precision ) << x;
+   return out.s;
+}
+
+void test_fixed_point(){
+   HWLIB_TEST_EQUAL(
+      as_string( hwlib::fixed_point< 8 >( 0x0380 ) ) == "3.500000", true );
+   HWLIB_TEST_EQUAL(
+      as_string( hwlib::fixed_point< 8 >( -0x0380 ), 1 ) == "-3.5", true );
+   HWLIB_TEST_EQUAL(
+      as_string( hwlib::fixed_point< 16 >( 1 ), 9 ) == "0.000015259", true );
+   HWLIB_TEST_EQUAL(
+      as_string( hwlib::fixed_point< 4 >( 0x1F ), 0 ) == "2", true );
+   HWLIB_TEST_EQUAL(
+      as_string( hwlib::fixed_point< 4 >( 0x1F ), 2 ) == "1.94", true );
+   HWLIB_TEST_EQUAL(
+      as_string( hwlib::fixed_point< 4 >( 0x28 ), 0 ) == "2", true );
+   HWLIB_TEST_EQUAL(
+      as_string( hwlib::fixed_point< 4 >( 0x38 ), 0 ) == "4", true );
+   HWLIB_TEST_EQUAL( as_string( hwlib::fixed_point< 15, int16_t >( 
+      INT16_MIN ), 3 ) == "-1.000", true );
+   HWLIB_TEST_EQUAL( as_string( hwlib::fixed_point< 32, int64_t >( 
+      int64_t( 5 ) << 31 ), 2 ) == "2.50", true );
+
+   // more than 9 decimals are exact, and zeros after the last bit
+   HWLIB_TEST_EQUAL(
+      as_string( hwlib::fixed_point< 16 >( 1 ), 12 ) == "0.000015258789", 
+      true );
+   HWLIB_TEST_EQUAL( as_string( hwlib::fixed_point< 32, int64_t >( 
+      1 ), 34 ) == "0.0000000002328306436538696289062500", true );
+   HWLIB_TEST_EQUAL( as_string( hwlib::fixed_point< 32, int64_t >( 
+      -0xFFFF'FFFFLL ), 9 ) == "-1.000000000", true );
+   HWLIB_TEST_EQUAL(
+      as_string( hwlib::fixed_point< 4 >( 0x18 ), 12 ) == "1.500000000000", 
+      true );
+
+   HWLIB_TEST_EQUAL( as_string( hwlib::fixed_decimal( 2315, 2 ) )
+      == "23.15", true );
+   HWLIB_TEST_EQUAL( as_string( hwlib::fixed_decimal( -5, 3 ) )
+      == "-0.005", true );
+   HWLIB_TEST_EQUAL( as_string( hwlib::fixed_decimal( 7, 0 ) )
+      == "7", true );
+   HWLIB_TEST_EQUAL( as_string( hwlib::fixed_decimal( 123u, 12 ) )
+      == "0.000000000123", true );
+   HWLIB_TEST_EQUAL( as_string( hwlib::fixed_decimal( INT64_MIN, 19 ) )
+      == "-0.9223372036854775808", true );
+}
+
+void test_floating(){
+   HWLIB_TEST_EQUAL( as_string( 3.25 ) == "3.250000", true );
+   HWLIB_TEST_EQUAL( as_string( -0.125, 2 ) == "-0.12", true );
+   HWLIB_TEST_EQUAL( as_string( 0.0 ) == "0.000000", true );
+   HWLIB_TEST_EQUAL( as_string( 9.9996, 3 ) == "10.000", true );
+   HWLIB_TEST_EQUAL( as_string( 2.5, 0 ) == "2", true );
+   HWLIB_TEST_EQUAL( as_string( 1e18, 1 ) == "1000000000000000000.0", true );
+   HWLIB_TEST_EQUAL( as_string( 1.5e300, 3 ) == "1.500e+300", true );
+   HWLIB_TEST_EQUAL( as_string( 9.9999e22, 2 ) == "1.00e+23", true );
+   HWLIB_TEST_EQUAL( as_string( 1.0 / 0.0 ) == "inf", true );
+   HWLIB_TEST_EQUAL( as_string( -1.0 / 0.0 ) == "-inf", true );
+   HWLIB_TEST_EQUAL( as_string( 0.0 / 0.0 ) == "nan", true );
+
+   HWLIB_TEST_EQUAL( as_string( 3.25f, 2 ) == "3.25", true );
+   HWLIB_TEST_EQUAL( as_string( -1234.5f, 1 ) == "-1234.5", true );
+   HWLIB_TEST_EQUAL( as_string( 1e10f, 2 ) == "1.00e+10", true );
+   HWLIB_TEST_EQUAL( as_string( 3.4e38f, 1 ) == "3.4e+38", true );
+
+   // the decimals are exact, so these are rounded like printf does
+   HWLIB_TEST_EQUAL( as_string( 0.15, 1 ) == "0.1", true );
+   HWLIB_TEST_EQUAL( as_string( 0.35, 1 ) == "0.3", true );
+   HWLIB_TEST_EQUAL( as_string( 0.1, 17 ) == "0.10000000000000001", true );
+   HWLIB_TEST_EQUAL( as_string( 76.8969345f, 6 ) == "76.896935", true );
+   HWLIB_TEST_EQUAL( as_string( -0.0, 2 ) == "-0.00", true );
+   HWLIB_TEST_EQUAL( as_string( -0.0f, 0 ) == "-0", true );
+   HWLIB_TEST_EQUAL( as_string( 5e-324, 17 ) == "0.00000000000000000", true );
+
+   string_ostream out;
+   out << hwlib::setw( 8 ) << hwlib::setprecision( 2 ) << 3.14159
+       << '|' << hwlib::left << hwlib::setw( 6 ) << 2.5f << '|'
+       << hwlib::showpos << 1.0 << '|' << hwlib::noshowpos
+       << hwlib::setfill( '0' ) << hwlib::right << hwlib::setw( 6 ) << -1.5;
+   HWLIB_TEST_EQUAL( out.s == "    3.14|2.50  |+1.00|0-1.50", true );
+}
+
+void test_format(){
+   string_ostream out;
+   out << hwlib::format( HWLIB_FORMAT( "{:.2f} {:08.3} {:.1} {}" ),
+      3.14159, -2.5f, hwlib::fixed_point< 8 >( 0x0180 ),
+      hwlib::fixed_decimal( 1005, 1 ) );
+   HWLIB_TEST_EQUAL( out.s == "3.14 -002.500 1.5 100.5", true );
+}
+
+// pseudo-random doubles and floats, at all precisions, 
+// compared with snprintf
+template< typename T >
+int snprintf_differences( int max_precision ){
+   const T scale[] = { 1e-6f, 1e-3f, 1, 10, 1e3f, 1e5f, 1e8f, 1e9f };
+   const T double_scale[] = { 1e-9, 1, 10, 1e3, 1e5, 1e8, 1e12, 1e18 };
+   uint64_t r = 12345;
+   int differences = 0;
+   constexpr int n = 100'000;
+   for( int i = 0; i < n; ++i ){
+      r = r * 6364136223846793005ull + 1442695040888963407ull;
+      const T x = static_cast< T >( 
+         ( r >> 11 ) * ( 1.0 / ( 1ull << 53 ) ) 
+         * ( ( sizeof( T ) > 4 ) ? double_scale[ i % 8 ] : scale[ i % 8 ] ) );
+      const int precision = ( i / 8 ) % ( max_precision + 1 );
+      char expected[ 64 ];
+      snprintf( expected, sizeof( expected ), "%.*f", 
+         precision, static_cast< double >( x ) );
+      if( as_string( x, precision ) != expected ){
+         ++differences;
+      }
+   }
+   return differences;
+}
+
+void test_snprintf(){
+   HWLIB_TEST_EQUAL( snprintf_differences< double >( 17 ), 0 );
+   HWLIB_TEST_EQUAL( snprintf_differences< float >( 9 ), 0 );
+}
+
+// nanoseconds per value, for hwlib and snprintf
+void benchmark(){
+   constexpr int n = 1'000'000;
+
+   null_ostream a;
+   a << hwlib::setprecision( 3 );
+   auto start = hwlib::now_us();
+   for( int i = 0; i < n; ++i ){
+      a << ( i * 0.001 );
+   }
+   const auto hwlib_us = hwlib::now_us() - start;
+
+   null_ostream b;
+   char s[ 64 ];
+   start = hwlib::now_us();
+   for( int i = 0; i < n; ++i ){
+      b.write( s, snprintf( s, sizeof( s ), "%.3f", i * 0.001 ) );
+   }
+   const auto snprintf_us = hwlib::now_us() - start;
+
+   null_ostream c;
+   c << hwlib::setprecision( 3 );
+   start = hwlib::now_us();
+   for( int i = 0; i < n; ++i ){
+      c << hwlib::fixed_decimal( i, 3 );
+   }
+   const auto fixed_us = hwlib::now_us() - start;
+
+   printf( "double : %6.1f ns, snprintf : %6.1f ns, fixed_decimal %6.1f ns\n",
+      1000.0 * hwlib_us / n, 1000.0 * snprintf_us / n,
+      1000.0 * fixed_us / n );
+   HWLIB_TEST_EQUAL( a.n, b.n );
+   HWLIB_TEST_EQUAL( a.n, c.n );
+}
+
+int main(){
+   test_fixed_point();
+   test_floating();
+   test_format();
+   test_snprintf();
+   benchmark();
+   hwlib::test_end();
+}
@@ -0,0 +1,192 @@
+// ==========================================================================
+//
+// hwlib test.
+//
+// (c) Wouter van Ooijen (wouter@voti.nl) 2017
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// test the integer and line reading of hwlib::istream
+
+#include "hwlib.hpp"
+#include <climits>
+
+// an istream that reads from a C string, and counts the getc() calls;
+// at most 'chunk' characters are available between refill() calls
+class string_istream : public hwlib::istream {
+public:
+   const char * p;
+   int reads = 0;
+   int chunk;
+   int left;
+   string_istream( const char * p, int chunk = 1'000 ):
+      p( p ), chunk( chunk ), left( chunk ){}
+   bool char_available() override { return ( *p != '\0' ) && ( left > 0 ); }
+   char getc() override {
+      ++reads;
+      --left;
+      return ( *p == '\0' ) ? '\0' : *p++;
+   }
+   void refill(){ left = chunk; }
+};
+
+void test_integers(){
+   string_istream in( "  42 -17\t+5\n0 007x" );
+   int a = 0, b = 0, c = 0, d = 0, e = 0;
+   in >> a >> b >> c >> d >> e;
+   HWLIB_TEST_EQUAL( a, 42 );
+   HWLIB_TEST_EQUAL( b, -17 );
+   HWLIB_TEST_EQUAL( c, 5 );
+   HWLIB_TEST_EQUAL( d, 0 );
+   HWLIB_TEST_EQUAL( e, 7 );
+   HWLIB_TEST_EQUAL( in.fail(), false );
+
+   // the character that ends a number is kept
+   char x = 0;
+   in >> x;
+   HWLIB_TEST_EQUAL( x, 'x' );
+
+   // each character is read only once
+   HWLIB_TEST_EQUAL( in.reads, 18 );
+}
+
+void test_limits(){
+   string_istream in(
+      "-2147483648 2147483647 4294967295 "
+      "-9223372036854775808 18446744073709551615 -32768 65535" );
+   int a; unsigned int b; long long c; unsigned long long d;
+   short e; unsigned short f;
+   in >> a >> a >> b >> c >> d >> e >> f;
+   HWLIB_TEST_EQUAL( a, INT_MAX );
+   HWLIB_TEST_EQUAL( b, UINT_MAX );
+   HWLIB_TEST_EQUAL( c, LLONG_MIN );
+   HWLIB_TEST_EQUAL( d, ULLONG_MAX );
+   HWLIB_TEST_EQUAL( e, SHRT_MIN );
+   HWLIB_TEST_EQUAL( f, USHRT_MAX );
+   HWLIB_TEST_EQUAL( in.fail(), false );
+}
+
+void test_errors(){
+
+   // overflow saturates
+   string_istream in( "2147483648 -129000 x 12" );
+   int a;
+   in >> a;
+   HWLIB_TEST_EQUAL( a, INT_MAX );
+   HWLIB_TEST_EQUAL( in.fail(), true );
+   in.clear();
+
+   short s;
+   in >> s;
+   HWLIB_TEST_EQUAL( s, SHRT_MIN );
+   HWLIB_TEST_EQUAL( in.fail(), true );
+   in.clear();
+
+   // no digits: 0, and the character is kept
+   in >> a;
+   HWLIB_TEST_EQUAL( a, 0 );
+   HWLIB_TEST_EQUAL( in.fail(), true );
+   in.clear();
+   char c;
+   in >> c >> a;
+   HWLIB_TEST_EQUAL( c, 'x' );
+   HWLIB_TEST_EQUAL( a, 12 );
+   HWLIB_TEST_EQUAL( in.fail(), false );
+
+   // a sign is not accepted for an unsigned
+   string_istream in2( "-5" );
+   unsigned int u;
+   in2 >> u;
+   HWLIB_TEST_EQUAL( u, 0u );
+   HWLIB_TEST_EQUAL( in2.fail(), true );
+}
+
+void test_bases(){
+   string_istream in( "ff 0x1F 0XaB 101 0b11 17 0o17 z -0x10 0" );
+   int a, b, c, d, e, f, g, h, i, j;
+   in >> hwlib::hex >> a >> b >> c
+      >> hwlib::bin >> d >> e
+      >> hwlib::oct >> f >> g
+      >> hwlib::_setbase( 36 ) >> h
+      >> hwlib::hex >> i
+      >> j;
+   HWLIB_TEST_EQUAL( a, 0xFF );
+   HWLIB_TEST_EQUAL( b, 0x1F );
+   HWLIB_TEST_EQUAL( c, 0xAB );
+   HWLIB_TEST_EQUAL( d, 5 );
+   HWLIB_TEST_EQUAL( e, 3 );
+   HWLIB_TEST_EQUAL( f, 15 );
+   HWLIB_TEST_EQUAL( g, 15 );
+   HWLIB_TEST_EQUAL( h, 35 );
+   HWLIB_TEST_EQUAL( i, -16 );
+   HWLIB_TEST_EQUAL( j, 0 );
+   HWLIB_TEST_EQUAL( in.fail(), false );
+   HWLIB_TEST_EQUAL( in.base(), 16u );
+
+   // a prefix that doesn't match the radix ends the number
+   string_istream in2( "0x10" );
+   in2 >> hwlib::dec >> a;
+   HWLIB_TEST_EQUAL( a, 0 );
+   HWLIB_TEST_EQUAL( in2.peek(), 'x' );
+}
+
+void test_getline(){
+   string_istream in( "first line\nsecond, which is too long\n\nlast\n" );
+   hwlib::string< 12 > s;
+   hwlib::getline( in, s );
+   HWLIB_TEST_EQUAL( s == "first line", true );
+   HWLIB_TEST_EQUAL( in.fail(), false );
+   hwlib::getline( in, s );
+   HWLIB_TEST_EQUAL( s == "second, whic", true );
+   HWLIB_TEST_EQUAL( in.fail(), true );
+   in.clear();
+   hwlib::getline( in, s );
+   HWLIB_TEST_EQUAL( s == "", true );
+   hwlib::getline( in, s );
+   HWLIB_TEST_EQUAL( s == "last", true );
+
+   // after a number
+   string_istream in2( "12 rest;" );
+   int a;
+   in2 >> a;
+   hwlib::getline( in2, s, ';' );
+   HWLIB_TEST_EQUAL( a, 12 );
+   HWLIB_TEST_EQUAL( s == " rest", true );
+}
+
+void test_line_reader(){
+
+   // three characters become available per refill()
+   string_istream in( "set 12\nabcdefghij\nx\n", 3 );
+   hwlib::line_reader< 8 > reader( in );
+   int lines = 0;
+   int polls = 0;
+   hwlib::string< 40 > all;
+   while( lines < 3 ){
+      ++polls;
+      if( reader.poll() ){
+         ++lines;
+         all << reader.line() << ( reader.overflow() ? "!" : "" ) << "|";
+      } else {
+         in.refill();
+      }
+   }
+   HWLIB_TEST_EQUAL( all == "set 12|abcdefgh!|x|", true );
+   HWLIB_TEST_EQUAL( polls, 9 );
+   HWLIB_TEST_EQUAL( reader.poll(), false );
+   HWLIB_TEST_EQUAL( reader.line() == "", true );
+}
+
+int main(){
+   test_integers();
+   test_limits();
+   test_errors();
+   test_bases();
+   test_getline();
+   test_line_reader();
+   hwlib::test_end();
+}
@@ -0,0 +1,149 @@
+// ==========================================================================
+//
+// hwlib test.
+//
+// (c) Wouter van Ooijen (wouter@voti.nl) 2017
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// test hwlib::ring_buffer and hwlib::uart_buffered, the latter served 
+// by a thread (target::uart_thread), and measure its throughput
+
+#include "hwlib.hpp"
+
+void test_ring_buffer(){
+   hwlib::ring_buffer< int, 3 > b;
+   int x = 0;
+   HWLIB_TEST_EQUAL( b.empty(), true );
+   HWLIB_TEST_EQUAL( b.pop( x ), false );
+   HWLIB_TEST_EQUAL( b.push( 1 ), true );
+   HWLIB_TEST_EQUAL( b.push( 2 ), true );
+   HWLIB_TEST_EQUAL( b.push( 3 ), true );
+   HWLIB_TEST_EQUAL( b.full(), true );
+   HWLIB_TEST_EQUAL( b.push( 4 ), false );
+   HWLIB_TEST_EQUAL( b.size(), 3u );
+   HWLIB_TEST_EQUAL( b.pop( x ), true );
+   HWLIB_TEST_EQUAL( x, 1 );
+
+   // wrap around
+   const int in[] = { 5, 6, 7 };
+   HWLIB_TEST_EQUAL( b.write( in, 3 ), 1u );
+   int out[ 5 ] = {};
+   HWLIB_TEST_EQUAL( b.read( out, 5 ), 3u );
+   HWLIB_TEST_EQUAL( out[ 0 ] * 100 + out[ 1 ] * 10 + out[ 2 ], 235 );
+   HWLIB_TEST_EQUAL( b.empty(), true );
+   HWLIB_TEST_EQUAL( b.size(), 0u );
+}
+
+// a producer and a consumer thread pass a sequence through a ring buffer
+void test_ring_buffer_threads(){
+   constexpr uint32_t n = 2'000'000;
+   hwlib::ring_buffer< uint32_t, 100 > b;
+   uint32_t errors = 0;
+   std::thread consumer( [ & ]{
+      uint32_t expected = 0;
+      uint32_t block[ 16 ];
+      while( expected < n ){
+         const auto k = b.read( block, 16 );
+         if( k == 0 ){
+            std::this_thread::yield();
+         }
+         for( size_t i = 0; i < k; ++i ){
+            errors += ( block[ i ] != expected++ );
+         }
+      }
+   } );
+   for( uint32_t i = 0; i < n; ){
+      if( b.push( i ) ){
+         ++i;
+      } else {
+         std::this_thread::yield();
+      }
+   }
+   consumer.join();
+   HWLIB_TEST_EQUAL( errors, 0u );
+}
+
+void test_transmit(){
+   std::string received;
+   {
+      hwlib::target::uart_thread< 128 > uart(
+         [ & ]( const char * p, size_t n ){ received.append( p, n ); } );
+      for( int i = 0; i < 20'000; ++i ){
+         uart << i << '\n';
+      }
+      uart.write( "end", 3 );
+      uart.flush();
+      HWLIB_TEST_EQUAL( uart.tx_pending(), 0u );
+   }
+   std::string expected;
+   for( int i = 0; i < 20'000; ++i ){
+      expected += std::to_string( i ) + '\n';
+   }
+   HWLIB_TEST_EQUAL( received == expected + "end", true );
+}
+
+void test_receive(){
+   const std::string text = "12 -5 ff\nsecond line\n";
+   size_t position = 0;
+   hwlib::target::uart_thread< 64, 8 > uart(
+      []( const char *, size_t ){},
+      [ & ]( char * p, size_t n ){
+         size_t i = 0;
+         while( ( i < n ) && ( position < text.length() ) ){
+            p[ i++ ] = text[ position++ ];
+         }
+         return i;
+      } );
+   int a, b, c;
+   uart >> a >> b >> hwlib::hex >> c;
+   HWLIB_TEST_EQUAL( a * 10'000 + b * 1'000 + c, 115'255 );
+   uart.get();
+   hwlib::string< 20 > s;
+   hwlib::getline( uart, s );
+   HWLIB_TEST_EQUAL( s == "second line", true );
+   HWLIB_TEST_EQUAL( uart.rx_overruns(), 0u );
+}
+
+// time to write a 100-character line, directly to a sink that
+// takes 1 us per character (a stand-in for a fast UART, which 
+// doesn't use the CPU while it sends), and through a uart_buffered
+// that has room for the line
+void benchmark(){
+   auto slow_sink = []( const char *, size_t n ){
+      std::this_thread::sleep_for( std::chrono::microseconds( n ) );
+   };
+   const std::string line = std::string( 99, 'x' ) + '\n';
+   constexpr int n = 1'000;
+
+   auto start = hwlib::now_us();
+   for( int i = 0; i < n; ++i ){
+      slow_sink( line.c_str(), line.length() );
+   }
+   const auto direct = hwlib::now_us() - start;
+
+   hwlib::target::uart_thread< 128 > uart( slow_sink );
+   uint64_t buffered = 0;
+   for( int i = 0; i < n; ++i ){
+      uart.flush();
+      start = hwlib::now_us();
+      uart.write( line.c_str(), line.length() );
+      buffered += hwlib::now_us() - start;
+   }
+   uart.flush();
+   printf( "100 characters : %8.1f ns direct, %8.1f ns buffered\n",
+      1000.0 * direct / n, 1000.0 * buffered / n );
+}
+
+int main(){
+   test_ring_buffer();
+   test_ring_buffer_threads();
+   test_transmit();
+   test_receive();
+   benchmark();
+   hwlib::test_end();
+}
@@ -0,0 +1,143 @@
+// ==========================================================================
+//
+// hwlib test.
+//
+// (c) Wouter van Ooijen (wouter@voti.nl) 2017
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// test the COBS-framed hwlib::ostream_mux, stream_demux and istream_demux
+
+#include "hwlib.hpp"
+#include <algorithm>
+
+// a link: an ostream that collects its output in a std::string,
+// and an istream that reads it back
+class string_link : public hwlib::ostream, public hwlib::istream {
+public:
+   std::string s;
+   size_t position = 0;
+   int writes = 0;
+   void putc( char c ) override { s += c; }
+   void write( const char * p, size_t n ) override {
+      ++writes;
+      s.append( p, n );
+   }
+   void flush() override {}
+   bool char_available() override { return position < s.length(); }
+   char getc() override { return s[ position++ ]; }
+};
+
+std::string encoded( const std::string & data ){
+   char out[ hwlib::cobs_max_length( 600 ) ];
+   return std::string( 
+      out, hwlib::cobs_encode( data.data(), data.length(), out ) );
+}
+
+void test_cobs(){
+   using namespace std::string_literals;
+   HWLIB_TEST_EQUAL( encoded( ""s ) == "\x01\x00"s, true );
+   HWLIB_TEST_EQUAL( encoded( "\x00"s ) == "\x01\x01\x00"s, true );
+   HWLIB_TEST_EQUAL( encoded( "\x00\x00"s ) == "\x01\x01\x01\x00"s, true );
+   HWLIB_TEST_EQUAL( 
+      encoded( "\x11\x22\x00\x33"s ) == "\x03\x11\x22\x02\x33\x00"s, true );
+   HWLIB_TEST_EQUAL( 
+      encoded( "\x11\x00\x00\x00"s ) == "\x02\x11\x01\x01\x01\x00"s, true );
+   const std::string run( 254, 'x' );
+   HWLIB_TEST_EQUAL( 
+      encoded( run ) == "\xFF"s + run + "\x01\x00"s, true );
+   HWLIB_TEST_EQUAL( 
+      encoded( run + "y" ) == "\xFF"s + run + "\x02y\x00"s, true );
+   HWLIB_TEST_EQUAL( encoded( std::string( 600, 'a' ) ).length(), 
+      hwlib::cobs_max_length( 600 ) );
+}
+
+void test_channels(){
+   string_link link;
+   {
+      hwlib::ostream_mux< 16 > log( link, 1 );
+      hwlib::ostream_mux< 16 > telemetry( link, 2, false );
+      log << "hello\n";
+      telemetry << 12 << ' ' << -3 << ' ';
+      log << "abc";
+      HWLIB_TEST_EQUAL( link.writes, 1 );
+      telemetry << 0x7F << ' ';
+      telemetry.flush();
+      HWLIB_TEST_EQUAL( link.writes, 2 );
+
+      // longer than the buffer: several frames
+      log << "0123456789abcdefghijklmnopqrstuvwxyz\n";
+   }
+   
+   hwlib::stream_demux< 16 > demux( link );
+   hwlib::istream_demux< 64 > log( demux, 1 );
+   hwlib::istream_demux< 64 > telemetry( demux, 2 );
+   int a, b, c;
+   telemetry >> a >> b >> c;
+   HWLIB_TEST_EQUAL( a * 10'000 + b * 1'000 + c, 117'127 );
+   hwlib::string< 64 > s;
+   hwlib::getline( log, s );
+   HWLIB_TEST_EQUAL( s == "hello", true );
+   hwlib::getline( log, s );
+   HWLIB_TEST_EQUAL( s == "abc0123456789abcdefghijklmnopqrstuvwxyz", true );
+   HWLIB_TEST_EQUAL( demux.frames_dropped(), 0u );
+   HWLIB_TEST_EQUAL( log.char_available(), false );
+}
+
+void test_binary(){
+   string_link link;
+   std::string sent;
+   {
+      hwlib::ostream_mux< 300 > out( link, 0, false );
+      uint32_t r = 1;
+      for( int i = 0; i < 5'000; ++i ){
+         r = r * 1664525 + 1013904223;
+         const char c = ( r >> 28 ) < 4 ? '\0' : static_cast< char >( r >> 24 );
+         out << c;
+         sent += c;
+      }
+   }
+   hwlib::stream_demux< 300 > demux( link );
+   hwlib::istream_demux< 6'000 > in( demux, 0 );
+   std::string received;
+   while( in.char_available() ){
+      received += in.get();
+   }
+   HWLIB_TEST_EQUAL( received == sent, true );
+
+   // each frame of 1 + 300 characters ends with the only '\0'
+   HWLIB_TEST_EQUAL( std::count( link.s.begin(), link.s.end(), '\0' ), 17 );
+}
+
+void test_errors(){
+   using namespace std::string_literals;
+   string_link link;
+   link.s = 
+        "junk"s + '\0'                        // not a frame
+      + encoded( "\x05lost"s )                // no istream_demux
+      + "\x05\x01" "ab"s + '\0'               // truncated block
+      + encoded( "\x01" + std::string( 20, 'x' ) )  // too long
+      + encoded( "\x01" "ok"s )
+      + encoded( "\x01" "0123456789"s );      // doesn't fit
+   hwlib::stream_demux< 16 > demux( link );
+   hwlib::istream_demux< 8 > in( demux, 1 );
+   std::string received;
+   while( in.char_available() ){
+      received += in.get();
+   }
+   HWLIB_TEST_EQUAL( received == "ok01234567", true );
+   HWLIB_TEST_EQUAL( demux.frames_dropped(), 4u );
+   HWLIB_TEST_EQUAL( in.characters_lost(), 2u );
+}
+
+int main(){
+   test_cobs();
+   test_channels();
+   test_binary();
+   test_errors();
+   hwlib::test_end();
+}
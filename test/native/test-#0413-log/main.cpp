@@ -0,0 +1,180 @@
+// ==========================================================================
+//
+// hwlib test.
+//
+// (c) Wouter van Ooijen (wouter@voti.nl) 2017
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// test the deferred-formatting hwlib::logger and hwlib::log_decoder,
+// and compare them with hwlib::format()
+
+#include "hwlib.hpp"
+#include "../test-helpers.hpp"
+#include <climits>
+
+std::string decoded( const std::string & wire ){
+   string_ostream text;
+   hwlib::log_decoder decoder( text );
+   decoder.decode( wire.data(), wire.length() );
+   return text.s;
+}
+
+// log a message, and format the same message
+#define LOG_AND_FORMAT( S, ... )                                     \
+   HWLIB_LOG( log, S, ##__VA_ARGS__ );                               \
+   expected << hwlib::format( HWLIB_FORMAT( S ), ##__VA_ARGS__ ) << '\n';
+
+void test_messages(){
+   string_ostream wire, expected;
+   hwlib::logger< 1'024 > log( wire );
+   const char * name = "sensor";
+   hwlib::string< 8 > s( "str" );
+
+   LOG_AND_FORMAT( "started" );
+   LOG_AND_FORMAT( "{} {} {} {}", 0, 1, -1, 12345 );
+   LOG_AND_FORMAT( "{} {}", LLONG_MIN, ULLONG_MAX );
+   LOG_AND_FORMAT( "{} {}", (short) -300, (unsigned char) 200 );
+   LOG_AND_FORMAT( "{:04x} {:>8} {:+d} {:#b}", 0xAB, -12, 7, 5 );
+   LOG_AND_FORMAT( "{} {:3}|{:d}", 'a', 'b', 'c' );
+   LOG_AND_FORMAT( "{} {:>6} {:d}", true, false, true );
+   LOG_AND_FORMAT( "{} [{:>8}] {}", name, "abc", s );
+   LOG_AND_FORMAT( "{} {:.2f} {:.0}", 3.25f, -0.125f, 2.5f );
+   LOG_AND_FORMAT( "{{{}}}", 1 );
+   HWLIB_TEST_EQUAL( log.records_dropped(), 0u );
+
+   // nothing is written before the background work
+   HWLIB_TEST_EQUAL( wire.s.length(), 0u );
+   log.work();
+   HWLIB_TEST_EQUAL( decoded( wire.s ) == "started\n", true );
+   log.flush();
+
+   HWLIB_TEST_EQUAL( decoded( wire.s ) == expected.s, true );
+   HWLIB_TEST_EQUAL( wire.s.length() < expected.s.length(), true );
+}
+
+void test_long_string(){
+   string_ostream wire;
+   hwlib::logger< 1'024 > log( wire );
+   const std::string text( 300, 'x' );
+   HWLIB_LOG( log, "{}:{}", 1, text.c_str() );
+   log.flush();
+   HWLIB_TEST_EQUAL(
+      decoded( wire.s ) == "1:" + std::string( 249, 'x' ) + "\n", true );
+}
+
+void test_dropped(){
+   string_ostream wire;
+   hwlib::logger< 20 > log( wire );
+   for( int i = 0; i < 5; ++i ){
+      HWLIB_LOG( log, "value {}", i );
+   }
+   HWLIB_TEST_EQUAL( log.records_dropped(), 2u );
+   log.flush();
+   HWLIB_TEST_EQUAL(
+      decoded( wire.s ) == "value 0\nvalue 1\nvalue 2\n", true );
+}
+
+void test_errors(){
+   using namespace std::string_literals;
+   char frame[ 20 ];
+   const auto record = "\x78\x56\x34\x12"s;
+   const std::string unknown(
+      frame, hwlib::cobs_encode( record.data(), 4, frame ) );
+   HWLIB_TEST_EQUAL(
+      decoded( unknown ) == "<unknown message 0x12345678>\n", true );
+   HWLIB_TEST_EQUAL( decoded( "\x05" "ab"s + '\0' )
+      == "<invalid frame>\n", true );
+   HWLIB_TEST_EQUAL( decoded( "\x03" "ab"s + '\0' )
+      == "<invalid record>\n", true );
+
+   // two messages with the same id but a different format string,
+   // and two with the same format string (from two log calls),
+   // static because the catalog keeps them
+   static hwlib::log_message 
+      a( 0x0BADC0DE, "a {}", "i" ), b( 0x0BADC0DE, "b {}", "i" ),
+      c( 0x0000C0DE, "c", "" ), d( 0x0000C0DE, "c", "" );
+   const auto ambiguous = "\xDE\xC0\xAD\x0B"s;
+   const auto same = "\xDE\xC0\x00\x00"s;
+   HWLIB_TEST_EQUAL( decoded( std::string( 
+      frame, hwlib::cobs_encode( ambiguous.data(), 4, frame ) ) )
+         == "<ambiguous message 0x0badc0de>\n", true );
+   HWLIB_TEST_EQUAL( decoded( std::string( 
+      frame, hwlib::cobs_encode( same.data(), 4, frame ) ) )
+         == "c\n", true );
+
+   // a record with a missing argument
+   string_ostream wire;
+   hwlib::logger< 64 > log( wire );
+   HWLIB_LOG( log, "a={} b={}", 1, 2 );
+   log.flush();
+   std::string s = wire.s;
+   s.erase( s.length() - 2, 1 );
+   s[ 0 ] = s[ 0 ] - 1;
+   HWLIB_TEST_EQUAL( decoded( s ) == "a=1 b=<truncated>\n", true );
+}
+
+// an ostream that stores its characters in a ring buffer,
+// like the buffered UART that a formatted message would be written to
+class ring_ostream : public hwlib::ostream {
+public:
+   hwlib::ring_buffer< char, 4'096 > buffer;
+   void putc( char c ) override { buffer.push( c ); }
+   void write( const char * p, size_t n ) override { buffer.write( p, n ); }
+   void flush() override {
+      char block[ 256 ];
+      while( buffer.read( block, sizeof( block ) ) > 0 ){}
+   }
+};
+
+// nanoseconds and bytes per message, for a log call and for format(),
+// both storing the message in a ring buffer 
+void benchmark(){
+   constexpr int n = 1'000'000;
+
+   string_ostream wire;
+   hwlib::logger< 4'096 > log( wire );
+   uint64_t logging = 0;
+   for( int j = 0; j < n; j += 100 ){
+      const auto start = hwlib::now_us();
+      for( int i = j; i < j + 100; ++i ){
+         HWLIB_LOG( log, "sample {} of channel {}: {:04x}",
+            i, i & 7, i & 0xFFFF );
+      }
+      logging += hwlib::now_us() - start;
+      wire.s.clear();
+      log.flush();
+   }
+
+   ring_ostream text;
+   uint64_t formatting = 0;
+   for( int j = 0; j < n; j += 100 ){
+      const auto start = hwlib::now_us();
+      for( int i = j; i < j + 100; ++i ){
+         text << hwlib::format( 
+            HWLIB_FORMAT( "sample {} of channel {}: {:04x}\n" ),
+            i, i & 7, i & 0xFFFF );
+      }
+      formatting += hwlib::now_us() - start;
+      text.flush();
+   }
+   
+   printf( "log call : %5.1f ns %2d bytes, format : %5.1f ns %2d bytes\n",
+      1000.0 * logging / n, (int) wire.s.length() / 100,
+      1000.0 * formatting / n, 
+      (int) std::string( "sample 999999 of channel 7: 423f\n" ).length() );
+   HWLIB_TEST_EQUAL( log.records_dropped(), 0u );
+}
+
+int main(){
+   test_messages();
+   test_long_string();
+   test_dropped();
+   test_errors();
+   benchmark();
+   hwlib::test_end();
+}
@@ -0,0 +1,276 @@
+// ==========================================================================
+//
+// hwlib test.
+//
+// (c) Wouter van Ooijen (wouter@voti.nl) 2017
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// test hwlib::bb_uart against stimulus pins: a pin_out that records 
+// the moments of its edges, and a pin_in that replays a waveform
+//
+// The host can preempt the test for longer than a bit time,
+// so each scenario is repeated until it has run undisturbed once.
+
+#include "hwlib.hpp"
+#include <vector>
+#include <string>
+#include <cmath>
+#include <algorithm>
+
+// a pin_out that records its edges (when they are flushed)
+class recording_pin : public hwlib::pin_out {
+public:
+   struct edge { uint64_t t; bool level; };
+   std::vector< edge > edges;
+   bool value = true;
+   bool written = true;
+
+   void write( bool x ) override { written = x; }
+   void flush() override {
+      if( written != value ){
+         value = written;
+         edges.push_back( { hwlib::now_ticks(), value } );
+      }
+   }
+
+   // the level at moment t
+   bool level( uint64_t t ) const {
+      bool result = true;
+      for( const auto & e : edges ){
+         if( e.t > t ){
+            break;
+         }
+         result = e.level;
+      }
+      return result;
+   }
+
+   // the characters, sampled at the bit centres for the given baudrate
+   std::string decode( uint32_t baudrate ) const {
+      const double bit = 1'000.0 * hwlib::ticks_per_us() * 1'000 / baudrate;
+      std::string s;
+      uint64_t after = 0;
+      for( const auto & e : edges ){
+         if( e.level || ( e.t < after ) ){
+            continue;
+         }
+         char c = 0;
+         for( int n = 8; n >= 1; --n ){
+            c = ( c << 1 ) | level( e.t + ( n + 0.5 ) * bit );
+         }
+         s += c;
+         after = e.t + 9.5 * bit;
+      }
+      return s;
+   }
+};
+
+// a pin_in that replays a waveform that starts at a given moment,
+// followed by '\0' characters (so a lost character can't block getc())
+class waveform_pin : public hwlib::pin_in {
+public:
+   std::vector< bool > bits;
+   std::vector< std::pair< double, double > > glitches;
+   uint64_t start = 0;
+   double bit = 0;
+
+   waveform_pin( uint32_t baudrate ):
+      bit( 1'000.0 * hwlib::ticks_per_us() * 1'000 / baudrate )
+   {}
+
+   // append a character frame, with a good or a bad stop bit
+   void frame( char c, bool stop = true ){
+      bits.push_back( 0 );
+      for( int n = 0; n < 8; ++n ){
+         bits.push_back( ( c >> n ) & 1 );
+      }
+      bits.push_back( stop );
+   }
+
+   void idle( int n ){
+      bits.insert( bits.end(), n, 1 );
+   }
+
+   // invert the level from bit position a to b
+   void glitch( double a, double b ){
+      glitches.push_back( { a, b } );
+   }
+
+   // start the waveform a few bits from now
+   void go(){
+      start = hwlib::now_ticks() + 4 * bit;
+   }
+
+   bool read() override {
+      const double t = hwlib::now_ticks();
+      if( t < start ){
+         return true;
+      }
+      const double position = ( t - start ) / bit;
+      const auto n = static_cast< size_t >( position );
+      bool level = ( n < bits.size() ) 
+         ? bits[ n ] : ( ( n - bits.size() ) % 10 ) == 9;
+      for( const auto & g : glitches ){
+         if( ( position >= g.first ) && ( position < g.second ) ){
+            level = ! level;
+         }
+      }
+      return level;
+   }
+};
+
+// run a scenario until it succeeds, at most 20 times
+template< typename F >
+bool undisturbed( F scenario ){
+   for( int i = 0; i < 20; ++i ){
+      if( scenario() ){
+         return true;
+      }
+   }
+   return false;
+}
+
+std::string receive( hwlib::bb_uart & uart, size_t n ){
+   std::string s;
+   while( s.length() < n ){
+      s += uart.getc();
+   }
+   return s;
+}
+
+const double bit_115200 = 1'000.0 * hwlib::ticks_per_us() * 1'000 / 115'200;
+
+void test_transmit(){
+   const std::string text = "The quick brown fox jumps over the lazy dog";
+   double error = 0;
+   HWLIB_TEST_EQUAL( undisturbed( [ & ]{
+      recording_pin tx;
+      waveform_pin rx( 115'200 );
+      hwlib::bb_uart uart( tx, rx, 115'200 );
+      uart << text.c_str() << hwlib::flush;
+
+      // the error doesn't accumulate: each edge, 
+      // up to the last one, is close to a bit boundary
+      const auto start = tx.edges.front().t;
+      error = 0;
+      for( const auto & e : tx.edges ){
+         const double bits = ( e.t - start ) / bit_115200;
+         error = std::max( error, 
+            std::fabs( bits - std::round( bits ) ) * bit_115200 );
+      }
+      const double last = 
+         ( tx.edges.back().t - start ) / bit_115200;
+      return ( tx.decode( 115'200 ) == text ) 
+         && ( std::round( last ) == 10.0 * text.length() - 1 )
+         && ( error < bit_115200 / 4 );
+   }), true );
+   printf( "transmit : %d characters at 115200, max edge error %.0f ns\n",
+      (int) text.length(), error );
+}
+
+void test_set_baudrate(){
+   HWLIB_TEST_EQUAL( undisturbed( [ & ]{
+      recording_pin tx;
+      waveform_pin rx( 115'200 );
+      hwlib::bb_uart uart( tx, rx, 115'200 );
+      uart.set_baudrate( 9'600 );
+      uart << "U" << hwlib::flush;
+      const double span = tx.edges.back().t - tx.edges.front().t;
+      const double bit = 1'000.0 * hwlib::ticks_per_us() * 1'000 / 9'600;
+      return ( uart.baudrate() == 9'600 ) 
+         && ( tx.decode( 9'600 ) == "U" ) 
+         && ( span > 8.9 * bit ) && ( span < 9.1 * bit );
+   }), true );
+}
+
+void test_receive(){
+   const std::string text = "Hello, world!";
+   for( const auto baudrate : { 115'200, 115'200 * 97 / 100, 
+      115'200 * 103 / 100 } 
+   ){
+      HWLIB_TEST_EQUAL( undisturbed( [ & ]{
+         recording_pin tx;
+         waveform_pin rx( baudrate );
+         for( auto c : text ){
+            rx.frame( c );
+         }
+         hwlib::bb_uart uart( tx, rx, 115'200 );
+         rx.go();
+         return ( receive( uart, text.length() ) == text )
+            && ( uart.framing_errors() == 0 );
+      }), true );
+   }
+}
+
+void test_glitches(){
+   HWLIB_TEST_EQUAL( undisturbed( [ & ]{
+      recording_pin tx;
+      waveform_pin rx( 9'600 );
+      hwlib::bb_uart uart( tx, rx, 9'600 );
+
+      // a short low pulse on the idle line is not a start bit
+      rx.idle( 2 );
+      rx.glitch( 0.5, 0.75 );
+
+      // a glitch at the centre of each bit is voted out
+      rx.frame( 'A' );
+      rx.frame( 0x55 );
+      for( int n = 2; n < 22; ++n ){
+         rx.glitch( n + 0.47, n + 0.53 );
+      }
+      rx.go();
+      return ( receive( uart, 2 ) == "A\x55" ) 
+         && ( uart.framing_errors() == 0 );
+   }), true );
+}
+
+void test_framing(){
+   HWLIB_TEST_EQUAL( undisturbed( [ & ]{
+      recording_pin tx;
+      waveform_pin rx( 9'600 );
+      hwlib::bb_uart uart( tx, rx, 9'600 );
+
+      // a frame with a low stop bit is dropped, 
+      // as is a break, the next frame is received
+      rx.frame( 'x', false );
+      rx.idle( 1 );
+      rx.bits.insert( rx.bits.end(), 12, 0 );
+      rx.idle( 2 );
+      rx.frame( 'y' );
+      rx.go();
+      const bool idle = ! uart.char_available();
+      return idle && ( uart.getc() == 'y' ) 
+         && ( uart.framing_errors() == 2 );
+   }), true );
+}
+
+void test_free_functions(){
+   HWLIB_TEST_EQUAL( undisturbed( [ & ]{
+      recording_pin tx;
+      hwlib::uart_putc_bit_banged_pin( 'k', tx );
+      return tx.decode( HWLIB_BAUDRATE ) == "k";
+   }), true );
+   HWLIB_TEST_EQUAL( undisturbed( [ & ]{
+      waveform_pin rx( HWLIB_BAUDRATE );
+      rx.frame( 'm', false );
+      rx.idle( 1 );
+      rx.frame( 'n' );
+      rx.go();
+      return hwlib::uart_getc_bit_banged_pin( rx ) == 'n';
+   }), true );
+}
+
+int main(){
+   test_transmit();
+   test_set_baudrate();
+   test_receive();
+   test_glitches();
+   test_framing();
+   test_free_functions();
+   hwlib::test_end();
+}
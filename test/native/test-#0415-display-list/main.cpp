@@ -0,0 +1,159 @@
+// ==========================================================================
+//
+// hwlib test.
+//
+// (c) Wouter van Ooijen (wouter@voti.nl) 2017
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// test the incremental redraw of hwlib::display_list
+
+#include "hwlib.hpp"
+#include "../test-helpers.hpp"
+
+// window that also remembers which pixels were written
+class window_touched : public window_store< 64, 32 > {
+public:
+
+   bool touched[ 64 ][ 32 ];
+
+   window_touched(){
+      clear();
+      untouch();
+   }
+
+   void untouch(){
+      for( auto p : all( size ) ){
+         touched[ p.x ][ p.y ] = false;
+      }
+   }
+
+   void write_implementation( hwlib::xy pos, hwlib::color col ) override {
+      window_store::write_implementation( pos, col );
+      touched[ pos.x ][ pos.y ] = true;
+   }
+
+   void write_span_implementation(
+      hwlib::xy pos, int_fast16_t n, hwlib::color col
+   ) override {
+      window_store::write_span_implementation( pos, n, col );
+      for( int_fast16_t i = 0; i < n; ++i ){
+         touched[ pos.x + i ][ pos.y ] = true;
+      }
+   }
+
+   // whether all written pixels are inside the area
+   bool touched_only( const hwlib::box & area ) const {
+      for( auto p : all( size ) ){
+         if( touched[ p.x ][ p.y ] && ! area.contains( p ) ){
+            return false;
+         }
+      }
+      return true;
+   }
+
+   int touched_count() const {
+      int n = 0;
+      for( auto p : all( size ) ){
+         n += touched[ p.x ][ p.y ];
+      }
+      return n;
+   }
+};
+
+// whether the window shows the same as drawing the whole list
+bool shows( const window_touched & w, hwlib::display_list_base & list ){
+   window_touched reference;
+   list.draw( reference );
+   for( auto p : all( w.size ) ){
+      if( w.pixels[ p.x ][ p.y ] != reference.pixels[ p.x ][ p.y ] ){
+         return false;
+      }
+   }
+   return true;
+}
+
+void test_display_list(){
+   window_touched w;
+   hwlib::display_list< 4 > list( w );
+   hwlib::rectangle r( hwlib::xy( 2, 2 ), hwlib::xy( 12, 10 ) );
+   hwlib::circle c( hwlib::xy( 30, 16 ), 5 );
+   hwlib::line l( hwlib::xy( 8, 4 ), hwlib::xy( 60, 28 ) );
+   list.add( r );
+   list.add( c );
+   list.add( l );
+   HWLIB_TEST_EQUAL( list.length(), 3u );
+
+   // the first flush draws everything, but only where the objects are
+   list.flush();
+   HWLIB_TEST_EQUAL( shows( w, list ), true );
+   HWLIB_TEST_EQUAL( w.touched_only( 
+      r.bounding_box() | c.bounding_box() | l.bounding_box() ), true );
+
+   // nothing has changed, so nothing is written
+   w.untouch();
+   list.flush();
+   HWLIB_TEST_EQUAL( w.touched_count(), 0 );
+
+   // a moved object: only its old and its new area are redrawn,
+   // including the part of the line that crosses them
+   w.untouch();
+   auto old_box = c.bounding_box();
+   c.move_to( hwlib::xy( 52, 24 ) );
+   list.flush();
+   HWLIB_TEST_EQUAL( shows( w, list ), true );
+   HWLIB_TEST_EQUAL( w.touched_count(), 
+      2 * old_box.size().x * old_box.size().y );
+
+   // when the old and the new area overlap, 
+   // the box that covers both is redrawn
+   w.untouch();
+   old_box = c.bounding_box();
+   c.move_to( hwlib::xy( 46, 20 ) );
+   list.flush();
+   const auto both = old_box | c.bounding_box();
+   HWLIB_TEST_EQUAL( shows( w, list ), true );
+   HWLIB_TEST_EQUAL( w.touched_only( both ), true );
+   HWLIB_TEST_EQUAL( w.touched_count(), both.size().x * both.size().y );
+
+   // a changed (dirty) object: only its area is redrawn
+   w.untouch();
+   r.ink = hwlib::red;
+   r.changed();
+   list.flush();
+   HWLIB_TEST_EQUAL( shows( w, list ), true );
+   HWLIB_TEST_EQUAL( w.touched_only( r.bounding_box() ), true );
+   HWLIB_TEST_EQUAL( w.pixels[ 2 ][ 2 ] == hwlib::red, true );
+
+   // a moved rectangle keeps its size,
+   // and only its old and its new area are redrawn
+   w.untouch();
+   old_box = r.bounding_box();
+   r.move_to( hwlib::xy( 4, 18 ) );
+   list.flush();
+   HWLIB_TEST_EQUAL( r.bounding_box().start == hwlib::xy( 4, 18 ), true );
+   HWLIB_TEST_EQUAL( r.bounding_box().size() == old_box.size(), true );
+   HWLIB_TEST_EQUAL( shows( w, list ), true );
+   HWLIB_TEST_EQUAL( w.touched_count(), 
+      2 * old_box.size().x * old_box.size().y );
+   HWLIB_TEST_EQUAL( w.pixels[ 4 ][ 18 ] == hwlib::red, true );
+
+   // a removed object: its area is erased
+   w.untouch();
+   const auto removed = r.bounding_box();
+   list.remove( r );
+   HWLIB_TEST_EQUAL( list.length(), 2u );
+   list.flush();
+   HWLIB_TEST_EQUAL( shows( w, list ), true );
+   HWLIB_TEST_EQUAL( w.touched_only( removed ), true );
+   HWLIB_TEST_EQUAL( w.pixels[ 4 ][ 18 ] == w.background, true );
+}
+
+int main(){
+   test_display_list();
+   hwlib::test_end();
+}
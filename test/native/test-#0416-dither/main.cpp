@@ -0,0 +1,130 @@
+// ==========================================================================
+//
+// hwlib test.
+//
+// (c) Wouter van Ooijen (wouter@voti.nl) 2017
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// test the ordered and the error diffusion dithering windows,
+// by dithering a gray gradient to the headless window
+
+#include "hwlib.hpp"
+#include <cmath>
+
+constexpr auto size = hwlib::xy( 64, 16 );
+
+// the gray level ( 0 .. 255 ) of column x of the gradient
+int level( int x ){
+   return ( x * 255 ) / ( size.x - 1 );
+}
+
+// write the gradient, row after row, from left to right
+void gradient( hwlib::window & w ){
+   for( auto p : hwlib::all( size ) ){
+      const auto v = static_cast< uint8_t >( level( p.x ) );
+      w.write( p, hwlib::color( v, v, v ) );
+   }
+}
+
+// whether all pixels are black or white
+bool monochrome( const hwlib::target::window & w ){
+   for( auto p : hwlib::all( size ) ){
+      const auto c = w.read( p );
+      if( ( c != hwlib::black ) && ( c != hwlib::white ) ){
+         return false;
+      }
+   }
+   return true;
+}
+
+// the largest difference between the average brightness ( 0 .. 1 ) 
+// of a band of columns and the average level of the gradient in it
+double band_error( const hwlib::target::window & w, int width ){
+   double result = 0;
+   for( int x0 = 0; x0 < size.x; x0 += width ){
+      double shown = 0, wanted = 0;
+      for( int x = x0; x < x0 + width; ++x ){
+         wanted += size.y * level( x ) / 255.0;
+         for( int y = 0; y < size.y; ++y ){
+            shown += w.read( hwlib::xy( x, y ) ).red / 255.0;
+         }
+      }
+      result = std::max( 
+         result, std::fabs( shown - wanted ) / ( width * size.y ) );
+   }
+   return result;
+}
+
+void test_ordered(){
+   hwlib::target::window w( size );
+   auto d = hwlib::dither_ordered( w );
+   gradient( d );
+   HWLIB_TEST_EQUAL( monochrome( w ), true );
+
+   // each band of 4 columns shows its gray level within 1/16
+   HWLIB_TEST_EQUAL( band_error( w, 4 ) < 1.0 / 16, true );
+   HWLIB_TEST_EQUAL( w.read( hwlib::xy( 0, 0 ) ) == hwlib::black, true );
+   HWLIB_TEST_EQUAL( 
+      w.read( hwlib::xy( size.x - 1, 0 ) ) == hwlib::white, true );
+
+   // the result doesn't depend on the order of the writes
+   hwlib::target::window backwards( size );
+   auto b = hwlib::dither_ordered( backwards );
+   for( int y = size.y - 1; y >= 0; --y ){
+      for( int x = size.x - 1; x >= 0; --x ){
+         const auto v = static_cast< uint8_t >( level( x ) );
+         b.write( hwlib::xy( x, y ), hwlib::color( v, v, v ) );
+      }
+   }
+   bool equal = true;
+   for( auto p : hwlib::all( size ) ){
+      equal = equal && ( w.read( p ) == backwards.read( p ) );
+   }
+   HWLIB_TEST_EQUAL( equal, true );
+
+   // with 2 bits per channel, only 4 levels are written,
+   // and the smaller steps give a smaller error
+   hwlib::target::window color( size );
+   auto c = hwlib::dither_ordered( color, 2 );
+   gradient( c );
+   bool levels = true;
+   for( auto p : hwlib::all( size ) ){
+      levels = levels && ( ( color.read( p ).green % 85 ) == 0 );
+   }
+   HWLIB_TEST_EQUAL( levels, true );
+   HWLIB_TEST_EQUAL( band_error( color, 4 ) < 1.0 / 24, true );
+}
+
+void test_diffusion(){
+   hwlib::target::window w( size );
+   hwlib::window_dither_diffusion< size.x > d( w );
+   gradient( d );
+   HWLIB_TEST_EQUAL( monochrome( w ), true );
+
+   // the error is spread, so a band shows its gray level
+   HWLIB_TEST_EQUAL( band_error( w, 8 ) < 1.0 / 16, true );
+   HWLIB_TEST_EQUAL( w.read( hwlib::xy( 0, 0 ) ) == hwlib::black, true );
+   HWLIB_TEST_EQUAL( 
+      w.read( hwlib::xy( size.x - 1, size.y - 1 ) ) == hwlib::white, true );
+
+   // a (non-gradient) mid-gray area is half white
+   hwlib::target::window gray( size );
+   hwlib::window_dither_diffusion< size.x > g( gray );
+   g.clear( hwlib::color( 128, 128, 128 ) );
+   int white = 0;
+   for( auto p : hwlib::all( size ) ){
+      white += ( gray.read( p ) == hwlib::white );
+   }
+   HWLIB_TEST_EQUAL( std::abs( white - size.x * size.y / 2 ) < 16, true );
+}
+
+int main(){
+   test_ordered();
+   test_diffusion();
+   hwlib::test_end();
+}
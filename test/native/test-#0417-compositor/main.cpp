@@ -0,0 +1,171 @@
+// ==========================================================================
+//
+// hwlib test.
+//
+// (c) Wouter van Ooijen (wouter@voti.nl) 2017
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// test the layer order, the transparency and the damage tracking
+// of hwlib::compositor, on the headless window
+
+#include "hwlib.hpp"
+#include <initializer_list>
+
+constexpr auto output_size = hwlib::xy( 64, 32 );
+
+// window that writes to the headless window,
+// and remembers which pixels were written
+class window_touched : public hwlib::window {
+public:
+
+   hwlib::target::window & w;
+   bool touched[ output_size.x ][ output_size.y ];
+
+   window_touched( hwlib::target::window & w ): 
+      window( w.size, w.foreground, w.background ), 
+      w( w )
+   {
+      untouch();
+   }
+
+   void untouch(){
+      for( auto p : all( size ) ){
+         touched[ p.x ][ p.y ] = false;
+      }
+   }
+
+   void write_implementation( hwlib::xy pos, hwlib::color col ) override {
+      w.write( pos, col );
+      touched[ pos.x ][ pos.y ] = true;
+   }
+
+   void flush() override {
+      w.flush();
+   }
+
+   // whether all written pixels are inside the area
+   bool touched_only( const hwlib::box & area ) const {
+      for( auto p : all( size ) ){
+         if( touched[ p.x ][ p.y ] && ! area.contains( p ) ){
+            return false;
+         }
+      }
+      return true;
+   }
+
+   int touched_count() const {
+      int n = 0;
+      for( auto p : all( size ) ){
+         n += touched[ p.x ][ p.y ];
+      }
+      return n;
+   }
+};
+
+// whether the window shows the layers, bottom one first
+bool shows( 
+   const hwlib::target::window & w, 
+   std::initializer_list< hwlib::layer_base * > layers 
+){
+   for( auto p : hwlib::all( output_size ) ){
+      auto expected = w.background;
+      for( auto l : layers ){
+         const auto pos = p - l->offset();
+         if( l->is_visible() 
+            && ( pos.x >= 0 ) && ( pos.x < l->size.x )
+            && ( pos.y >= 0 ) && ( pos.y < l->size.y )
+            && ! l->read( pos ).is_transparent() 
+         ){
+            expected = l->read( pos );
+         }
+      }
+      if( w.read( p ) != expected ){
+         return false;
+      }
+   }
+   return true;
+}
+
+void test_compositor(){
+   hwlib::target::window headless( output_size );
+   window_touched w( headless );
+   hwlib::compositor< 4 > c( w );
+
+   // an opaque bottom layer, and a top layer that is transparent 
+   // except for the outline of a rectangle
+   hwlib::layer< 32, 16 > bottom;
+   bottom.clear( hwlib::red );
+   hwlib::layer< 16, 8 > top( hwlib::xy( 8, 4 ) );
+   hwlib::rectangle( hwlib::xy( 0, 0 ), hwlib::xy( 15, 7 ), hwlib::green )
+      .draw( top );
+   c.add( bottom );
+   c.add( top );
+   HWLIB_TEST_EQUAL( c.length(), 2u );
+   c.flush();
+   HWLIB_TEST_EQUAL( shows( headless, { & bottom, & top } ), true );
+   HWLIB_TEST_EQUAL( headless.read( hwlib::xy( 8, 4 ) ) == hwlib::green, true );
+   HWLIB_TEST_EQUAL( headless.read( hwlib::xy( 10, 6 ) ) == hwlib::red, true );
+   HWLIB_TEST_EQUAL( 
+      headless.read( hwlib::xy( 40, 20 ) ) == headless.background, true );
+
+   // nothing has changed, so nothing is written
+   w.untouch();
+   c.flush();
+   HWLIB_TEST_EQUAL( w.touched_count(), 0 );
+
+   // a pixel written in a layer updates only its tile
+   w.untouch();
+   top.write( hwlib::xy( 1, 1 ), hwlib::blue );
+   c.flush();
+   HWLIB_TEST_EQUAL( shows( headless, { & bottom, & top } ), true );
+   HWLIB_TEST_EQUAL( w.touched_only( 
+      hwlib::box( hwlib::xy( 8, 0 ), hwlib::xy( 16, 8 ) ) ), true );
+   HWLIB_TEST_EQUAL( w.touched_count(), 8 * 8 );
+
+   // a moved layer updates the tiles of its old and its new area
+   w.untouch();
+   top.move_to( hwlib::xy( 40, 20 ) );
+   c.flush();
+   HWLIB_TEST_EQUAL( shows( headless, { & bottom, & top } ), true );
+   HWLIB_TEST_EQUAL( headless.read( hwlib::xy( 8, 4 ) ) == hwlib::red, true );
+   HWLIB_TEST_EQUAL( 
+      headless.read( hwlib::xy( 40, 20 ) ) == hwlib::green, true );
+   HWLIB_TEST_EQUAL( w.touched_count(), 16 * 16 + 16 * 16 );
+
+   // a hidden layer is not shown, what is underneath is shown
+   w.untouch();
+   top.show( false );
+   c.flush();
+   HWLIB_TEST_EQUAL( shows( headless, { & bottom, & top } ), true );
+   HWLIB_TEST_EQUAL( 
+      headless.read( hwlib::xy( 40, 20 ) ) == headless.background, true );
+   HWLIB_TEST_EQUAL( w.touched_only( 
+      hwlib::box( hwlib::xy( 40, 16 ), hwlib::xy( 56, 32 ) ) ), true );
+
+   // the layer order is the order in which they were added
+   top.show();
+   top.move_to( hwlib::xy( 0, 0 ) );
+   c.remove( bottom );
+   c.add( bottom );
+   c.flush();
+   HWLIB_TEST_EQUAL( shows( headless, { & top, & bottom } ), true );
+   HWLIB_TEST_EQUAL( headless.read( hwlib::xy( 0, 0 ) ) == hwlib::red, true );
+
+   // a removed layer is no longer shown
+   c.remove( bottom );
+   c.flush();
+   HWLIB_TEST_EQUAL( c.length(), 1u );
+   HWLIB_TEST_EQUAL( shows( headless, { & top } ), true );
+   HWLIB_TEST_EQUAL( 
+      headless.read( hwlib::xy( 0, 0 ) ) == hwlib::green, true );
+}
+
+int main(){
+   test_compositor();
+   hwlib::test_end();
+}
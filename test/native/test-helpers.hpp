@@ -0,0 +1,72 @@
+// ==========================================================================
+//
+// hwlib test helpers
+//
+// (c) Wouter van Ooijen (wouter@voti.nl) 2017
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// the stub ostreams and windows that are shared by the native tests,
+// included (once) by their main.cpp after hwlib.hpp
+
+#include <string>
+
+// an ostream that collects its output in a std::string
+class string_ostream : public hwlib::ostream {
+public:
+   std::string s;
+   void putc( char c ) override { s += c; }
+   void write( const char * p, size_t n ) override { s.append( p, n ); }
+   void flush() override {}
+};
+
+// an ostream that only adds up its characters, so the formatting
+// dominates in a benchmark, but can't be optimized away
+class null_ostream : public hwlib::ostream {
+public:
+   unsigned int n = 0;
+   void putc( char c ) override { n += c; }
+   void write( const char * p, size_t k ) override {
+      for( size_t i = 0; i < k; ++i ){
+         n += p[ i ];
+      }
+   }
+   void flush() override {}
+};
+
+// window that remembers its pixels (initially blue)
+// and counts the pixel writes and the span writes
+template< int_fast16_t size_x, int_fast16_t size_y >
+class window_store : public hwlib::window {
+public:
+
+   hwlib::color pixels[ size_x ][ size_y ];
+   int write_count = 0;
+   int span_count = 0;
+
+   window_store(): window( hwlib::xy( size_x, size_y ) ){
+      for( auto p : all( size ) ){
+         pixels[ p.x ][ p.y ] = hwlib::blue;
+      }
+   }
+
+   void write_implementation( hwlib::xy pos, hwlib::color col ) override {
+      ++write_count;
+      pixels[ pos.x ][ pos.y ] = col;
+   }
+
+   void write_span_implementation(
+      hwlib::xy pos, int_fast16_t n, hwlib::color col
+   ) override {
+      ++span_count;
+      for( int_fast16_t i = 0; i < n; ++i ){
+         pixels[ pos.x + i ][ pos.y ] = col;
+      }
+   }
+
+   void flush() override {}
+};
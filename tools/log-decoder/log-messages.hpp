@@ -0,0 +1,32 @@
+// ==========================================================================
+//
+// hwlib log decoder example: the log calls of an application
+//
+// (c) Wouter van Ooijen (wouter@voti.nl) 2017
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// The application (on the target) calls these functions to log,
+// and the decoder (on the host) includes this file, 
+// so its catalog contains the same messages.
+// Replace them by the log calls of your application.
+
+inline void log_started( hwlib::logger_base & log ){
+   HWLIB_LOG( log, "started" );
+}
+
+inline void log_reading( 
+   hwlib::logger_base & log, 
+   int channel, 
+   int value 
+){
+   HWLIB_LOG( log, "channel {} : {:5} ({:#06x})", channel, value, value );
+}
+
+inline void log_error( hwlib::logger_base & log, const char * what ){
+   HWLIB_LOG( log, "error: {}", what );
+}
@@ -0,0 +1,43 @@
+// ==========================================================================
+//
+// hwlib log decoder
+//
+// (c) Wouter van Ooijen (wouter@voti.nl) 2017
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// ==========================================================================
+
+// Host program that decodes the output of a hwlib::logger: 
+// it reads the COBS frames from a file (or from stdin), 
+// and prints the messages to stdout.
+//
+// The messages are found in the catalog, which contains the log calls
+// that are compiled into this program: those of log-messages.hpp.
+
+#include "hwlib.hpp"
+#include "log-messages.hpp"
+#include <cstdio>
+
+int main( int argc, char * argv[] ){
+   if( argc > 2 ){
+      std::fprintf( stderr, "usage: %s [file]\n", argv[ 0 ] );
+      return 1;
+   }
+   std::FILE * in = stdin;
+   if( argc == 2 ){
+      in = std::fopen( argv[ 1 ], "rb" );
+      if( in == nullptr ){
+         std::fprintf( stderr, "can't open %s\n", argv[ 1 ] );
+         return 1;
+      }
+   }
+   
+   hwlib::log_decoder decoder( hwlib::cout );
+   for( int c = std::fgetc( in ); c != EOF; c = std::fgetc( in ) ){
+      decoder.decode( static_cast< char >( c ) );
+   }
+   hwlib::cout << hwlib::flush;
+}